@@ -0,0 +1,745 @@
+/**
+ * @file
+ *
+ * @brief Benchmark harness running a matrix of KeySet sizes, shapes, storage plugins and operations
+ *
+ * Every cell of the matrix is measured several times, the median and the 99th percentile are reported
+ * as CSV or JSON. Results written as CSV can be used as baseline for later runs, cells slower than the
+ * baseline by more than the threshold are reported as regressions.
+ *
+ * If Elektra was built with ENABLE_ALLOC_ACCOUNTING, the number of allocations, the allocations per subsystem
+ * and the peak of allocated bytes are reported, too (see elektraAllocStatsGet()).
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#define _GNU_SOURCE
+
+#include <benchmarks.h>
+#include <kdbmodule.h>
+#include <kdbplugin.h>
+#include <tests.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#define HARNESS_MAX_ENTRIES 16
+#define HARNESS_MAX_RUNS 1000
+#define HARNESS_LINE_LENGTH 1024
+#define HARNESS_DEFAULT_THRESHOLD 10.0
+// slowdowns smaller than this are considered noise, mostly relevant for cells taking only a few microseconds
+#define HARNESS_NOISE_MICROSECONDS 1.0
+
+#define HARNESS_CSV_HEADER "size;shape;plugin;operation;runs;median_us;p99_us;allocations"
+#define HARNESS_CSV_FMT "%zu;%s;%s;%s;%zu;%.3f;%.3f;%zd"
+
+// set if Elektra counts the allocations per subsystem
+static bool tagAccounting = false;
+
+typedef enum
+{
+	OPERATION_GET,
+	OPERATION_SET,
+	OPERATION_LOOKUP,
+	OPERATION_ITERATE,
+	OPERATION_CUT,
+	OPERATION_MERGE,
+	OPERATION_COUNT
+} Operation;
+
+static const char * const operationNames[OPERATION_COUNT] = { "get", "set", "lookup", "iterate", "cut", "merge" };
+
+/**
+ * The matrix to run, every dimension is a list of names
+ */
+typedef struct
+{
+	size_t sizes[HARNESS_MAX_ENTRIES];
+	size_t sizeCount;
+	const char * shapes[HARNESS_MAX_ENTRIES];
+	size_t shapeCount;
+	const char * plugins[HARNESS_MAX_ENTRIES];
+	size_t pluginCount;
+	Operation operations[OPERATION_COUNT];
+	size_t operationCount;
+	size_t runs;
+	int32_t seed;
+} Matrix;
+
+typedef struct
+{
+	size_t size;
+	const char * shape;
+	const char * plugin;
+	Operation operation;
+	size_t runs;
+	double median;
+	double p99;
+	ssize_t allocations;
+	ssize_t tagAllocations[ELEKTRA_ALLOC_TOTAL]; ///< allocations per subsystem, -1 without accounting
+	ssize_t peakBytes;
+} Result;
+
+typedef enum
+{
+	FORMAT_CSV,
+	FORMAT_JSON
+} Format;
+
+/**
+ * Shapes
+ *
+ * `default` is the default KeySetShape of the generator, `flat` puts all keys directly below the root
+ * and `deep` builds a binary tree with long names.
+ */
+static void shapefFlat (const size_t initSize ELEKTRA_UNUSED, size_t size ELEKTRA_UNUSED, size_t level ELEKTRA_UNUSED,
+			int32_t * seed ELEKTRA_UNUSED, KsShapeFunctionReturn * ret, void * data ELEKTRA_UNUSED)
+{
+	ret->subKeys = 0;
+	ret->label = 0;
+}
+
+static void shapefDeep (const size_t initSize ELEKTRA_UNUSED, size_t size ELEKTRA_UNUSED, size_t level, int32_t * seed ELEKTRA_UNUSED,
+			KsShapeFunctionReturn * ret, void * data ELEKTRA_UNUSED)
+{
+	ret->subKeys = level < 12 ? 2 : 0;
+	ret->label = 0;
+}
+
+static int getShape (const char * name, KeySetShape * shape, KeySetShape ** out)
+{
+	if (!strcmp (name, "default"))
+	{
+		*out = NULL;
+		return 0;
+	}
+	shape->parent = 0;
+	shape->special = 0;
+	shape->shapeInit = NULL;
+	shape->shapeDel = NULL;
+	if (!strcmp (name, "flat"))
+	{
+		shape->minWordLength = 8;
+		shape->maxWordLength = 16;
+		shape->shapef = shapefFlat;
+	}
+	else if (!strcmp (name, "deep"))
+	{
+		shape->minWordLength = 2;
+		shape->maxWordLength = 4;
+		shape->parent = 4;
+		shape->shapef = shapefDeep;
+	}
+	else
+	{
+		return -1;
+	}
+	*out = shape;
+	return 0;
+}
+
+/**
+ * @brief Generates the KeySet for a cell below KEY_ROOT
+ *
+ * The generator creates cascading keys, so they are moved below KEY_ROOT to be writable by storage plugins.
+ */
+static KeySet * generateCell (size_t size, int32_t seed, const char * shapeName)
+{
+	KeySetShape shapeData;
+	KeySetShape * shape;
+	if (getShape (shapeName, &shapeData, &shape) < 0)
+	{
+		printExit ("unknown shape");
+	}
+
+	KeySet * generated = generateKeySet (size, &seed, shape);
+	KeySet * ks = ksNew (ksGetSize (generated), KS_END);
+	char value[BUF_SIZ];
+	for (elektraCursor it = 0; it < ksGetSize (generated); ++it)
+	{
+		Key * key = keyNew (KEY_ROOT, KEY_END);
+		if (keyAddName (key, keyName (ksAtCursor (generated, it))) < 0)
+		{
+			printExit ("generateCell: can not add name");
+		}
+		snprintf (value, sizeof (value), "value%zd", (ssize_t) it);
+		keySetString (key, value);
+		ksAppendKey (ks, key);
+	}
+	ksDel (generated);
+	return ks;
+}
+
+/**
+ * @brief Builds the key to cut, which is the first level below KEY_ROOT of the middle key
+ */
+static Key * getCutPoint (KeySet * ks)
+{
+	Key * cutPoint = keyNew (KEY_ROOT, KEY_END);
+	if (ksGetSize (ks) == 0) return cutPoint;
+
+	Key * middle = ksAtCursor (ks, ksGetSize (ks) / 2);
+	// skip the namespace and the part of KEY_ROOT
+	const char * part = (const char *) keyUnescapedName (middle) + 2;
+	part += strlen (part) + 1;
+	if (part < (const char *) keyUnescapedName (middle) + keyGetUnescapedNameSize (middle))
+	{
+		keyAddBaseName (cutPoint, part);
+	}
+	return cutPoint;
+}
+
+static Plugin * openPlugin (const char * name, KeySet * modules)
+{
+	KeySet * conf = ksNew (0, KS_END);
+	Key * errorKey = keyNew ("/", KEY_END);
+	Plugin * plugin = elektraPluginOpen (name, modules, conf, errorKey);
+	if (keyGetMeta (errorKey, "error"))
+	{
+		fprintf (stderr, "There are errors for plugin: %s\n", name);
+	}
+	keyDel (errorKey);
+	return plugin;
+}
+
+static uint64_t nowNanoseconds (void)
+{
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+}
+
+static int compareUint64 (const void * a, const void * b)
+{
+	uint64_t x = *(const uint64_t *) a;
+	uint64_t y = *(const uint64_t *) b;
+	return (x > y) - (x < y);
+}
+
+static int compareSize (const void * a, const void * b)
+{
+	size_t x = *(const size_t *) a;
+	size_t y = *(const size_t *) b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * @brief Runs a single operation once
+ *
+ * Preparation and cleanup are not measured, only the operation itself.
+ *
+ * @retval 0 on success
+ * @retval -1 if the plugin failed
+ */
+static int runOnce (Operation operation, Plugin * plugin, KeySet * generated, KeySet * ks, Key * parentKey, uint64_t * time,
+		    size_t * allocated, ElektraAllocStats * tagged)
+{
+	KeySet * work = NULL;
+	KeySet * other = NULL;
+	Key * cutPoint = NULL;
+	KeySet * lookups = NULL;
+	int ret = 0;
+
+	// prepare
+	switch (operation)
+	{
+	case OPERATION_GET:
+		work = ksNew (0, KS_END);
+		break;
+	case OPERATION_CUT:
+		work = ksDup (ks);
+		cutPoint = getCutPoint (ks);
+		break;
+	case OPERATION_MERGE:
+		// every second key is already there, so the merge replaces half of the keys and inserts the other half
+		work = ksNew (ksGetSize (ks), KS_END);
+		for (elektraCursor it = 0; it < ksGetSize (ks); it += 2)
+		{
+			ksAppendKey (work, keyDup (ksAtCursor (ks, it), KEY_CP_ALL));
+		}
+		break;
+	case OPERATION_LOOKUP:
+		lookups = ksDeepDup (ks);
+		break;
+	default:
+		break;
+	}
+
+	ElektraAllocStats allocatedBefore;
+	elektraAllocStatsReset ();
+	elektraAllocStatsGet (ELEKTRA_ALLOC_TOTAL, &allocatedBefore);
+	uint64_t start = nowNanoseconds ();
+	switch (operation)
+	{
+	case OPERATION_GET:
+		ret = plugin->kdbGet (plugin, work, parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR ? -1 : 0;
+		break;
+	case OPERATION_SET:
+		ret = plugin->kdbSet (plugin, generated, parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR ? -1 : 0;
+		break;
+	case OPERATION_LOOKUP:
+		for (elektraCursor it = 0; it < ksGetSize (lookups); ++it)
+		{
+			if (!ksLookup (ks, ksAtCursor (lookups, it), 0)) ret = -1;
+		}
+		break;
+	case OPERATION_ITERATE:
+		for (elektraCursor it = 0; it < ksGetSize (ks); ++it)
+		{
+			const char * value = keyString (ksAtCursor (ks, it));
+			__asm__("" : : "r"(value));
+		}
+		break;
+	case OPERATION_CUT:
+		other = ksCut (work, cutPoint);
+		break;
+	case OPERATION_MERGE:
+		ksAppend (work, ks);
+		break;
+	default:
+		break;
+	}
+	*time = nowNanoseconds () - start;
+	for (ElektraAllocTag tag = ELEKTRA_ALLOC_OTHER; tag <= ELEKTRA_ALLOC_TOTAL; ++tag)
+	{
+		elektraAllocStatsGet (tag, &tagged[tag]);
+	}
+	// only the memory allocated by the operation itself counts for the peak
+	tagged[ELEKTRA_ALLOC_TOTAL].peak -= allocatedBefore.current;
+	*allocated = tagged[ELEKTRA_ALLOC_TOTAL].allocations;
+
+	ksDel (work);
+	ksDel (other);
+	ksDel (lookups);
+	keyDel (cutPoint);
+	return ret;
+}
+
+static int runCell (const Matrix * matrix, Result * result, Plugin * plugin, KeySet * generated, KeySet * ks, Key * parentKey)
+{
+	uint64_t times[HARNESS_MAX_RUNS];
+	size_t allocated[HARNESS_MAX_RUNS];
+	ElektraAllocStats tagged[ELEKTRA_ALLOC_TOTAL + 1];
+
+	for (size_t run = 0; run < matrix->runs; ++run)
+	{
+		if (runOnce (result->operation, plugin, generated, ks, parentKey, &times[run], &allocated[run], tagged) < 0)
+		{
+			fprintf (stderr, "Operation %s failed for plugin %s\n", operationNames[result->operation], result->plugin);
+			return -1;
+		}
+	}
+
+	qsort (times, matrix->runs, sizeof (uint64_t), compareUint64);
+	qsort (allocated, matrix->runs, sizeof (size_t), compareSize);
+	size_t p99 = (matrix->runs * 99 + 99) / 100 - 1;
+	result->runs = matrix->runs;
+	result->median = times[(matrix->runs - 1) / 2] / 1000.0;
+	result->p99 = times[p99] / 1000.0;
+	result->allocations = tagAccounting ? (ssize_t) allocated[(matrix->runs - 1) / 2] : -1;
+
+	// the allocations per subsystem do not vary between runs, so the last one is taken
+	for (ElektraAllocTag tag = ELEKTRA_ALLOC_OTHER; tag < ELEKTRA_ALLOC_TOTAL; ++tag)
+	{
+		result->tagAllocations[tag] = tagAccounting ? (ssize_t) tagged[tag].allocations : -1;
+	}
+	result->peakBytes = tagAccounting ? (ssize_t) tagged[ELEKTRA_ALLOC_TOTAL].peak : -1;
+	return 0;
+}
+
+static void printCsvHeader (FILE * out)
+{
+	fprintf (out, HARNESS_CSV_HEADER);
+	for (ElektraAllocTag tag = ELEKTRA_ALLOC_OTHER; tag < ELEKTRA_ALLOC_TOTAL; ++tag)
+	{
+		fprintf (out, ";%s_allocations", elektraAllocTagName (tag));
+	}
+	fprintf (out, ";peak_bytes\n");
+}
+
+static void printResult (FILE * out, Format format, const Result * result, bool first)
+{
+	if (format == FORMAT_CSV)
+	{
+		fprintf (out, HARNESS_CSV_FMT, result->size, result->shape, result->plugin, operationNames[result->operation], result->runs,
+			 result->median, result->p99, result->allocations);
+		for (ElektraAllocTag tag = ELEKTRA_ALLOC_OTHER; tag < ELEKTRA_ALLOC_TOTAL; ++tag)
+		{
+			fprintf (out, ";%zd", result->tagAllocations[tag]);
+		}
+		fprintf (out, ";%zd\n", result->peakBytes);
+		return;
+	}
+
+	fprintf (out,
+		 "%s\n    { \"size\": %zu, \"shape\": \"%s\", \"plugin\": \"%s\", \"operation\": \"%s\", \"runs\": %zu, \"median_us\": %.3f, "
+		 "\"p99_us\": %.3f, ",
+		 first ? "" : ",", result->size, result->shape, result->plugin, operationNames[result->operation], result->runs,
+		 result->median, result->p99);
+	if (result->allocations < 0)
+	{
+		fprintf (out, "\"allocations\": null");
+	}
+	else
+	{
+		fprintf (out, "\"allocations\": %zd", result->allocations);
+	}
+	if (result->peakBytes < 0)
+	{
+		fprintf (out, " }");
+		return;
+	}
+	for (ElektraAllocTag tag = ELEKTRA_ALLOC_OTHER; tag < ELEKTRA_ALLOC_TOTAL; ++tag)
+	{
+		fprintf (out, ", \"%s_allocations\": %zd", elektraAllocTagName (tag), result->tagAllocations[tag]);
+	}
+	fprintf (out, ", \"peak_bytes\": %zd }", result->peakBytes);
+}
+
+/**
+ * @brief Compares a result to the matching line of a baseline in CSV format
+ *
+ * @retval 1 if the result is a regression
+ * @retval 0 otherwise, also if there is no matching line
+ */
+static int compareBaseline (FILE * baseline, const Result * result, double threshold)
+{
+	char line[HARNESS_LINE_LENGTH];
+	char shape[HARNESS_LINE_LENGTH];
+	char plugin[HARNESS_LINE_LENGTH];
+	char operation[HARNESS_LINE_LENGTH];
+	size_t size;
+	size_t runs;
+	double median;
+	double p99;
+	ssize_t allocated;
+
+	rewind (baseline);
+	while (fgets (line, sizeof (line), baseline))
+	{
+		if (sscanf (line, "%zu;%1023[^;];%1023[^;];%1023[^;];%zu;%lf;%lf;%zd", &size, shape, plugin, operation, &runs, &median, &p99,
+			    &allocated) != 8)
+		{
+			continue;
+		}
+		if (size != result->size || strcmp (shape, result->shape) || strcmp (plugin, result->plugin) ||
+		    strcmp (operation, operationNames[result->operation]))
+		{
+			continue;
+		}
+
+		int regression = 0;
+		if (result->median > median * (1 + threshold / 100) && result->median - median > HARNESS_NOISE_MICROSECONDS)
+		{
+			fprintf (stderr, "REGRESSION %zu;%s;%s;%s: median %.3f us, baseline %.3f us (%+.1f%%)\n", size, shape, plugin,
+				 operation, result->median, median, (result->median / median - 1) * 100);
+			regression = 1;
+		}
+		if (allocated >= 0 && result->allocations > allocated)
+		{
+			fprintf (stderr, "REGRESSION %zu;%s;%s;%s: %zd allocations, baseline %zd\n", size, shape, plugin, operation,
+				 result->allocations, allocated);
+			regression = 1;
+		}
+		return regression;
+	}
+	return 0;
+}
+
+static size_t splitList (char * list, const char ** entries)
+{
+	size_t count = 0;
+	for (char * entry = strtok (list, ","); entry && count < HARNESS_MAX_ENTRIES; entry = strtok (NULL, ","))
+	{
+		entries[count++] = entry;
+	}
+	return count;
+}
+
+static int parseOperations (char * list, Matrix * matrix)
+{
+	const char * names[HARNESS_MAX_ENTRIES];
+	size_t count = splitList (list, names);
+	matrix->operationCount = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		size_t op = 0;
+		while (op < OPERATION_COUNT && strcmp (names[i], operationNames[op]))
+		{
+			++op;
+		}
+		if (op == OPERATION_COUNT || matrix->operationCount == OPERATION_COUNT) return -1;
+		matrix->operations[matrix->operationCount++] = (Operation) op;
+	}
+	return 0;
+}
+
+static int parseSizes (char * list, Matrix * matrix)
+{
+	const char * names[HARNESS_MAX_ENTRIES];
+	matrix->sizeCount = splitList (list, names);
+	for (size_t i = 0; i < matrix->sizeCount; ++i)
+	{
+		matrix->sizes[i] = strtoul (names[i], NULL, 10);
+		// the generator needs at least 5 keys
+		if (matrix->sizes[i] < 5) return -1;
+	}
+	return 0;
+}
+
+/**
+ * @brief Sets one of the named matrices
+ *
+ * `quick` is meant for checking a change before committing it, `full` for the numbers of a release.
+ */
+static int setMatrix (const char * name, Matrix * matrix)
+{
+	static const char * const shapes[] = { "default", "flat", "deep" };
+	static const char * const quickPlugins[] = { "none", "quickdump", "mmapstorage" };
+	static const char * const fullPlugins[] = { "none", "dump", "quickdump", "mmapstorage" };
+
+	matrix->shapeCount = 0;
+	matrix->pluginCount = 0;
+	if (!strcmp (name, "quick"))
+	{
+		matrix->sizes[0] = 1000;
+		matrix->sizes[1] = 10000;
+		matrix->sizeCount = 2;
+		matrix->shapes[matrix->shapeCount++] = shapes[0];
+		for (size_t i = 0; i < sizeof (quickPlugins) / sizeof (quickPlugins[0]); ++i)
+		{
+			matrix->plugins[matrix->pluginCount++] = quickPlugins[i];
+		}
+		matrix->runs = 11;
+	}
+	else if (!strcmp (name, "full"))
+	{
+		matrix->sizes[0] = 1000;
+		matrix->sizes[1] = 10000;
+		matrix->sizes[2] = 100000;
+		matrix->sizeCount = 3;
+		for (size_t i = 0; i < sizeof (shapes) / sizeof (shapes[0]); ++i)
+		{
+			matrix->shapes[matrix->shapeCount++] = shapes[i];
+		}
+		for (size_t i = 0; i < sizeof (fullPlugins) / sizeof (fullPlugins[0]); ++i)
+		{
+			matrix->plugins[matrix->pluginCount++] = fullPlugins[i];
+		}
+		matrix->runs = 31;
+	}
+	else
+	{
+		return -1;
+	}
+	matrix->operationCount = OPERATION_COUNT;
+	for (size_t op = 0; op < OPERATION_COUNT; ++op)
+	{
+		matrix->operations[op] = (Operation) op;
+	}
+	return 0;
+}
+
+static void usage (const char * program)
+{
+	fprintf (stderr,
+		 "Usage: %s [options]\n"
+		 "  --matrix=quick|full         named matrix to run (default: quick), the options below override it\n"
+		 "  --sizes=<n,...>             KeySet sizes (at least 5)\n"
+		 "  --shapes=<shape,...>        KeySet shapes: default, flat, deep\n"
+		 "  --plugins=<plugin,...>      storage plugins, none runs the in-memory operations on the generated KeySet\n"
+		 "  --operations=<op,...>       get, set, lookup, iterate, cut, merge\n"
+		 "  --runs=<n>                  repetitions of every cell\n"
+		 "  --seed=<n>                  seed for the KeySet generator\n"
+		 "  --format=csv|json           output format (default: csv)\n"
+		 "  --baseline=<file>           CSV output of an earlier run to compare with\n"
+		 "  --threshold=<percent>       allowed slowdown of the median compared to the baseline (default: %.0f)\n",
+		 program, HARNESS_DEFAULT_THRESHOLD);
+}
+
+static const char * getOption (const char * arg, const char * name)
+{
+	size_t len = strlen (name);
+	if (strncmp (arg, name, len) || arg[len] != '=') return NULL;
+	return arg + len + 1;
+}
+
+int main (int argc, char ** argv)
+{
+	Matrix matrix;
+	setMatrix ("quick", &matrix);
+	matrix.seed = 1;
+	Format format = FORMAT_CSV;
+	const char * baselineFile = NULL;
+	double threshold = HARNESS_DEFAULT_THRESHOLD;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const char * value;
+		int error = 0;
+		if (!strcmp (argv[i], "--help"))
+		{
+			usage (argv[0]);
+			return EXIT_SUCCESS;
+		}
+		else if ((value = getOption (argv[i], "--matrix")))
+		{
+			error = setMatrix (value, &matrix);
+		}
+		else if ((value = getOption (argv[i], "--sizes")))
+		{
+			error = parseSizes (argv[i] + strlen ("--sizes="), &matrix);
+		}
+		else if ((value = getOption (argv[i], "--shapes")))
+		{
+			matrix.shapeCount = splitList (argv[i] + strlen ("--shapes="), matrix.shapes);
+			KeySetShape shape;
+			KeySetShape * out;
+			for (size_t s = 0; s < matrix.shapeCount; ++s)
+			{
+				error |= getShape (matrix.shapes[s], &shape, &out);
+			}
+		}
+		else if ((value = getOption (argv[i], "--plugins")))
+		{
+			matrix.pluginCount = splitList (argv[i] + strlen ("--plugins="), matrix.plugins);
+		}
+		else if ((value = getOption (argv[i], "--operations")))
+		{
+			error = parseOperations (argv[i] + strlen ("--operations="), &matrix);
+		}
+		else if ((value = getOption (argv[i], "--runs")))
+		{
+			matrix.runs = strtoul (value, NULL, 10);
+			error = matrix.runs == 0 || matrix.runs > HARNESS_MAX_RUNS;
+		}
+		else if ((value = getOption (argv[i], "--seed")))
+		{
+			matrix.seed = strtol (value, NULL, 10);
+		}
+		else if ((value = getOption (argv[i], "--format")))
+		{
+			if (!strcmp (value, "csv"))
+				format = FORMAT_CSV;
+			else if (!strcmp (value, "json"))
+				format = FORMAT_JSON;
+			else
+				error = 1;
+		}
+		else if ((value = getOption (argv[i], "--baseline")))
+		{
+			baselineFile = value;
+		}
+		else if ((value = getOption (argv[i], "--threshold")))
+		{
+			threshold = strtod (value, NULL);
+		}
+		else
+		{
+			error = 1;
+		}
+
+		if (error)
+		{
+			fprintf (stderr, "Invalid argument: %s\n", argv[i]);
+			usage (argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	FILE * baseline = NULL;
+	if (baselineFile && !(baseline = fopen (baselineFile, "r")))
+	{
+		fprintf (stderr, "Could not open baseline: %s\n", baselineFile);
+		return EXIT_FAILURE;
+	}
+
+	// only used for the temporary file the storage plugins write to
+	init (1, argv);
+	tagAccounting = elektraAllocAccounting (1) >= 0;
+
+	KeySet * modules = ksNew (0, KS_END);
+	elektraModulesInit (modules, 0);
+	Key * parentKey = keyNew (KEY_ROOT, KEY_VALUE, tmpfilename, KEY_END);
+
+	int regressions = 0;
+	int failed = 0;
+	bool first = true;
+
+	if (format == FORMAT_CSV)
+		printCsvHeader (stdout);
+	else
+		fprintf (stdout, "{\n  \"results\": [");
+
+	for (size_t p = 0; p < matrix.pluginCount && !failed; ++p)
+	{
+		Plugin * plugin = NULL;
+		if (strcmp (matrix.plugins[p], "none") && !(plugin = openPlugin (matrix.plugins[p], modules)))
+		{
+			fprintf (stderr, "Could not open plugin: %s\n", matrix.plugins[p]);
+			failed = 1;
+			break;
+		}
+
+		for (size_t sz = 0; sz < matrix.sizeCount && !failed; ++sz)
+		{
+			for (size_t sh = 0; sh < matrix.shapeCount && !failed; ++sh)
+			{
+				KeySet * generated = generateCell (matrix.sizes[sz], matrix.seed, matrix.shapes[sh]);
+				KeySet * ks = generated;
+
+				// the in-memory operations work on the KeySet as returned by the plugin
+				if (plugin)
+				{
+					ks = ksNew (0, KS_END);
+					if (plugin->kdbSet (plugin, generated, parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR ||
+					    plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR)
+					{
+						fprintf (stderr, "Could not write and read with plugin: %s\n", matrix.plugins[p]);
+						failed = 1;
+					}
+				}
+
+				for (size_t op = 0; op < matrix.operationCount && !failed; ++op)
+				{
+					Operation operation = matrix.operations[op];
+					if (!plugin && (operation == OPERATION_GET || operation == OPERATION_SET)) continue;
+
+					Result result = { .size = matrix.sizes[sz],
+							  .shape = matrix.shapes[sh],
+							  .plugin = matrix.plugins[p],
+							  .operation = operation };
+					if (runCell (&matrix, &result, plugin, generated, ks, parentKey) < 0)
+					{
+						failed = 1;
+						break;
+					}
+					printResult (stdout, format, &result, first);
+					fflush (stdout);
+					first = false;
+					if (baseline) regressions += compareBaseline (baseline, &result, threshold);
+				}
+				if (ks != generated) ksDel (ks);
+				ksDel (generated);
+			}
+		}
+
+		if (plugin) elektraPluginClose (plugin, 0);
+		unlink (tmpfilename);
+	}
+
+	if (format == FORMAT_JSON) fprintf (stdout, "\n  ]\n}\n");
+
+	keyDel (parentKey);
+	elektraModulesClose (modules, 0);
+	ksDel (modules);
+	if (baseline) fclose (baseline);
+
+	if (failed) return EXIT_FAILURE;
+	if (regressions)
+	{
+		fprintf (stderr, "%d regression(s) compared to %s\n", regressions, baselineFile);
+		return 2;
+	}
+	return EXIT_SUCCESS;
+}
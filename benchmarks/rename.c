@@ -0,0 +1,64 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for renaming all keys of a large keyset
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+
+static int renameKey (Key * key, void * data ELEKTRA_UNUSED)
+{
+	keySetNamespace (key, KEY_NS_SYSTEM);
+	return 1;
+}
+
+static void benchmarkPopAppend (void)
+{
+	KeySet * iterateKs = ksDup (large);
+	Key * cur;
+	for (elektraCursor it = 0; (cur = ksAtCursor (iterateKs, it)) != NULL; ++it)
+	{
+		Key * renamed = keyDup (cur, KEY_CP_ALL);
+		keySetNamespace (renamed, KEY_NS_SYSTEM);
+		keyDel (ksLookup (large, cur, KDB_O_POP));
+		ksAppendKey (large, renamed);
+	}
+	ksDel (iterateKs);
+}
+
+static void benchmarkRenameEach (void)
+{
+	ksRenameEach (large, 0, ksGetSize (large), renameKey, NULL);
+}
+
+int main (int argc, char ** argv)
+{
+	num_dir = 500;
+	num_key = 200;
+	if (argc == 3)
+	{
+		num_dir = atoi (argv[1]);
+		num_key = atoi (argv[2]);
+	}
+	printf ("Using %d dirs %d keys\n", num_dir, num_key);
+
+	timeInit ();
+	benchmarkCreate ();
+	benchmarkFillup ();
+	timePrint ("New large keyset");
+
+	benchmarkPopAppend ();
+	timePrint ("Renamed with ksLookup/ksAppendKey");
+
+	ksDel (large);
+	benchmarkCreate ();
+	benchmarkFillup ();
+	timePrint ("New large keyset");
+
+	benchmarkRenameEach ();
+	timePrint ("Renamed with ksRenameEach");
+
+	ksDel (large);
+}
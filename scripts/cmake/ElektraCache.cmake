@@ -244,6 +244,8 @@ option (INSTALL_BUILD_TOOLS "Install build tools for cross-compilation" OFF)
 
 option (ENABLE_OPTIMIZATIONS "Turn on optimizations that trade memory for speed" ON)
 
+option (ENABLE_ALLOC_ACCOUNTING "Count allocations per subsystem, see elektraAllocStatsGet()" OFF)
+
 #
 # Developer builds
 #
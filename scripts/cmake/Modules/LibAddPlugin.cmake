@@ -30,6 +30,11 @@ function (set_additional_compile_definitions shortname)
 		list (APPEND ADDITIONAL_COMPILE_DEFINITIONS_PARTS "ELEKTRA_MODULE_NAME=${shortname}")
 	endif ()
 
+	# attribute allocations of plugins, see elektraAllocStatsGet()
+	if (ENABLE_ALLOC_ACCOUNTING AND NOT "${ARG_COMPILE_DEFINITIONS}" MATCHES "ELEKTRA_ALLOC_TAG")
+		list (APPEND ADDITIONAL_COMPILE_DEFINITIONS_PARTS "ELEKTRA_ALLOC_TAG=ELEKTRA_ALLOC_PLUGIN")
+	endif ()
+
 	set (
 		ADDITIONAL_COMPILE_DEFINITIONS
 		"${ADDITIONAL_COMPILE_DEFINITIONS_PARTS}"
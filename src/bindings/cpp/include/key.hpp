@@ -9,9 +9,13 @@
 #ifndef ELEKTRA_KEY_HPP
 #define ELEKTRA_KEY_HPP
 
+#include <cctype>
+#include <cerrno>
 #include <cstdarg>
+#include <cstdlib>
 #include <cstring>
 #include <functional>
+#include <limits>
 #include <locale>
 #include <sstream>
 #include <string>
@@ -254,6 +258,12 @@ public:
 private:
 	inline int del ();
 
+	inline const char * getConversionString () const;
+	template <class T>
+	inline T getSigned () const;
+	template <class T>
+	inline T getUnsigned () const;
+
 	ckdb::Key * key; ///< holds an elektra key
 };
 
@@ -1076,6 +1086,8 @@ inline QColor Key::get() const
  * @copydoc getString
  *
  * This method tries to serialise the string to the given type.
+ * Integers are converted with strtoll() or strtoull(), all other
+ * types with a std::istringstream.
  */
 template <class T>
 inline T Key::get () const
@@ -1099,6 +1111,118 @@ inline std::string Key::get () const
 	return getString ();
 }
 
+/**
+ * @return the string value of the key without copying it
+ *
+ * @throw KeyException on null key
+ * @throw KeyTypeMismatch if key holds binary data and not a string
+ */
+inline const char * Key::getConversionString () const
+{
+	if (!key) throw KeyException ();
+	if (ckdb::keyIsBinary (key)) throw KeyTypeMismatch ();
+	return ckdb::keyString (key);
+}
+
+/**
+ * Converts the value to a signed integer with strtoll().
+ *
+ * Accepts the same decimal values as the stream based get(), but
+ * neither copies the value nor constructs a stream.
+ *
+ * @throw KeyTypeConversion if the value is not a number or out of range
+ */
+template <class T>
+inline T Key::getSigned () const
+{
+	const char * str = getConversionString ();
+	char * end;
+	errno = 0;
+	long long x = std::strtoll (str, &end, 10);
+	if (end == str || *end != '\0' || errno == ERANGE || x < std::numeric_limits<T>::min () || x > std::numeric_limits<T>::max ())
+	{
+		throw KeyTypeConversion ();
+	}
+	return static_cast<T> (x);
+}
+
+/**
+ * Converts the value to an unsigned integer with strtoull().
+ *
+ * Unlike strtoull() and the stream based get(), negative values
+ * are rejected instead of wrapped around.
+ *
+ * @throw KeyTypeConversion if the value is not a number or out of range
+ */
+template <class T>
+inline T Key::getUnsigned () const
+{
+	const char * str = getConversionString ();
+	const char * start = str;
+	while (std::isspace (static_cast<unsigned char> (*start)))
+	{
+		++start;
+	}
+	if (*start == '-') throw KeyTypeConversion ();
+
+	char * end;
+	errno = 0;
+	unsigned long long x = std::strtoull (start, &end, 10);
+	if (end == start || *end != '\0' || errno == ERANGE || x > std::numeric_limits<T>::max ())
+	{
+		throw KeyTypeConversion ();
+	}
+	return static_cast<T> (x);
+}
+
+template <>
+inline short Key::get () const
+{
+	return getSigned<short> ();
+}
+
+template <>
+inline unsigned short Key::get () const
+{
+	return getUnsigned<unsigned short> ();
+}
+
+template <>
+inline int Key::get () const
+{
+	return getSigned<int> ();
+}
+
+template <>
+inline unsigned int Key::get () const
+{
+	return getUnsigned<unsigned int> ();
+}
+
+template <>
+inline long Key::get () const
+{
+	return getSigned<long> ();
+}
+
+template <>
+inline unsigned long Key::get () const
+{
+	return getUnsigned<unsigned long> ();
+}
+
+template <>
+inline long long Key::get () const
+{
+	return getSigned<long long> ();
+}
+
+template <>
+inline unsigned long long Key::get () const
+{
+	return getUnsigned<unsigned long long> ();
+}
+
 /**
  * Set a key value.
  *
@@ -25,6 +25,7 @@ namespace kdb
 #ifndef ELEKTRA_WITHOUT_ITERATOR
 class KeySetIterator;
 class KeySetReverseIterator;
+class KeySetRange;
 #endif
 
 
@@ -96,6 +97,7 @@ public:
 	Key at (elektraCursor pos) const;
 
 	KeySet cut (Key k);
+	KeySet children (Key const & root) const;
 
 	Key lookup (const Key & k, const elektraLookupFlags options = KDB_O_NONE) const;
 	Key lookup (std::string const & name, const elektraLookupFlags options = KDB_O_NONE) const;
@@ -125,6 +127,8 @@ public:
 	const_iterator cend () const noexcept;
 	const_reverse_iterator crbegin () const noexcept;
 	const_reverse_iterator crend () const noexcept;
+
+	KeySetRange below (Key const & root) const;
 #endif // ELEKTRA_WITHOUT_ITERATOR
 
 private:
@@ -419,6 +423,53 @@ inline KeySetReverseIterator operator+ (KeySetReverseIterator::difference_type n
 }
 
 
+/**
+ * A view of the keys at and below a root key, see KeySet::below().
+ *
+ * The view does not copy any keys, it only remembers where
+ * the hierarchy starts and ends in the keyset. It gets invalid
+ * as soon as the keyset is modified.
+ *
+ * @code
+	for (Key k : ks.below (Key ("user:/app", KEY_END)))
+	{
+		std::cout << k.getName () << std::endl;
+	}
+ * @endcode
+ */
+class KeySetRange
+{
+public:
+	typedef KeySetIterator iterator;
+	typedef KeySetIterator const_iterator;
+
+	KeySetRange (KeySet const & k, const elektraCursor s, const elektraCursor e) : ks (k), first (s), last (e){};
+
+	const_iterator begin () const
+	{
+		return const_iterator (ks, first);
+	}
+	const_iterator end () const
+	{
+		return const_iterator (ks, last);
+	}
+
+	ssize_t size () const
+	{
+		return last - first;
+	}
+	bool empty () const
+	{
+		return first == last;
+	}
+
+private:
+	KeySet const & ks;
+	elektraCursor first;
+	elektraCursor last;
+};
+
+
 inline KeySet::iterator KeySet::begin ()
 {
 	return KeySet::iterator (*this, 0);
@@ -478,6 +529,24 @@ inline KeySet::const_reverse_iterator KeySet::crend () const noexcept
 {
 	return KeySet::const_reverse_iterator (*this, -1);
 }
+
+/**
+ * @brief Get a view of all keys at and below @p root
+ *
+ * Unlike cut(), the keys stay in the keyset and nothing gets copied,
+ * finding the range only needs two binary searches (see ksFindBelow()).
+ *
+ * @param root the root of the hierarchy, does not need to be part of the keyset
+ *
+ * @return the keys at and below @p root, empty if there are none or @p root is null
+ */
+inline KeySetRange KeySet::below (Key const & root) const
+{
+	elektraCursor end;
+	elektraCursor start = ckdb::ksFindBelow (ks, root.getKey (), &end);
+	if (start < 0) start = end = 0;
+	return KeySetRange (*this, start, end);
+}
 #endif // ELEKTRA_WITHOUT_ITERATOR
 
 
@@ -783,6 +852,39 @@ inline KeySet KeySet::cut (Key k)
 	return KeySet (ckdb::ksCut (ks, k.getKey ()));
 }
 
+/**
+ * @brief Collect the direct children of a key
+ *
+ * The keys below the children are skipped, see ksFindNextChild().
+ *
+ * Children that are not part of this keyset themselves, but
+ * have keys below them, are returned as new keys that only
+ * have a name.
+ *
+ * @param root the key whose direct children should be collected
+ *
+ * @return a new keyset with the direct children of @p root
+ */
+inline KeySet KeySet::children (Key const & root) const
+{
+	KeySet result;
+	for (elektraCursor it = ckdb::ksFindNextChild (ks, root.getKey (), -1); it >= 0 && it < size ();
+	     it = ckdb::ksFindNextChild (ks, root.getKey (), it))
+	{
+		Key child = at (it);
+		if (!child.isDirectBelow (root))
+		{
+			child = Key (child.getName (), KEY_END);
+			while (!child.isDirectBelow (root))
+			{
+				child.delBaseName ();
+			}
+		}
+		result.append (child);
+	}
+	return result;
+}
+
 /**
  * @copydoc ksLookup()
  *
@@ -8,6 +8,7 @@
 
 #include <tests.hpp>
 
+#include <limits>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -64,6 +65,40 @@ TEST (key, typebool)
 	ASSERT_TRUE (k.get<bool> ());
 }
 
+TEST (key, typeint)
+{
+	Key k ("user:/key", KEY_VALUE, "30", KEY_END);
+	EXPECT_EQ (k.get<int> (), 30);
+	EXPECT_EQ (k.get<unsigned int> (), 30u);
+	k.setString (" +30");
+	EXPECT_EQ (k.get<long> (), 30);
+	k.setString ("010");
+	EXPECT_EQ (k.get<short> (), 10);
+	k.setString ("-9223372036854775808");
+	EXPECT_EQ (k.get<long long> (), std::numeric_limits<long long>::min ());
+	k.setString ("18446744073709551615");
+	EXPECT_EQ (k.get<unsigned long long> (), std::numeric_limits<unsigned long long>::max ());
+
+	k.setString ("");
+	EXPECT_THROW (k.get<int> (), KeyTypeConversion);
+	k.setString ("30 ");
+	EXPECT_THROW (k.get<int> (), KeyTypeConversion);
+	k.setString ("0x10");
+	EXPECT_THROW (k.get<int> (), KeyTypeConversion);
+	k.setString ("40000");
+	EXPECT_THROW (k.get<short> (), KeyTypeConversion);
+	k.setString ("70000");
+	EXPECT_THROW (k.get<unsigned short> (), KeyTypeConversion);
+	k.setString ("18446744073709551616");
+	EXPECT_THROW (k.get<unsigned long long> (), KeyTypeConversion);
+	k.setString (" -1");
+	EXPECT_EQ (k.get<int> (), -1);
+	EXPECT_THROW (k.get<unsigned int> (), KeyTypeConversion);
+
+	k.setBinary ("30", 3);
+	EXPECT_THROW (k.get<int> (), KeyTypeMismatch);
+}
+
 
 TEST (key, keynew)
 {
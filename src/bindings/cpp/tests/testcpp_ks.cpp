@@ -673,6 +673,47 @@ TEST (ks, lookupPop)
 	}
 }
 
+TEST (ks, below)
+{
+	KeySet ks (5, *Key ("user:/app", KEY_END), *Key ("user:/app/a", KEY_END), *Key ("user:/app/a/b", KEY_END),
+		   *Key ("user:/apple", KEY_END), *Key ("user:/other", KEY_END), KS_END);
+
+	KeySetRange range = ks.below (Key ("user:/app", KEY_END));
+	ASSERT_EQ (range.size (), 3);
+	std::vector<std::string> names;
+	for (Key k : range)
+	{
+		names.push_back (k.getName ());
+	}
+	EXPECT_EQ (names, (std::vector<std::string>{ "user:/app", "user:/app/a", "user:/app/a/b" }));
+	EXPECT_EQ (ks.size (), 5);
+
+	EXPECT_EQ (ks.below (Key ("user:/app/a/b", KEY_END)).size (), 1);
+	EXPECT_EQ (ks.below (ks.lookup ("user:/app/a")).size (), 2);
+	EXPECT_TRUE (ks.below (Key ("user:/missing", KEY_END)).empty ());
+	EXPECT_TRUE (ks.below (Key ("system:/app", KEY_END)).empty ());
+	EXPECT_TRUE (ks.below (Key ()).empty ());
+	EXPECT_EQ (ks.below (Key ("user:/", KEY_END)).size (), 5);
+}
+
+TEST (ks, children)
+{
+	Key app ("user:/app", KEY_END);
+	KeySet ks (6, *app, *Key ("user:/app/a", KEY_END), *Key ("user:/app/a/b", KEY_END), *Key ("user:/app/implicit/c", KEY_END),
+		   *Key ("user:/apple", KEY_END), *Key ("user:/other", KEY_END), KS_END);
+
+	KeySet children = ks.children (app);
+	ASSERT_EQ (children.size (), 2);
+	EXPECT_EQ (children.at (0).getName (), "user:/app/a");
+	EXPECT_EQ (children.at (1).getName (), "user:/app/implicit");
+	EXPECT_EQ (children.at (0).getKey (), ks.lookup ("user:/app/a").getKey ()) << "existing children should be shared";
+	EXPECT_FALSE (ks.lookup ("user:/app/implicit")) << "implicit children must not be added";
+
+	EXPECT_EQ (ks.children (Key ("user:/", KEY_END)).size (), 3);
+	EXPECT_EQ (ks.children (Key ("user:/app/a/b", KEY_END)).size (), 0);
+	EXPECT_EQ (ks.children (Key ("system:/", KEY_END)).size (), 0);
+}
+
 TEST (ks, duplicate)
 {
 	KeySet ks3 (5, *Key ("user:/key3/1", KEY_END), *Key ("user:/key3/2", KEY_END), *Key ("user:/key3/3", KEY_VALUE, "value", KEY_END),
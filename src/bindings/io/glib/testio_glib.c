@@ -9,6 +9,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <kdbio.h>
 #include <kdbiotest.h>
@@ -56,7 +57,14 @@ int main (int argc, char ** argv)
 	context = g_main_context_new ();
 	loop = g_main_loop_new (context, 0);
 
-	elektraIoTestSuite (createBinding, startLoop, stopLoop);
+	if (argc > 2 && strcmp (argv[2], "kdb") == 0)
+	{
+		elektraIoTestSuiteKdb (createBinding, startLoop, stopLoop);
+	}
+	else
+	{
+		elektraIoTestSuite (createBinding, startLoop, stopLoop);
+	}
 
 	print_result ("iowrapper_glib");
 
@@ -0,0 +1,118 @@
+/**
+ * @file
+ *
+ * @brief Tests for I/O bindings
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ * Tests for elektraIoKdbGetAsync(). They open the key database and are
+ * therefore run separately from elektraIoTestSuite().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <tests.h>
+
+#include "test.h"
+#include <kdbio.h>
+#include <kdbiotest.h>
+
+#define KDB_CONTROL_INTERVAL 2000
+
+#define KDB_PARENT_KEY "user:/tests/io/async"
+
+// Number of operations started from the completion callback
+#define KDB_CHAINED_GETS 2
+
+static ElektraIoTestSuiteStop testStop;
+
+static ElektraIoInterface * testBinding;
+
+static int testKdbGetCalled;
+
+static void testKdbGetBasics (ElektraIoTestSuiteCreateBinding createBinding)
+{
+	ElektraIoInterface * binding = createBinding ();
+	Key * parentKey = keyNew (KDB_PARENT_KEY, KEY_END);
+	KeySet * ks = ksNew (0, KS_END);
+	KDB * kdb = kdbOpen (NULL, parentKey);
+	exit_if_fail (kdb != NULL, "kdbOpen failed");
+
+	succeed_if (elektraIoKdbGetAsync (NULL, kdb, ks, parentKey, NULL, NULL) == -1, "should fail without binding");
+	succeed_if (elektraIoKdbGetAsync (binding, NULL, ks, parentKey, NULL, NULL) == -1, "should fail without kdb");
+	succeed_if (elektraIoKdbGetAsync (binding, kdb, NULL, parentKey, NULL, NULL) == -1, "should fail without keyset");
+	succeed_if (elektraIoKdbGetAsync (binding, kdb, ks, NULL, NULL, NULL) == -1, "should fail without parent key");
+	succeed_if (elektraIoKdbGetAsync (binding, kdb, ks, parentKey, NULL, NULL) == -1, "should fail without callback");
+
+	kdbClose (kdb, parentKey);
+	ksDel (ks);
+	keyDel (parentKey);
+	elektraIoBindingCleanup (binding);
+}
+
+static void testKdbGetControl (ElektraIoTimerOperation * timerOp ELEKTRA_UNUSED)
+{
+	yield_error ("timeout; test failed");
+	testStop ();
+}
+
+static void testKdbGetCallback (KDB * kdb, KeySet * returned, Key * parentKey, int result, void * data)
+{
+	succeed_if (result != -1, "kdbGet failed");
+	succeed_if (data == &testKdbGetCalled, "wrong data");
+	testKdbGetCalled++;
+
+	if (testKdbGetCalled < KDB_CHAINED_GETS)
+	{
+		// the operation is finished, so the next one may start
+		succeed_if (elektraIoKdbGetAsync (testBinding, kdb, returned, parentKey, testKdbGetCallback, data) == 0,
+			    "could not start next operation from callback");
+		return;
+	}
+	testStop ();
+}
+
+static void testKdbGetShouldComplete (ElektraIoTestSuiteCreateBinding createBinding, ElektraIoTestSuiteStart start,
+				      ElektraIoTestSuiteStop stop)
+{
+	Key * parentKey = keyNew (KDB_PARENT_KEY, KEY_END);
+	KeySet * ks = ksNew (0, KS_END);
+	KDB * kdb = kdbOpen (NULL, parentKey);
+	exit_if_fail (kdb != NULL, "kdbOpen failed");
+
+	ElektraIoTimerOperation * timerOp = elektraIoNewTimerOperation (KDB_CONTROL_INTERVAL, 1, testKdbGetControl, NULL);
+
+	testBinding = createBinding ();
+	elektraIoBindingAddTimer (testBinding, timerOp);
+
+	testKdbGetCalled = 0;
+	testStop = stop;
+
+	succeed_if (elektraIoKdbGetAsync (testBinding, kdb, ks, parentKey, testKdbGetCallback, &testKdbGetCalled) == 0,
+		    "could not start operation");
+	succeed_if (elektraIoKdbGetAsync (testBinding, kdb, ks, parentKey, testKdbGetCallback, &testKdbGetCalled) == -1,
+		    "should not start second operation while one is pending");
+	succeed_if (testKdbGetCalled == 0, "callback called outside of event loop");
+
+	start ();
+
+	succeed_if (testKdbGetCalled == KDB_CHAINED_GETS, "callback was not called");
+
+	elektraIoBindingRemoveTimer (timerOp);
+	elektraIoBindingCleanup (testBinding);
+	elektraFree (timerOp);
+	kdbClose (kdb, parentKey);
+	ksDel (ks);
+	keyDel (parentKey);
+}
+
+void elektraIoTestSuiteKdb (ElektraIoTestSuiteCreateBinding createBinding, ElektraIoTestSuiteStart start, ElektraIoTestSuiteStop stop)
+{
+	printf ("test asynchronous kdbGet\n");
+
+	testKdbGetBasics (createBinding);
+
+	testKdbGetShouldComplete (createBinding, start, stop);
+}
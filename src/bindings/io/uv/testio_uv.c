@@ -9,6 +9,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <kdbio.h>
 #include <kdbiotest.h>
@@ -37,7 +38,14 @@ int main (int argc, char ** argv)
 {
 	init (argc, argv);
 
-	elektraIoTestSuite (createBinding, startLoop, stopLoop);
+	if (argc > 2 && strcmp (argv[2], "kdb") == 0)
+	{
+		elektraIoTestSuiteKdb (createBinding, startLoop, stopLoop);
+	}
+	else
+	{
+		elektraIoTestSuite (createBinding, startLoop, stopLoop);
+	}
 
 	// Run loop once to fire handle closed callbacks and free memory
 	// see http://docs.libuv.org/en/v1.x/handle.html#c.uv_close
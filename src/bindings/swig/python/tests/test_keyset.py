@@ -149,5 +149,10 @@ class KeySet(unittest.TestCase):
 		self.assertEqual(self.ks.unpack_basenames(), set([ 'key1', 'key2', 'key3', 'key4' ]))
 		self.assertEqual(self.ks.filter_below(kdb.Key('user:/')), kdb.KeySet(2, self.ks[0], self.ks[1]))
 
+	def test_children(self):
+		ks = kdb.KeySet(3, kdb.Key("user:/app/a"), kdb.Key("user:/app/a/b"), kdb.Key("user:/app/c/d"))
+		self.assertEqual([ k.name for k in ks.children(kdb.Key("user:/app")) ], [ "user:/app/a", "user:/app/c" ])
+		self.assertEqual(len(self.ks.children(kdb.Key("system:/"))), 2)
+
 if __name__ == '__main__':
 	unittest.main()
@@ -12,6 +12,7 @@
 #ifndef KDB_HELPER
 #define KDB_HELPER
 
+#include <kdb.h> // for ELEKTRA_ENABLE_ALLOC_ACCOUNTING
 #include <kdbmacros.h>
 #include <kdbtypes.h>
 
@@ -36,6 +37,60 @@ void * elektraMemDup (const void * s, size_t l);
 char * elektraFormat (const char * format, ...) ELEKTRA_ATTRIBUTE_FORMAT (printf, 1, 2);
 char * elektraVFormat (const char * format, va_list arg_list);
 
+/**
+ * @brief Subsystems allocations are attributed to
+ *
+ * The tag of an allocation is the tag of the source file calling the
+ * memory functions, set by defining ELEKTRA_ALLOC_TAG when compiling it.
+ *
+ * @see elektraAllocStatsGet()
+ */
+typedef enum
+{
+	ELEKTRA_ALLOC_OTHER,   ///< everything without a tag, e.g. tools and bindings
+	ELEKTRA_ALLOC_KEY,     ///< keys, their names and values
+	ELEKTRA_ALLOC_KEYSET,  ///< keysets and their hash maps
+	ELEKTRA_ALLOC_META,    ///< metadata
+	ELEKTRA_ALLOC_PLUGIN,  ///< plugins
+	ELEKTRA_ALLOC_BACKEND, ///< backends, mountpoints and kdbGet()/kdbSet()
+	ELEKTRA_ALLOC_TOTAL    ///< sum of all tags, only for elektraAllocStatsGet()
+} ElektraAllocTag;
+
+/**
+ * @brief Allocation statistics of a tag
+ *
+ * @see elektraAllocStatsGet()
+ */
+typedef struct
+{
+	size_t allocations; ///< number of allocations, including reallocations
+	size_t frees;	    ///< number of frees
+	size_t bytes;	    ///< number of bytes requested
+	size_t current;	    ///< bytes currently allocated
+	size_t peak;	    ///< maximum of current since the last reset
+} ElektraAllocStats;
+
+void * elektraMallocTag (size_t size, ElektraAllocTag tag);
+void * elektraCallocTag (size_t size, ElektraAllocTag tag);
+void elektraFreeTag (void * ptr, ElektraAllocTag tag);
+int elektraReallocTag (void ** buffer, size_t size, ElektraAllocTag tag);
+char * elektraStrDupTag (const char * s, ElektraAllocTag tag);
+void * elektraMemDupTag (const void * s, size_t l, ElektraAllocTag tag);
+
+int elektraAllocAccounting (int enable);
+int elektraAllocStatsGet (ElektraAllocTag tag, ElektraAllocStats * stats);
+void elektraAllocStatsReset (void);
+const char * elektraAllocTagName (ElektraAllocTag tag);
+
+#if defined(ELEKTRA_ENABLE_ALLOC_ACCOUNTING) && defined(ELEKTRA_ALLOC_TAG) && !defined(__cplusplus)
+#define elektraMalloc(size) elektraMallocTag (size, ELEKTRA_ALLOC_TAG)
+#define elektraCalloc(size) elektraCallocTag (size, ELEKTRA_ALLOC_TAG)
+#define elektraFree(ptr) elektraFreeTag (ptr, ELEKTRA_ALLOC_TAG)
+#define elektraRealloc(buffer, size) elektraReallocTag (buffer, size, ELEKTRA_ALLOC_TAG)
+#define elektraStrDup(s) elektraStrDupTag (s, ELEKTRA_ALLOC_TAG)
+#define elektraMemDup(s, l) elektraMemDupTag (s, l, ELEKTRA_ALLOC_TAG)
+#endif
+
 /* Compare */
 int elektraStrCmp (const char * s1, const char * s2);
 int elektraStrNCmp (const char * s1, const char * s2, size_t n);
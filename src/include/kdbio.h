@@ -609,6 +609,22 @@ ElektraIoIdleCallback elektraIoIdleGetCallback (ElektraIoIdleOperation * idleOp)
  */
 int elektraIoContract (KeySet * contract, ElektraIoInterface * ioBinding);
 
+/**
+ * Creates a contract for use with kdbOpen() that enables inotify based
+ * change detection of the configuration files.
+ *
+ * When you call kdbOpen() with this contract, the resolvers watch all
+ * resolved files and kdbGet() only stat()s files after they changed.
+ * If the KDB instance also has an I/O binding (see elektraIoContract()),
+ * external changes of the files are reported as notifications.
+ *
+ * @param contract  The keyset into which the contract is written.
+ *
+ * @retval -1 if @p contract is NULL
+ * @retval  0 on success
+ */
+int elektraIoWatchContract (KeySet * contract);
+
 /**
  * Get I/O binding for asynchronous I/O operations for KDB instance.
  * Returns NULL if no I/O binding was set.
@@ -618,6 +634,48 @@ int elektraIoContract (KeySet * contract, ElektraIoInterface * ioBinding);
  */
 ElektraIoInterface * elektraIoGetBinding (KDB * kdb);
 
+/**
+ * Callback of elektraIoKdbGetAsync().
+ *
+ * Called on the thread running the event loop of the I/O binding.
+ *
+ * @param kdb       KDB instance passed to elektraIoKdbGetAsync()
+ * @param returned  keyset with the configuration that was read
+ * @param parentKey parent key with errors and warnings of kdbGet()
+ * @param result    return value of kdbGet()
+ * @param data      data passed to elektraIoKdbGetAsync()
+ */
+typedef void (*ElektraIoKdbGetCallback) (KDB * kdb, KeySet * returned, Key * parentKey, int result, void * data);
+
+/**
+ * Calls kdbGet() without blocking the event loop of @p binding.
+ *
+ * The configuration files are read and parsed on a worker thread.
+ * When kdbGet() finished, @p callback is called on the thread running the
+ * event loop. Without thread support kdbGet() runs immediately, but
+ * @p callback is still called from the event loop.
+ *
+ * @p kdb, @p returned and @p parentKey belong to the operation until
+ * @p callback was called and must not be used in the meantime.
+ * Only one operation per KDB instance can be pending at a time.
+ * Use a KDB instance for this which was opened without elektraIoContract()
+ * or elektraIoWatchContract(), because the plugins of such an instance
+ * would use the event loop from the worker thread.
+ *
+ * @param binding   I/O binding of the event loop
+ * @param kdb       KDB instance
+ * @param returned  keyset passed to kdbGet()
+ * @param parentKey parent key passed to kdbGet()
+ * @param callback  called with the result of kdbGet()
+ * @param data      passed to @p callback
+ *
+ * @retval  0 if the operation was started
+ * @retval -1 if a parameter is NULL, an operation is already pending for
+ *            @p kdb or the operation could not be started
+ */
+int elektraIoKdbGetAsync (ElektraIoInterface * binding, KDB * kdb, KeySet * returned, Key * parentKey, ElektraIoKdbGetCallback callback,
+			  void * data);
+
 #ifdef __cplusplus
 }
 }
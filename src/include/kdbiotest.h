@@ -46,4 +46,15 @@ typedef void (*ElektraIoTestSuiteStop) (void);
  */
 void elektraIoTestSuite (ElektraIoTestSuiteCreateBinding createBinding, ElektraIoTestSuiteStart start, ElektraIoTestSuiteStop stop);
 
+/**
+ * Test-Suite for asynchronous kdbGet on I/O Bindings.
+ *
+ * Unlike elektraIoTestSuite() these tests open the key database.
+ *
+ * @param createBinding Create and initialize a new I/O binding instance
+ * @param start         Pointer to the start function
+ * @param stop          Pointer to the stop function
+ */
+void elektraIoTestSuiteKdb (ElektraIoTestSuiteCreateBinding createBinding, ElektraIoTestSuiteStart start, ElektraIoTestSuiteStop stop);
+
 #endif
@@ -183,6 +183,15 @@ typedef enum {
 		 This flag is set for KeySets where the array is in a mapped region,
 		 and is removed if the array is moved out from the mapped region.
 		 It prevents erroneous free() calls on these arrays. */
+	,KS_FLAG_OWNER = 1 << 4	/*!<
+		 Keys of the KeySet may refer to it as their owner.
+		 This flag is set once the KeySet tracks its changes,
+		 and is removed when all keys are removed from the KeySet.
+		 It allows to skip the ownership checks otherwise. */
+	,KS_FLAG_META_EXPORTED = 1 << 5	/*!<
+		 Metadata KeySet was returned by keyMeta().
+		 The caller might modify it at any time,
+		 so it must never be shared with other keys. */
 } ksflag_t;
 
 
@@ -248,6 +257,12 @@ struct _Key
 	 */
 	KeySet * meta;
 
+	/**
+	 * The KeySet that tracks changes of this key or NULL.
+	 * @see elektraKsTrackChanges()
+	 */
+	KeySet * owner;
+
 	/**
 	 * Some control and internal flags.
 	 */
@@ -297,6 +312,12 @@ struct _KeySet
 
 	uint16_t reserved; /**< Reserved for future use */
 
+	/**
+	 * Names of the keys that changed since the KeySet tracks its changes,
+	 * or NULL if changes are not tracked, see elektraKsTrackChanges().
+	 */
+	struct _KeySet * changes;
+
 #ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
 	/**
 	 * The Order Preserving Minimal Perfect Hash Map.
@@ -347,6 +368,9 @@ struct _KDB
 			up their parts of the global keyset, which they do not need any more.*/
 
 	Plugin * globalPlugins[NR_GLOBAL_POSITIONS][NR_GLOBAL_SUBPOSITIONS];
+
+	int ioGetPending; /*!< Set while an elektraIoKdbGetAsync() is pending. Only accessed
+			by the thread running the I/O binding, not by the worker running kdbGet().*/
 };
 
 
@@ -520,6 +544,7 @@ int splitMergeDefault (Split * split, KeySet * dest);
 
 /* for kdbSet() algorithm */
 int splitDivide (Split * split, KDB * handle, KeySet * ks);
+int splitDivideChanged (Split * split, KDB * handle, KeySet * ks);
 int splitSync (Split * split);
 void splitPrepare (Split * split);
 int splitUpdateSize (Split * split);
@@ -573,6 +598,11 @@ int keyClearSync (Key * key);
 
 int keyReplacePrefix (Key * key, const Key * oldPrefix, const Key * newPrefix);
 
+void keyMetaRelease (Key * key);
+int keyMetaShare (Key * key, KeySet * meta);
+int keyMetaUnshare (Key * key);
+KeySet * elektraKeyGetMetaKeySet (const Key * key);
+
 /*Private helper for keyset*/
 int ksInit (KeySet * ks);
 int ksClose (KeySet * ks);
@@ -597,6 +627,15 @@ ssize_t ksRename (KeySet * ks, const Key * root, const Key * newRoot);
 
 elektraCursor ksFindHierarchy (const KeySet * ks, const Key * root, elektraCursor * end);
 
+typedef int (*ksRenameEachPtr) (Key * key, void * data);
+ssize_t ksRenameEach (KeySet * ks, elektraCursor start, elektraCursor end, ksRenameEachPtr rename, void * data);
+
+ssize_t ksAppendRange (KeySet * ks, const KeySet * source, elektraCursor start, elektraCursor end);
+
+void elektraKeyMarkSync (Key * key);
+int elektraKsTrackChanges (KeySet * ks);
+void elektraKsClearChanges (KeySet * ks);
+
 
 /* Conveniences Methods for Making Tests */
 
@@ -1,6 +1,9 @@
 #ifndef KDBUTILITY_H
 #define KDBUTILITY_H
 
+#include <kdb.h>
+#include <sys/types.h>
+
 #ifdef __cplusplus
 namespace ckdb
 {
@@ -12,6 +15,29 @@ char * elektraLskip (char const * const keyname);
 char * elektraRstrip (char * const start, char ** end);
 char * elektraStrip (char * text);
 
+/* Helpers for Storage Plugins */
+int elektraCopyFileRange (int in, off_t inOffset, int out, off_t outOffset, size_t size);
+int elektraWriteFile (const char * fileName, const void * data, size_t size);
+
+/**
+ * Growable buffer for the output of a storage plugin, see elektraOutputBufferInit().
+ */
+typedef struct
+{
+	char * data;
+	size_t size;
+	size_t alloc;
+	int failed; ///< set if memory could not be allocated, all further appends are ignored
+} ElektraOutputBuffer;
+
+size_t elektraOutputBufferEstimate (KeySet * ks);
+void elektraOutputBufferInit (ElektraOutputBuffer * buffer, size_t size);
+void elektraOutputBufferAppend (ElektraOutputBuffer * buffer, const void * data, size_t size);
+void elektraOutputBufferAppendString (ElektraOutputBuffer * buffer, const char * string);
+void elektraOutputBufferAppendChar (ElektraOutputBuffer * buffer, char c);
+int elektraOutputBufferWrite (ElektraOutputBuffer * buffer, const char * fileName);
+void elektraOutputBufferFree (ElektraOutputBuffer * buffer);
+
 #ifdef __cplusplus
 }
 }
@@ -9,6 +9,7 @@
 #include <kdb.h>
 #include <kdbease.h>
 #include <kdberrors.h>
+#include <kdbprivate.h>
 #include <kdbtypes.h>
 
 #include <stdio.h>
@@ -88,7 +89,7 @@ kdb_boolean_t calculateSpecificationToken (char hash_string[65], KeySet * ks, Ke
 		sha_256_write (&sha_256, keyName (currentKey), keyGetNameSize (currentKey));
 		// Note: The value of the key itself is not relevant / part of specification. Only the key's name + its metadata!
 
-		KeySet * currentMetaKeys = keyMeta (currentKey);
+		KeySet * currentMetaKeys = elektraKeyGetMetaKeySet (currentKey);
 		// Feed name + values from meta keys into sha_256_write().
 		for (elektraCursor metaIt = 0; metaIt < ksGetSize (currentMetaKeys); metaIt++)
 		{
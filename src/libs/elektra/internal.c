@@ -28,6 +28,10 @@
 #include <stdlib.h>
 #endif
 
+#ifdef ELEKTRA_ENABLE_ALLOC_ACCOUNTING
+#include <stdint.h>
+#endif
+
 #ifdef HAVE_ERRNO_H
 #include <errno.h>
 #endif
@@ -210,6 +214,230 @@ int elektraMemCaseCmp (const char * s1, const char * s2, size_t size)
 	return 0;
 }
 
+#ifdef ELEKTRA_ENABLE_ALLOC_ACCOUNTING
+static int allocAccounting = 0;
+static ElektraAllocStats allocStats[ELEKTRA_ALLOC_TOTAL + 1];
+
+/**
+ * A block allocated by the memory functions while accounting was enabled.
+ *
+ * The blocks are kept in a hash table outside of the blocks themselves, so
+ * that frees and reallocations are charged to the tag that allocated the
+ * block and memory from malloc() passed to elektraFree() stays harmless.
+ */
+typedef struct
+{
+	void * ptr;	     ///< the block, NULL for an empty slot
+	size_t size;	     ///< the requested size of the block
+	ElektraAllocTag tag; ///< the tag that allocated the block
+} AllocBlock;
+
+static AllocBlock * allocBlocks;
+static size_t allocBlocksAlloc; ///< number of slots, always a power of two
+static size_t allocBlocksSize;	///< number of used slots
+
+static size_t allocBlockSlot (void * ptr)
+{
+	// Fibonacci hashing, the low bits of a pointer are mostly zero
+	return (size_t) (((uintptr_t) ptr >> 4) * (uintptr_t) 11400714819323198485ull) & (allocBlocksAlloc - 1);
+}
+
+/**
+ * @return the slot of @p ptr in the hash table or allocBlocksAlloc if it is not tracked
+ */
+static size_t allocBlockFind (void * ptr)
+{
+	if (!ptr || allocBlocksSize == 0) return allocBlocksAlloc;
+	for (size_t slot = allocBlockSlot (ptr);; slot = (slot + 1) & (allocBlocksAlloc - 1))
+	{
+		if (allocBlocks[slot].ptr == ptr) return slot;
+		if (!allocBlocks[slot].ptr) return allocBlocksAlloc;
+	}
+}
+
+static void allocBlockInsert (void * ptr, size_t size, ElektraAllocTag tag)
+{
+	if (allocBlocksSize * 2 >= allocBlocksAlloc)
+	{
+		// the table itself must not be counted, so it uses the C library directly
+		size_t oldAlloc = allocBlocksAlloc;
+		AllocBlock * oldBlocks = allocBlocks;
+		AllocBlock * blocks = calloc (oldAlloc ? oldAlloc * 2 : 1024, sizeof (AllocBlock));
+		if (!blocks) return; // the block is not tracked, its free is not counted
+
+		allocBlocks = blocks;
+		allocBlocksAlloc = oldAlloc ? oldAlloc * 2 : 1024;
+		allocBlocksSize = 0;
+		for (size_t i = 0; i < oldAlloc; ++i)
+		{
+			if (oldBlocks[i].ptr) allocBlockInsert (oldBlocks[i].ptr, oldBlocks[i].size, oldBlocks[i].tag);
+		}
+		free (oldBlocks);
+	}
+
+	size_t slot = allocBlockSlot (ptr);
+	while (allocBlocks[slot].ptr)
+	{
+		slot = (slot + 1) & (allocBlocksAlloc - 1);
+	}
+	allocBlocks[slot].ptr = ptr;
+	allocBlocks[slot].size = size;
+	allocBlocks[slot].tag = tag;
+	++allocBlocksSize;
+}
+
+static void allocBlockRemove (size_t slot)
+{
+	allocBlocks[slot].ptr = NULL;
+	--allocBlocksSize;
+
+	// move following blocks back, so that no lookup stops at the new gap
+	for (size_t next = (slot + 1) & (allocBlocksAlloc - 1); allocBlocks[next].ptr; next = (next + 1) & (allocBlocksAlloc - 1))
+	{
+		size_t home = allocBlockSlot (allocBlocks[next].ptr);
+		if (((next - home) & (allocBlocksAlloc - 1)) >= ((next - slot) & (allocBlocksAlloc - 1)))
+		{
+			allocBlocks[slot] = allocBlocks[next];
+			allocBlocks[next].ptr = NULL;
+			slot = next;
+		}
+	}
+}
+
+static void allocCountStats (ElektraAllocStats * stats, size_t requested, size_t freed)
+{
+	if (requested)
+		++stats->allocations;
+	else
+		++stats->frees;
+	stats->bytes += requested;
+	// blocks resized while accounting was disabled must not underflow
+	if (freed > stats->current + requested) freed = stats->current + requested;
+	stats->current = stats->current + requested - freed;
+	if (stats->current > stats->peak) stats->peak = stats->current;
+}
+
+static void allocCount (ElektraAllocTag tag, size_t requested, size_t freed)
+{
+	allocCountStats (&allocStats[tag], requested, freed);
+	allocCountStats (&allocStats[ELEKTRA_ALLOC_TOTAL], requested, freed);
+}
+
+/**
+ * Counts a block that was (re)allocated with @p size bytes and tracks it
+ *
+ * @param tracked if the block was tracked before a reallocation, it stays tracked
+ * @param freed the size of the block before a reallocation, if it was tracked
+ */
+static void allocTrack (void * ptr, size_t size, ElektraAllocTag tag, int tracked, size_t freed)
+{
+	if (allocAccounting) allocCount (tag, size, freed);
+	if (allocAccounting || tracked) allocBlockInsert (ptr, size, tag);
+}
+
+/**
+ * Counts the free of a block and stops tracking it
+ */
+static void allocUntrack (size_t slot)
+{
+	if (allocAccounting) allocCount (allocBlocks[slot].tag, 0, allocBlocks[slot].size);
+	allocBlockRemove (slot);
+}
+
+static ElektraAllocTag allocValidTag (ElektraAllocTag tag)
+{
+	return tag < ELEKTRA_ALLOC_OTHER || tag >= ELEKTRA_ALLOC_TOTAL ? ELEKTRA_ALLOC_OTHER : tag;
+}
+#endif
+
+/**
+ * @brief Switches the allocation accounting on or off
+ *
+ * Allocation accounting must be enabled at compile time with
+ * `ENABLE_ALLOC_ACCOUNTING=ON`, it counts every allocation done with
+ * elektraMalloc() and friends. While it is enabled, the size and tag of
+ * every block are kept in a hash table until the block is freed.
+ * Otherwise the memory functions do not have any overhead.
+ *
+ * Neither the statistics nor the hash table are synchronized, so
+ * accounting must only be compiled in for benchmarks of a single thread.
+ *
+ * @param enable 1 to count allocations from now on, 0 to stop counting
+ *
+ * @retval 1 if accounting was enabled before
+ * @retval 0 if accounting was disabled before
+ * @retval -1 if accounting was not compiled in
+ * @see elektraAllocStatsGet()
+ */
+int elektraAllocAccounting (int enable)
+{
+#ifdef ELEKTRA_ENABLE_ALLOC_ACCOUNTING
+	int previous = allocAccounting;
+	allocAccounting = enable != 0;
+	return previous;
+#else
+	(void) enable;
+	return -1;
+#endif
+}
+
+/**
+ * @brief Get the allocation statistics of a tag
+ *
+ * Frees and reallocations are charged to the tag that allocated the block,
+ * no matter which source file frees or resizes it. Blocks allocated while
+ * accounting was disabled are not counted at all.
+ *
+ * @param tag the tag to get the statistics for
+ * @param stats filled with the statistics
+ *
+ * @retval 0 on success
+ * @retval -1 if accounting was not compiled in or the tag is invalid
+ */
+int elektraAllocStatsGet (ElektraAllocTag tag, ElektraAllocStats * stats)
+{
+	if (!stats) return -1;
+	memset (stats, 0, sizeof (ElektraAllocStats));
+#ifdef ELEKTRA_ENABLE_ALLOC_ACCOUNTING
+	if (tag < ELEKTRA_ALLOC_OTHER || tag > ELEKTRA_ALLOC_TOTAL) return -1;
+	*stats = allocStats[tag];
+	return 0;
+#else
+	(void) tag;
+	return -1;
+#endif
+}
+
+/**
+ * @brief Resets the allocation statistics of all tags
+ *
+ * The currently allocated bytes stay, peak is set to them.
+ */
+void elektraAllocStatsReset (void)
+{
+#ifdef ELEKTRA_ENABLE_ALLOC_ACCOUNTING
+	for (size_t i = 0; i <= ELEKTRA_ALLOC_TOTAL; ++i)
+	{
+		allocStats[i].allocations = 0;
+		allocStats[i].frees = 0;
+		allocStats[i].bytes = 0;
+		allocStats[i].peak = allocStats[i].current;
+	}
+#endif
+}
+
+/**
+ * @brief The name of a tag, e.g. `keyset` for ELEKTRA_ALLOC_KEYSET
+ *
+ * @retval 0 if the tag is invalid
+ */
+const char * elektraAllocTagName (ElektraAllocTag tag)
+{
+	static const char * const names[] = { "other", "key", "keyset", "meta", "plugin", "backend", "total" };
+	if (tag < ELEKTRA_ALLOC_OTHER || tag > ELEKTRA_ALLOC_TOTAL) return 0;
+	return names[tag];
+}
+
 /**Reallocate Storage in a save way.
  *
  *@code
@@ -232,12 +460,34 @@ if (elektraRealloc ((void **) & buffer, new_length) < 0) {
  * @ingroup internal
  */
 int elektraRealloc (void ** buffer, size_t size)
+{
+	return elektraReallocTag (buffer, size, ELEKTRA_ALLOC_OTHER);
+}
+
+/**
+ * @brief elektraRealloc() with the allocation attributed to tag
+ *
+ * @see elektraAllocStatsGet()
+ */
+int elektraReallocTag (void ** buffer, size_t size, ElektraAllocTag tag ELEKTRA_UNUSED)
 {
 	ELEKTRA_ASSERT (size, "Size to allocate is zero (implementation defined behavior)");
 	void * ptr;
 	void * svr = *buffer;
 
+#ifdef ELEKTRA_ENABLE_ALLOC_ACCOUNTING
+	size_t slot = allocBlockFind (*buffer);
+	int tracked = slot != allocBlocksAlloc;
+	// a resized block stays charged to the tag that allocated it
+	ElektraAllocTag blockTag = tracked ? allocBlocks[slot].tag : allocValidTag (tag);
+	size_t freed = tracked ? allocBlocks[slot].size : 0;
+
 	ptr = realloc (*buffer, size);
+	if (ptr && tracked) allocBlockRemove (slot);
+	if (ptr) allocTrack (ptr, size, blockTag, tracked, freed);
+#else
+	ptr = realloc (*buffer, size);
+#endif
 	ELEKTRA_ASSERT (ptr, "Memory (re)allocation failed with size %zu", size);
 	if (ptr == NULL)
 	{
@@ -272,9 +522,22 @@ if ((buffer = elektraMalloc (length)) == 0) {
  * @see elektraCalloc
  */
 void * elektraMalloc (size_t size)
+{
+	return elektraMallocTag (size, ELEKTRA_ALLOC_OTHER);
+}
+
+/**
+ * @brief elektraMalloc() with the allocation attributed to tag
+ *
+ * @see elektraAllocStatsGet()
+ */
+void * elektraMallocTag (size_t size, ElektraAllocTag tag ELEKTRA_UNUSED)
 {
 	ELEKTRA_ASSERT (size, "Size to allocate is zero (implementation defined behavior)");
 	void * ret = malloc (size);
+#ifdef ELEKTRA_ENABLE_ALLOC_ACCOUNTING
+	if (ret) allocTrack (ret, size, allocValidTag (tag), 0, 0);
+#endif
 	ELEKTRA_ASSERT (ret, "Memory allocation failed with size %zu", size);
 	return ret;
 }
@@ -287,9 +550,22 @@ void * elektraMalloc (size_t size)
  * @see elektraMalloc
  */
 void * elektraCalloc (size_t size)
+{
+	return elektraCallocTag (size, ELEKTRA_ALLOC_OTHER);
+}
+
+/**
+ * @brief elektraCalloc() with the allocation attributed to tag
+ *
+ * @see elektraAllocStatsGet()
+ */
+void * elektraCallocTag (size_t size, ElektraAllocTag tag ELEKTRA_UNUSED)
 {
 	ELEKTRA_ASSERT (size, "Size to allocate is zero (implementation defined behavior)");
 	void * ret = calloc (1, size);
+#ifdef ELEKTRA_ENABLE_ALLOC_ACCOUNTING
+	if (ret) allocTrack (ret, size, allocValidTag (tag), 0, 0);
+#endif
 	ELEKTRA_ASSERT (ret, "Memory allocation failed with size %zu", size);
 	return ret;
 }
@@ -305,6 +581,21 @@ void * elektraCalloc (size_t size)
  */
 void elektraFree (void * ptr)
 {
+	elektraFreeTag (ptr, ELEKTRA_ALLOC_OTHER);
+}
+
+/**
+ * @brief elektraFree() with the free attributed to tag
+ *
+ * @see elektraAllocStatsGet()
+ */
+void elektraFreeTag (void * ptr, ElektraAllocTag tag ELEKTRA_UNUSED)
+{
+#ifdef ELEKTRA_ENABLE_ALLOC_ACCOUNTING
+	// the free is charged to the tag that allocated the block, not to tag
+	size_t slot = allocBlockFind (ptr);
+	if (slot != allocBlocksAlloc) allocUntrack (slot);
+#endif
 	free (ptr);
 }
 
@@ -327,6 +618,16 @@ void elektraFree (void * ptr)
  * @see elektraMemDup
  */
 char * elektraStrDup (const char * s)
+{
+	return elektraStrDupTag (s, ELEKTRA_ALLOC_OTHER);
+}
+
+/**
+ * @brief elektraStrDup() with the allocation attributed to tag
+ *
+ * @see elektraAllocStatsGet()
+ */
+char * elektraStrDupTag (const char * s, ElektraAllocTag tag)
 {
 	void * tmp = 0;
 	size_t l = 0;
@@ -334,7 +635,7 @@ char * elektraStrDup (const char * s)
 
 	l = elektraStrLen (s);
 	ELEKTRA_ASSERT (l, "Size of string to duplicate is zero");
-	tmp = elektraMalloc (l);
+	tmp = elektraMallocTag (l, tag);
 	if (tmp) memcpy (tmp, s, l);
 
 	return tmp;
@@ -354,11 +655,21 @@ char * elektraStrDup (const char * s)
  * @ingroup internal
  */
 void * elektraMemDup (const void * s, size_t n)
+{
+	return elektraMemDupTag (s, n, ELEKTRA_ALLOC_OTHER);
+}
+
+/**
+ * @brief elektraMemDup() with the allocation attributed to tag
+ *
+ * @see elektraAllocStatsGet()
+ */
+void * elektraMemDupTag (const void * s, size_t n, ElektraAllocTag tag)
 {
 	void * tmp = 0;
 	ELEKTRA_ASSERT (n, "Size of memory to duplicate is zero");
 
-	tmp = elektraMalloc (n);
+	tmp = elektraMallocTag (n, tag);
 	if (tmp) memcpy (tmp, s, n);
 
 	return tmp;
@@ -132,14 +132,17 @@
  */
 void elektraRemoveMetaData (Key * key, const char * searchfor)
 {
-	const Key * iter_key;
-	keyRewindMeta (key);
-	while ((iter_key = keyNextMeta (key)) != 0)
+	// iterate backwards, so removing a metakey does not move the ones still to be visited;
+	// the metadata is only copied by keySetMeta(), if a metakey is actually removed
+	KeySet * meta = elektraKeyGetMetaKeySet (key);
+	for (elektraCursor it = ksGetSize (meta) - 1; it >= 0; --it)
 	{
+		const Key * iter_key = ksAtCursor (meta, it);
 		/*startsWith*/
 		if (strncmp (searchfor, keyName (iter_key), strlen (searchfor)) == 0)
 		{
 			keySetMeta (key, keyName (iter_key), 0);
+			meta = elektraKeyGetMetaKeySet (key);
 		}
 	}
 }
@@ -915,13 +918,14 @@ static int elektraGetDoUpdateWithGlobalHooks (KDB * handle, Split * split, KeySe
 
 static int copyError (Key * dest, Key * src)
 {
-	keyRewindMeta (src);
 	const Key * metaKey = keyGetMeta (src, "error");
 	if (!metaKey) return 0;
-	keySetMeta (dest, keyName (metaKey), keyString (metaKey));
-	while ((metaKey = keyNextMeta (src)) != NULL)
+
+	KeySet * meta = elektraKeyGetMetaKeySet (src);
+	elektraCursor end;
+	for (elektraCursor it = ksFindHierarchy (meta, metaKey, &end); it < end; ++it)
 	{
-		if (strncmp (keyName (metaKey), "error/", 6)) break;
+		metaKey = ksAtCursor (meta, it);
 		keySetMeta (dest, keyName (metaKey), keyString (metaKey));
 	}
 	return 1;
@@ -1298,6 +1302,7 @@ int kdbGet (KDB * handle, KeySet * ks, Key * parentKey)
 		splitUpdateFileName (split, handle, parentKey);
 		keyDel (initialParent);
 		splitDel (split);
+		elektraKsTrackChanges (ks);
 		errno = errnosave;
 		keyDel (oldError);
 		return 1;
@@ -1360,6 +1365,7 @@ int kdbGet (KDB * handle, KeySet * ks, Key * parentKey)
 		splitUpdateFileName (split, handle, parentKey);
 		keyDel (initialParent);
 		splitDel (split);
+		elektraKsTrackChanges (ks);
 		errno = errnosave;
 		keyDel (oldError);
 		return 0;
@@ -1514,6 +1520,8 @@ cachemiss:
 	keyDel (initialParent);
 	keyDel (oldError);
 	splitDel (split);
+	// from now on kdbSet() only needs to look at the changed keys
+	elektraKsTrackChanges (ks);
 	errno = errnosave;
 	return 1;
 
@@ -1757,6 +1765,8 @@ static void elektraSetRollback (Split * split, Key * parentKey)
  * Each key is checked with keyNeedSync() before being actually committed.
  * If no key of a backend needs to be synced
  * any affairs to backends are omitted and 0 is returned.
+ * After kdbGet() or kdbSet() the changed keys of @p ks are tracked,
+ * so that only the keys of backends with changed keys need to be checked.
  *
  * @snippet kdbset.c set
  *
@@ -1862,7 +1872,8 @@ int kdbSet (KDB * handle, KeySet * ks, Key * parentKey)
 	ELEKTRA_LOG ("after splitBuildup");
 
 	// 1.) Search for syncbits
-	int syncstate = splitDivide (split, handle, ks);
+	// if the changes of ks are tracked, only the backends of changed keys need to be divided
+	int syncstate = ks->changes ? splitDivideChanged (split, handle, ks) : splitDivide (split, handle, ks);
 	if (syncstate == -1)
 	{
 		clearError (parentKey); // clear previous error to set new one
@@ -1936,10 +1947,20 @@ int kdbSet (KDB * handle, KeySet * ks, Key * parentKey)
 	elektraGlobalSet (handle, ks, parentKey, POSTCOMMIT, MAXONCE);
 	elektraGlobalSet (handle, ks, parentKey, POSTCOMMIT, DEINIT);
 
-	for (size_t i = 0; i < ks->size; ++i)
+	if (ks->changes)
+	{
+		// only the logged keys can have a sync flag
+		elektraKsClearChanges (ks);
+	}
+	else
 	{
-		// remove all flags from all keys
-		clear_bit (ks->array[i]->flags, (keyflag_t) KEY_FLAG_SYNC);
+		for (size_t i = 0; i < ks->size; ++i)
+		{
+			// remove all flags from all keys
+			clear_bit (ks->array[i]->flags, (keyflag_t) KEY_FLAG_SYNC);
+		}
+		// the next kdbSet() only needs to look at the keys changed from now on
+		elektraKsTrackChanges (ks);
 	}
 
 	keySetName (parentKey, keyName (initialParent));
@@ -332,7 +332,7 @@ Key * keyCopy (Key * dest, const Key * source, elektraCopyFlags flags)
 		}
 		if (test_bit (flags, KEY_CP_META))
 		{
-			ksClear (dest->meta);
+			keyMetaRelease (dest);
 		}
 		return dest;
 	}
@@ -416,32 +416,26 @@ Key * keyCopy (Key * dest, const Key * source, elektraCopyFlags flags)
 
 	if (test_bit (flags, KEY_CP_META))
 	{
-		if (source->meta != NULL)
-		{
-			dest->meta = ksDup (source->meta);
-			if (!dest->meta) goto memerror;
-		}
-		else
-		{
-			dest->meta = 0;
-		}
+		// the metadata KeySet is shared and only copied once one of the keys modifies it
+		dest->meta = 0;
+		if (keyMetaShare (dest, source->meta) == -1) goto memerror;
 	}
 
 	// successful, now do the irreversible stuff: we obviously modified dest
-	set_bit (dest->flags, KEY_FLAG_SYNC);
+	elektraKeyMarkSync (dest);
 
 	// free old resources of destination
 	if (test_bit (flags, KEY_CP_NAME) && !test_bit (orig.flags, KEY_FLAG_MMAP_KEY)) elektraFree (orig.key);
 	if (test_bit (flags, KEY_CP_NAME) && !test_bit (orig.flags, KEY_FLAG_MMAP_KEY)) elektraFree (orig.ukey);
 	if (test_bit (flags, KEY_CP_VALUE) && !test_bit (orig.flags, KEY_FLAG_MMAP_DATA)) elektraFree (orig.data.c);
-	if (test_bit (flags, KEY_CP_META)) ksDel (orig.meta);
+	if (test_bit (flags, KEY_CP_META)) keyMetaRelease (&orig);
 
 	return dest;
 
 memerror:
 	elektraFree (dest->key);
 	elektraFree (dest->data.v);
-	ksDel (dest->meta);
+	if (dest->meta != orig.meta) keyMetaRelease (dest);
 
 	*dest = orig;
 	return NULL;
@@ -495,7 +489,7 @@ int keyDel (Key * key)
 
 	keyClearNameValue (key);
 
-	ksDel (key->meta);
+	keyMetaRelease (key);
 
 	if (!keyInMmap)
 	{
@@ -548,16 +542,20 @@ int keyClear (Key * key)
 	size_t ref = 0;
 
 	ref = key->refs;
+	KeySet * owner = key->owner;
 
 	int keyStructInMmap = test_bit (key->flags, KEY_FLAG_MMAP_STRUCT);
 
 	keyClearNameValue (key);
 
-	ksDel (key->meta);
+	keyMetaRelease (key);
 
 	keyInit (key);
 	if (keyStructInMmap) key->flags |= KEY_FLAG_MMAP_STRUCT;
 
+	/* the key is still part of the keyset tracking it */
+	key->owner = owner;
+
 	keySetName (key, "/");
 
 	/* Set reference properties */
@@ -123,6 +123,115 @@
 #include <errno.h>
 #endif
 
+/**
+ * @internal
+ *
+ * Releases the metadata of @p key.
+ *
+ * The metadata KeySet is only deleted, if no other Key shares it.
+ *
+ * @post @p key has no metadata
+ */
+void keyMetaRelease (Key * key)
+{
+	if (!key->meta) return;
+
+	ksDecRef (key->meta);
+	ksDel (key->meta);
+	key->meta = 0;
+}
+
+/**
+ * @internal
+ *
+ * Lets @p key share the metadata KeySet @p meta with other keys.
+ *
+ * Metadata KeySets are reference counted by the keys using them
+ * and copied before they are modified (see keyMetaUnshare()).
+ * If the reference counter of @p meta cannot be incremented anymore,
+ * @p key gets a deep copy of @p meta instead. A shallow copy would
+ * share the metadata keys, whose reference counters would overflow
+ * as well for every further copy.
+ *
+ * A KeySet returned by keyMeta() is never shared, @p key gets a
+ * shallow copy of it instead.
+ *
+ * @param key the Key whose previous metadata will be released
+ * @param meta the metadata KeySet of another key or 0
+ *
+ * @retval 0 on success
+ * @retval -1 on memory problems
+ */
+int keyMetaShare (Key * key, KeySet * meta)
+{
+	if (key->meta == meta) return 0;
+
+	if (meta && test_bit (meta->flags, KS_FLAG_META_EXPORTED))
+	{
+		meta = ksDup (meta);
+		if (!meta) return -1;
+		ksIncRef (meta);
+	}
+	else if (meta && ksIncRef (meta) == UINT16_MAX)
+	{
+		meta = ksDeepDup (meta);
+		if (!meta) return -1;
+		ksIncRef (meta);
+	}
+
+	keyMetaRelease (key);
+	key->meta = meta;
+	return 0;
+}
+
+/**
+ * @internal
+ *
+ * Makes sure that @p key has its own metadata KeySet, which can be modified
+ * without affecting other keys. Creates an empty KeySet, if @p key has no metadata.
+ *
+ * @retval 0 on success
+ * @retval -1 on memory problems
+ */
+int keyMetaUnshare (Key * key)
+{
+	if (!key->meta)
+	{
+		key->meta = ksNew (0, KS_END);
+		if (!key->meta) return -1;
+		ksIncRef (key->meta);
+		return 0;
+	}
+
+	if (key->meta->refs <= 1) return 0;
+
+	KeySet * meta = ksDup (key->meta);
+	if (!meta) return -1;
+
+	ksDecRef (key->meta);
+	key->meta = meta;
+	ksIncRef (key->meta);
+	return 0;
+}
+
+/**
+ * @internal
+ *
+ * Returns the metadata KeySet of @p key, which might be shared with other keys.
+ *
+ * In contrast to keyMeta(), the KeySet is neither created nor copied,
+ * so it must not be modified in any way, including its internal cursor.
+ *
+ * @return the metadata KeySet of @p key
+ * @retval 0 if @p key is 0 or has no metadata
+ */
+KeySet * elektraKeyGetMetaKeySet (const Key * key)
+{
+	if (!key) return 0;
+
+	return key->meta;
+}
+
 
 /**
  * Rewind the internal iterator to the first entry in metadata keyset.
@@ -160,6 +269,9 @@ int keyRewindMeta (Key * key)
 	if (!key) return -1;
 	if (!key->meta) return 0;
 
+	// the cursor is part of the metadata KeySet, which might be shared with other keys
+	if (keyMetaUnshare (key) == -1) return -1;
+
 	return ksRewind (key->meta);
 }
 
@@ -200,6 +312,9 @@ const Key * keyNextMeta (Key * key)
 	if (!key) return 0;
 	if (!key->meta) return 0;
 
+	// the cursor is part of the metadata KeySet, which might be shared with other keys
+	if (keyMetaUnshare (key) == -1) return 0;
+
 	ret = ksNext (key->meta);
 
 	return ret;
@@ -313,10 +428,11 @@ int keyCopyMeta (Key * dest, const Key * source, const char * metaName)
 	if (!ret)
 	{
 		/*Make sure that dest also does not have metaName*/
-		if (dest->meta)
+		Key * target = (Key *) keyGetMeta (dest, metaName);
+		if (target)
 		{
 			Key * r;
-			Key * target = (Key *) keyGetMeta (dest, metaName);
+			if (keyMetaUnshare (dest) == -1) return -1;
 			r = ksLookup (dest->meta, target, KDB_O_POP);
 			if (r)
 			{
@@ -327,25 +443,24 @@ int keyCopyMeta (Key * dest, const Key * source, const char * metaName)
 		return 0;
 	}
 
-	/*Lets have a look if the key is already inserted.*/
-	if (dest->meta)
+	if (keyGetMeta (dest, metaName) == ret)
 	{
-		Key * r;
-		r = ksLookup (dest->meta, ret, KDB_O_POP);
-		if (r && r != ret)
-		{
-			/*It was already there, so lets drop that one*/
-			keyDel (r);
-		}
+		/*Already shared, nothing to do*/
+		return 1;
 	}
-	else
+
+	/*Create a new place for meta information or make sure that it is not shared.*/
+	if (keyMetaUnshare (dest) == -1)
 	{
-		/*Create a new place for meta information.*/
-		dest->meta = ksNew (0, KS_END);
-		if (!dest->meta)
-		{
-			return -1;
-		}
+		return -1;
+	}
+
+	/*Lets have a look if the key is already inserted.*/
+	Key * r = ksLookup (dest->meta, ret, KDB_O_POP);
+	if (r && r != ret)
+	{
+		/*It was already there, so lets drop that one*/
+		keyDel (r);
 	}
 
 	// now we can simply append that key
@@ -404,14 +519,15 @@ int keyCopyAllMeta (Key * dest, const Key * source)
 
 	if (ksGetSize (source->meta) > 0)
 	{
-		/*Make sure that dest also does not have metaName*/
-		if (dest->meta)
+		if (ksGetSize (dest->meta) <= 0)
 		{
-			ksAppend (dest->meta, source->meta);
+			// dest has no metadata on its own, so it can simply share the KeySet of source
+			if (keyMetaShare (dest, source->meta) == -1) return -1;
 		}
-		else
+		else if (dest->meta != source->meta)
 		{
-			dest->meta = ksDup (source->meta);
+			if (keyMetaUnshare (dest) == -1) return -1;
+			ksAppend (dest->meta, source->meta);
 		}
 		return 1;
 	}
@@ -470,7 +586,9 @@ const Key * keyGetMeta (const Key * key, const char * metaName)
 		keyAddName (search, metaName);
 	}
 
-	ret = ksLookup (key->meta, search, 0);
+	// unlike ksLookup(), ksSearch() does not move the cursor of the possibly shared KeySet
+	ssize_t pos = ksSearch (key->meta, search);
+	ret = pos < 0 ? 0 : ksAtCursor (key->meta, pos);
 
 	keyDel (search);
 
@@ -546,12 +664,23 @@ ssize_t keySetMeta (Key * key, const char * metaName, const char * newMetaString
 	if (key->meta)
 	{
 		Key * ret;
+		if (!newMetaString && ksSearch (key->meta, toSet) < 0)
+		{
+			/*Nothing to remove*/
+			keyDel (toSet);
+			return 0;
+		}
+		if (keyMetaUnshare (key) == -1)
+		{
+			keyDel (toSet);
+			return -1;
+		}
 		ret = ksLookup (key->meta, toSet, KDB_O_POP);
 		if (ret)
 		{
 			/*It was already there, so lets drop that one*/
 			keyDel (ret);
-			key->flags |= KEY_FLAG_SYNC;
+			elektraKeyMarkSync (key);
 		}
 	}
 
@@ -583,8 +712,7 @@ ssize_t keySetMeta (Key * key, const char * metaName, const char * newMetaString
 	if (!key->meta)
 	{
 		/*Create a new place for meta information.*/
-		key->meta = ksNew (0, KS_END);
-		if (!key->meta)
+		if (keyMetaUnshare (key) == -1)
 		{
 			keyDel (toSet);
 			return -1;
@@ -596,7 +724,7 @@ ssize_t keySetMeta (Key * key, const char * metaName, const char * newMetaString
 	set_bit (toSet->flags, KEY_FLAG_RO_META);
 
 	ksAppendKey (key->meta, toSet);
-	key->flags |= KEY_FLAG_SYNC;
+	elektraKeyMarkSync (key);
 	return metaStringSize;
 }
 
@@ -617,6 +745,10 @@ ssize_t keySetMeta (Key * key, const char * metaName, const char * newMetaString
  *
  * @note You are not allowed to modify the name of KeySet's Keys or delete them.
  * @note You must not delete the returned KeySet.
+ * @note Keys might share their metadata KeySet (e.g. after keyDup() or keyCopyAllMeta()).
+ *       keyMeta() always returns a KeySet only used by @p key, so it copies a shared KeySet first.
+ *       The returned KeySet is also never shared later on, keyDup() and keyCopyAllMeta()
+ *       copy it instead.
  * @note Adding a key with metadata to the KeySet is an error.
  *
  * @post for the returned KeySet ks: keyGetMeta(key, metaName) ==
@@ -637,7 +769,8 @@ ssize_t keySetMeta (Key * key, const char * metaName, const char * newMetaString
 KeySet * keyMeta (Key * key)
 {
 	if (!key) return 0;
-	if (!key->meta) key->meta = ksNew (0, KS_END);
+	if (keyMetaUnshare (key) == -1) return 0;
 
+	set_bit (key->meta->flags, KS_FLAG_META_EXPORTED);
 	return key->meta;
 }
@@ -522,7 +522,7 @@ ssize_t keySetName (Key * key, const char * newName)
 
 	elektraKeyNameUnescape (key->key, key->ukey);
 
-	set_bit (key->flags, KEY_FLAG_SYNC);
+	elektraKeyMarkSync (key);
 
 	return key->keySize;
 }
@@ -610,7 +610,7 @@ ssize_t keyAddName (Key * key, const char * newName)
 
 	elektraKeyNameUnescape (key->key, key->ukey);
 
-	set_bit (key->flags, KEY_FLAG_SYNC);
+	elektraKeyMarkSync (key);
 	return key->keySize;
 }
 
@@ -1540,7 +1540,7 @@ static size_t keyAddBaseNameInternal (Key * key, const char * baseName)
 	key->keyUSize += unescapedSize;
 	key->ukey[key->keyUSize - 1] = '\0';
 
-	set_bit (key->flags, KEY_FLAG_SYNC);
+	elektraKeyMarkSync (key);
 	return key->keySize;
 }
 
@@ -103,6 +103,86 @@ static void elektraOpmphmCopy (KeySet * dest ELEKTRA_UNUSED, const KeySet * sour
 #endif
 }
 
+static ssize_t ksSearchInternal (const KeySet * ks, const Key * toAppend);
+
+/**
+ * @internal
+ *
+ * @brief Stops tracking the changes of a KeySet.
+ *
+ * Afterwards kdbSet() has to check every Key of the KeySet for
+ * the sync flag again.
+ *
+ * @param ks the KeySet
+ */
+static void ksStopTracking (KeySet * ks)
+{
+	if (!ks->changes) return;
+	ksDel (ks->changes);
+	ks->changes = 0;
+}
+
+/**
+ * @internal
+ *
+ * @brief Logs the name of a changed Key in a KeySet that tracks its changes.
+ *
+ * @param ks the KeySet tracking the changes
+ * @param key the changed Key
+ */
+static void ksLogChange (KeySet * ks, const Key * key)
+{
+	if (ksSearchInternal (ks->changes, key) >= 0) return;
+
+	Key * name = keyDup (key, KEY_CP_NAME);
+	if (!name || ksAppendKey (ks->changes, name) == -1)
+	{
+		// the log is incomplete, only checking every Key is safe now
+		ksStopTracking (ks);
+	}
+}
+
+/**
+ * @internal
+ *
+ * @brief Takes the ownership of a Key in a KeySet that tracks its changes.
+ *
+ * The name of the Key is logged if it needs sync. If the Key is already
+ * owned by another KeySet, its changes would not be reported to @p ks,
+ * so @p ks stops tracking its changes.
+ *
+ * @param ks the KeySet tracking the changes
+ * @param key the inserted Key
+ */
+static void ksTrackKey (KeySet * ks, Key * key)
+{
+	if (key->owner != ks)
+	{
+		if (key->owner)
+		{
+			ksStopTracking (ks);
+			return;
+		}
+		key->owner = ks;
+	}
+	if (test_bit (key->flags, KEY_FLAG_SYNC)) ksLogChange (ks, key);
+}
+
+/**
+ * @internal
+ *
+ * @brief Drops the ownership of a Key removed from a KeySet.
+ *
+ * Must be invoked by every function that removes a Key from a KeySet.
+ *
+ * @param ks the KeySet
+ * @param key the removed Key
+ */
+static void ksUntrackKey (KeySet * ks, Key * key)
+{
+	if (key->owner == ks) key->owner = 0;
+}
+
 /** @class doxygenFlatCopy
  *
  * @brief .
@@ -930,6 +1010,7 @@ ssize_t ksAppendKey (KeySet * ks, Key * toAppend)
 		}
 
 		/* Pop the key in the result */
+		ksUntrackKey (ks, ks->array[result]);
 		keyDecRef (ks->array[result]);
 		keyDel (ks->array[result]);
 
@@ -937,6 +1018,7 @@ ssize_t ksAppendKey (KeySet * ks, Key * toAppend)
 		keyIncRef (toAppend);
 		ks->array[result] = toAppend;
 		ksSetCursor (ks, result);
+		if (ks->changes) ksTrackKey (ks, toAppend);
 	}
 	else
 	{
@@ -987,6 +1069,7 @@ ssize_t ksAppendKey (KeySet * ks, Key * toAppend)
 			ksSetCursor (ks, insertpos);
 		}
 		elektraOpmphmInvalidate (ks);
+		if (ks->changes) ksTrackKey (ks, toAppend);
 	}
 
 	return ks->size;
@@ -1035,14 +1118,151 @@ ssize_t ksAppend (KeySet * ks, const KeySet * toAppend)
 		;
 	ksResize (ks, toAlloc - 1);
 
-	/* TODO: here is lots of room for optimizations */
-	for (size_t i = 0; i < toAppend->size; ++i)
+	ksAppendRange (ks, toAppend, 0, toAppend->size);
+	return ks->size;
+}
+
+/**
+ * @internal
+ *
+ * Appends the Keys of @p source from position @p start up to (excluding)
+ * position @p end to @p ks.
+ *
+ * If all these Keys are sorted after the last Key of @p ks, e.g. when
+ * a sorted KeySet is divided into contiguous ranges, they are copied
+ * with a single memcpy(). Otherwise they are appended one by one with
+ * ksAppendKey().
+ *
+ * @param ks the KeySet that will receive the Keys
+ * @param source the KeySet that provides the Keys
+ * @param start the position of the first Key to append
+ * @param end the position after the last Key to append
+ *
+ * @return the size of the KeySet @p ks after transfer
+ * @retval -1 on NULL pointers, an invalid range or allocation problems
+ */
+ssize_t ksAppendRange (KeySet * ks, const KeySet * source, elektraCursor start, elektraCursor end)
+{
+	if (!ks || !source) return -1;
+	if (start < 0 || end < start || (size_t) end > source->size) return -1;
+	if (start == end) return ks->size;
+
+	if (ks->size > 0 && keyCompareByName (&ks->array[ks->size - 1], &source->array[start]) >= 0)
+	{
+		for (elektraCursor it = start; it < end; ++it)
+		{
+			if (ksAppendKey (ks, source->array[it]) == -1) return -1;
+		}
+		return ks->size;
+	}
+
+	size_t count = end - start;
+	if (ks->size + count >= ks->alloc)
 	{
-		ksAppendKey (ks, toAppend->array[i]);
+		size_t toAlloc = ks->alloc == 0 ? KEYSET_SIZE : ks->alloc;
+		for (; ks->size + count >= toAlloc; toAlloc *= 2)
+			;
+		if (ksResize (ks, toAlloc - 1) == -1) return -1;
 	}
+
+	for (elektraCursor it = start; it < end; ++it)
+	{
+		keyLock (source->array[it], KEY_LOCK_NAME);
+		keyIncRef (source->array[it]);
+		if (ks->changes) ksTrackKey (ks, source->array[it]);
+	}
+	elektraMemcpy (ks->array + ks->size, source->array + start, count);
+	ks->size += count;
+	ks->array[ks->size] = 0;
+	ksSetCursor (ks, ks->size - 1);
+	elektraOpmphmInvalidate (ks);
+
 	return ks->size;
 }
 
+/**
+ * @internal
+ *
+ * @brief Sets the sync flag of a Key, see keyNeedSync().
+ *
+ * Every function that changes a Key must use it instead of setting
+ * KEY_FLAG_SYNC directly, so that a KeySet tracking the changes of
+ * the Key logs its name.
+ *
+ * @param key the changed Key
+ */
+void elektraKeyMarkSync (Key * key)
+{
+	if (!test_bit (key->flags, KEY_FLAG_SYNC) && key->owner && key->owner->changes)
+	{
+		ksLogChange (key->owner, key);
+	}
+	set_bit (key->flags, KEY_FLAG_SYNC);
+}
+
+/**
+ * @internal
+ *
+ * @brief Starts to track which Keys of a KeySet change.
+ *
+ * Afterwards the names of all Keys of @p ks that need sync (see keyNeedSync())
+ * are logged in `ks->changes`, including Keys that get changed or inserted later.
+ * So kdbSet() only needs to divide the Keys of the backends with logged
+ * names, instead of checking every single Key.
+ *
+ * Every Key can only be tracked by one KeySet. If a Key of @p ks
+ * is tracked by another KeySet, or if such a Key gets inserted
+ * later, the changes of @p ks are not tracked. Tracking also stops,
+ * when all Keys are removed from @p ks (e.g. with ksClear()).
+ *
+ * @param ks the KeySet whose changes should be tracked
+ *
+ * @retval 1 if the changes of @p ks are tracked
+ * @retval 0 if the changes of @p ks cannot be tracked
+ * @retval -1 on NULL pointer
+ */
+int elektraKsTrackChanges (KeySet * ks)
+{
+	if (!ks) return -1;
+	if (ks->changes) return 1;
+
+	ks->changes = ksNew (0, KS_END);
+	if (!ks->changes) return 0;
+	set_bit (ks->flags, KS_FLAG_OWNER);
+
+	for (size_t it = 0; it < ks->size && ks->changes; ++it)
+	{
+		ksTrackKey (ks, ks->array[it]);
+	}
+
+	return ks->changes != 0;
+}
+
+/**
+ * @internal
+ *
+ * @brief Clears the sync flag of all changed Keys of a KeySet.
+ *
+ * Because every Key that needs sync is logged, this is the same as calling
+ * keyClearSync() on every Key of @p ks, but it only touches the changed Keys.
+ * Afterwards the log is empty.
+ *
+ * @pre the changes of @p ks are tracked, see elektraKsTrackChanges()
+ *
+ * @param ks the KeySet whose changes were synced
+ */
+void elektraKsClearChanges (KeySet * ks)
+{
+	if (!ks || !ks->changes) return;
+
+	for (size_t it = 0; it < ks->changes->size; ++it)
+	{
+		ssize_t found = ksSearchInternal (ks, ks->changes->array[it]);
+		if (found >= 0) keyClearSync (ks->array[found]);
+	}
+	ksClear (ks->changes);
+}
+
 /**
  * The core rename loop of ksRename()
  */
@@ -1059,6 +1279,7 @@ static size_t ksRenameInternal (KeySet * ks, size_t start, size_t end, const Key
 		{
 			// key has other references -> dup in-place so we can safely rename it
 			Key * dup = keyDup (ks->array[it], KEY_CP_ALL);
+			ksUntrackKey (ks, ks->array[it]);
 			keyDecRef (ks->array[it]);
 			dup->refs = 1;
 			ks->array[it] = dup;
@@ -1066,6 +1287,8 @@ static size_t ksRenameInternal (KeySet * ks, size_t start, size_t end, const Key
 		keyReplacePrefix (ks->array[it], root, newRoot);
 		// lock key with new name
 		set_bit (ks->array[it]->flags, KEY_FLAG_RO_NAME);
+		// the new name needs to be logged, even if the key was already changed before
+		if (ks->changes) ksTrackKey (ks, ks->array[it]);
 	}
 	return end - start;
 }
@@ -1162,6 +1385,191 @@ ssize_t ksRename (KeySet * ks, const Key * root, const Key * newRoot)
 	return renamed;
 }
 
+/**
+ * @internal
+ *
+ * A key renamed by ksRenameEach() together with its original position.
+ */
+struct _RenamedKey
+{
+	Key * key;
+	size_t position;
+};
+
+static int renamedKeyCompare (const void * p1, const void * p2)
+{
+	const struct _RenamedKey * r1 = p1;
+	const struct _RenamedKey * r2 = p2;
+
+	int cmp = keyCompareByName (&r1->key, &r2->key);
+	if (cmp != 0) return cmp;
+
+	return r1->position < r2->position ? -1 : r1->position > r2->position;
+}
+
+/**
+ * Renames (or removes) all keys between @p start and @p end in a single pass
+ *
+ * @p rename is called once for every key in the range. It may change
+ * the name of the given key in-place (e.g. with keySetName() or keyAddName()),
+ * as well as its value and metadata. The order of @p ks is restored once,
+ * after all keys have been processed.
+ *
+ * This is much faster than popping every key (e.g. with ksLookup() and
+ * #KDB_O_POP) and appending a renamed copy with ksAppendKey(), because
+ * both of these operations have to move all keys behind the affected key.
+ *
+ * Keys that are only referenced by @p ks are modified directly.
+ * Keys with other references (see keyGetRef()) are replaced by
+ * a copy before @p rename is called, even if @p rename doesn't
+ * change them.
+ *
+ * If a renamed key has the same name as another key in @p ks,
+ * the renamed key replaces the other key, like ksAppendKey() would.
+ * If multiple keys are renamed to the same name, the key that came
+ * last in @p ks is kept.
+ *
+ * @param ks     the keyset to manipulate
+ * @param start  the first key passed to @p rename
+ * @param end    the key after the last key passed to @p rename
+ * @param rename called for every key, must return
+ *               1 if the name of the key was changed,
+ *               0 if the name of the key was not changed and
+ *               -1 if the key shall be removed from @p ks
+ * @param data   passed to @p rename unchanged
+ *
+ * @retval -1 if @p ks or @p rename is NULL, or @p start and @p end are not a valid range of @p ks
+ * @retval -1 on memory allocation errors, @p ks is unchanged then
+ * @returns   otherwise, the number of renamed and removed keys
+ *
+ * @see ksRename() for moving all keys below a common root
+ * @see ksFindHierarchy() to find the range of keys below a common root
+ */
+ssize_t ksRenameEach (KeySet * ks, elektraCursor start, elektraCursor end, ksRenameEachPtr rename, void * data)
+{
+	if (ks == NULL || rename == NULL) return -1;
+	if (start < 0 || end < start || (size_t) end > ks->size) return -1;
+	if (start == end) return 0;
+
+	struct _RenamedKey * renamed = elektraMalloc ((end - start) * sizeof (struct _RenamedKey));
+	if (renamed == NULL) return -1;
+	size_t renamedSize = 0;
+	size_t changed = 0;
+
+	// keep unchanged keys (they are still sorted) and collect renamed keys
+	size_t kept = start;
+	for (size_t it = start; it < (size_t) end; ++it)
+	{
+		Key * key = ks->array[it];
+		if (key->refs > 1)
+		{
+			// key has other references -> dup, so we can safely modify it
+			Key * dup = keyDup (key, KEY_CP_ALL);
+			ksUntrackKey (ks, key);
+			keyDecRef (key);
+			keyIncRef (dup);
+			key = dup;
+		}
+
+		clear_bit (key->flags, KEY_FLAG_RO_NAME);
+		int result = rename (key, data);
+		set_bit (key->flags, KEY_FLAG_RO_NAME);
+
+		if (result < 0)
+		{
+			ksUntrackKey (ks, key);
+			keyDecRef (key);
+			keyDel (key);
+			++changed;
+			continue;
+		}
+
+		// the new name needs to be logged, even if the key was already changed before
+		if (ks->changes) ksTrackKey (ks, key);
+
+		if (result > 0)
+		{
+			renamed[renamedSize].key = key;
+			renamed[renamedSize].position = it;
+			++renamedSize;
+			++changed;
+		}
+		else
+		{
+			ks->array[kept++] = key;
+		}
+	}
+
+	if (kept < (size_t) end)
+	{
+		elektraMemmove (ks->array + kept, ks->array + end, ks->size - end);
+	}
+	size_t keptSize = kept + ks->size - end;
+
+	// sort renamed keys and remove duplicates, the last renamed key wins
+	qsort (renamed, renamedSize, sizeof (struct _RenamedKey), renamedKeyCompare);
+	size_t uniqueSize = 0;
+	for (size_t it = 0; it < renamedSize; ++it)
+	{
+		if (it + 1 < renamedSize && keyCompareByName (&renamed[it].key, &renamed[it + 1].key) == 0)
+		{
+			ksUntrackKey (ks, renamed[it].key);
+			keyDecRef (renamed[it].key);
+			keyDel (renamed[it].key);
+			continue;
+		}
+		renamed[uniqueSize++] = renamed[it];
+	}
+
+	// merge renamed keys into the kept keys, starting at the back
+	size_t read = keptSize;
+	size_t write = keptSize + uniqueSize;
+	size_t remaining = uniqueSize;
+	while (remaining > 0)
+	{
+		if (read > 0)
+		{
+			int cmp = keyCompareByName (&ks->array[read - 1], &renamed[remaining - 1].key);
+			if (cmp > 0)
+			{
+				ks->array[--write] = ks->array[--read];
+				continue;
+			}
+
+			if (cmp == 0)
+			{
+				// renamed key replaces existing key
+				--read;
+				ksUntrackKey (ks, ks->array[read]);
+				keyDecRef (ks->array[read]);
+				keyDel (ks->array[read]);
+			}
+		}
+		ks->array[--write] = renamed[--remaining].key;
+	}
+
+	// close the gap left by replaced keys
+	size_t newSize = keptSize + uniqueSize;
+	if (write > read)
+	{
+		elektraMemmove (ks->array + read, ks->array + write, newSize - write);
+		newSize -= write - read;
+	}
+
+	ks->size = newSize;
+	ks->array[ks->size] = 0;
+	elektraFree (renamed);
+
+	if (changed > 0)
+	{
+		ks->flags |= KS_FLAG_SYNC;
+		elektraOpmphmInvalidate (ks);
+		ksRewind (ks);
+	}
+
+	return changed;
+}
+
 /**
  * @internal
  *
@@ -1245,30 +1653,153 @@ elektraCursor ksFindHierarchy (const KeySet * ks, const Key * root, elektraCurso
 
 	if (end != NULL)
 	{
-		if (root->keyUSize == 3)
+		// All keys below root start with the unescaped name of root
+		// (for namespace roots only with the namespace byte and the
+		// separator), so they form a contiguous range starting at it.
+		// root is not modified for the search, because it may be part of ks.
+		size_t prefixSize = root->keyUSize == 3 ? 2 : root->keyUSize;
+		size_t left = it + 1;
+		size_t right = ks->size;
+		while (left < right)
 		{
-
-			// special handling for root keys
-			// we just increment the namespace byte and search
-			// for the next theoretically possible namespace
-			root->ukey[0]++;
-			ssize_t endSearch = ksSearchInternal (ks, root);
-			root->ukey[0]--;
-			*end = endSearch < 0 ? -endSearch - 1 : endSearch;
+			size_t middle = left + (right - left) / 2;
+			const Key * cur = ks->array[middle];
+			if (cur->keyUSize >= prefixSize && memcmp (cur->ukey, root->ukey, prefixSize) == 0)
+			{
+				left = middle + 1;
+			}
+			else
+			{
+				right = middle;
+			}
 		}
-		else
+		*end = left;
+	}
+
+	return it;
+}
+
+/**
+ * Searches for the range of keys at and below @p root in @p ks.
+ *
+ * The range is found with two binary searches, without copying or cutting @p ks:
+ *
+ * @code{.c}
+ * elektraCursor end;
+ * for (elektraCursor it = ksFindBelow (ks, root, &end); it < end; ++it)
+ * {
+ * 	Key * cur = ksAtCursor (ks, it);
+ * }
+ * @endcode
+ *
+ * This is the public version of ksFindHierarchy(), with the same parameters and results.
+ *
+ * @param ks   The keyset to search in
+ * @param root The root of the hierarchy to find
+ * @param end  If this is not NULL, it will be set to the position of the first
+ *             key after the hierarchy, or to the size of @p ks if there is none.
+ *
+ * @retval -1 if @p ks or @p root are NULL
+ * @return the position of either @p root itself or the first key below
+ *         @p root that is part of @p ks. If no keys below @p root exist
+ *         in @p ks, the size of @p ks is returned.
+ *
+ * @since 1.0.0
+ * @see ksFindNextChild() to find only the direct children of @p root
+ */
+elektraCursor ksFindBelow (const KeySet * ks, const Key * root, elektraCursor * end)
+{
+	return ksFindHierarchy (ks, root, end);
+}
+
+/**
+ * @retval 1 if @p key is below @p root and in the same namespace
+ * @retval 0 otherwise
+ *
+ * @param rootSize the number of bytes of the unescaped name of @p root
+ *                 that have to match, see ksFindNextChild()
+ */
+static int elektraKsIsBelowRoot (const Key * root, size_t rootSize, const Key * key)
+{
+	return key->keyUSize > rootSize && memcmp (key->ukey, root->ukey, rootSize) == 0;
+}
+
+/**
+ * Searches for the next direct child of @p root in @p ks.
+ *
+ * The keys below a child are skipped with a binary search, so enumerating
+ * the c direct children of @p root takes O(c * log n) instead of visiting
+ * every key below @p root:
+ *
+ * @code{.c}
+ * for (elektraCursor it = ksFindNextChild (ks, root, -1); it < ksGetSize (ks); it = ksFindNextChild (ks, root, it))
+ * {
+ * 	Key * cur = ksAtCursor (ks, it);
+ * }
+ * @endcode
+ *
+ * The key at the returned position is the child itself, if the child is
+ * part of @p ks. Otherwise it is the first key below the child.
+ * Use keyIsDirectlyBelow() to distinguish these cases.
+ *
+ * Like ksFindHierarchy(), only keys in the namespace of @p root are considered.
+ *
+ * @param ks   The keyset to search in
+ * @param root The key whose direct children should be found
+ * @param pos  A position returned by the previous call with the same @p root,
+ *             or a negative value to find the first child
+ *
+ * @retval -1 if @p ks or @p root are NULL
+ * @return the position of the first key of the next direct child of @p root.
+ *         If there are no more children, the size of @p ks is returned.
+ *
+ * @see ksFindHierarchy() to find the range of all keys below @p root
+ */
+elektraCursor ksFindNextChild (const KeySet * ks, const Key * root, elektraCursor pos)
+{
+	if (ks == NULL || root == NULL) return -1;
+
+	// for root keys only the namespace has to match
+	size_t rootSize = root->keyUSize == 3 ? 2 : root->keyUSize;
+
+	size_t it;
+	if (pos < 0)
+	{
+		ssize_t search = ksSearchInternal (ks, root);
+		// root itself is not one of its children
+		it = search < 0 ? -search - 1 : search + 1;
+	}
+	else if ((size_t) pos < ks->size && elektraKsIsBelowRoot (root, rootSize, ks->array[pos]))
+	{
+		// the name of the child consists of the name of root and the next part of the current key,
+		// all keys of its hierarchy start with this name and are contiguous
+		const Key * cur = ks->array[pos];
+		const char * partEnd = memchr (cur->ukey + rootSize, '\0', cur->keyUSize - rootSize);
+		size_t childSize = partEnd - cur->ukey + 1;
+
+		size_t left = pos + 1;
+		size_t right = ks->size;
+		while (left < right)
 		{
-			// Very much a HACK to avoid allocating a new key name
-			// Overwriting the null terminator works fine, because
-			// all accesses to root->ukey inside of ksSearchInternal()
-			// use root->keyUSize explicitly.
-			root->ukey[root->keyUSize - 1] = '\1';
-			ssize_t endSearch = ksSearchInternal (ks, root);
-			root->ukey[root->keyUSize - 1] = '\0';
-			*end = endSearch < 0 ? -endSearch - 1 : endSearch;
+			size_t mid = left + (right - left) / 2;
+			const Key * k = ks->array[mid];
+			if (k->keyUSize >= childSize && memcmp (k->ukey, cur->ukey, childSize) == 0)
+			{
+				left = mid + 1;
+			}
+			else
+			{
+				right = mid;
+			}
 		}
+		it = left;
+	}
+	else
+	{
+		return ks->size;
 	}
 
+	if (it >= ks->size || !elektraKsIsBelowRoot (root, rootSize, ks->array[it])) return ks->size;
 	return it;
 }
 
@@ -1300,7 +1831,16 @@ static int elektraKsFindCutpoint (KeySet * ks, const Key * cutpoint, size_t * fr
 	// we found the cutpoint
 	size_t found = it;
 
-	// search the end of the keyset to cut
+	// search the end of the keyset to cut, within a namespace the keys
+	// below the cutpoint are contiguous, so we can bisect them
+	if (keyGetNamespace (cutpoint) == keyGetNamespace (ks->array[it]) && keyIsBelowOrSame (cutpoint, ks->array[it]) == 1)
+	{
+		elektraCursor end;
+		ksFindHierarchy (ks, cutpoint, &end);
+		it = end;
+	}
+
+	// cascading cutpoints may also match keys of other namespaces
 	while (it < ks->size && keyIsBelowOrSame (cutpoint, ks->array[it]) == 1)
 	{
 		++it;
@@ -1465,6 +2005,13 @@ KeySet * ksCut (KeySet * ks, const Key * cutpoint)
 	elektraMemcpy (returned->array, ks->array + found, newsize);
 	returned->size = newsize;
 	if (returned->size > 0) returned->array[returned->size] = 0;
+	if (test_bit (ks->flags, KS_FLAG_OWNER))
+	{
+		for (size_t i = 0; i < newsize; ++i)
+		{
+			ksUntrackKey (ks, returned->array[i]);
+		}
+	}
 
 	ksCopyInternal (ks, found, it);
 
@@ -1536,6 +2083,7 @@ Key * ksPop (KeySet * ks)
 	if (ks->size + 1 < ks->alloc / 2) ksResize (ks, ks->alloc / 2 - 1);
 	ret = ks->array[ks->size];
 	ks->array[ks->size] = 0;
+	ksUntrackKey (ks, ret);
 	keyDecRef (ret);
 
 	return ret;
@@ -1881,22 +2429,22 @@ int ksSetCursor (KeySet * ks, elektraCursor cursor)
 static void elektraCopyCallbackMeta (Key * dest, Key * source)
 {
 	// possible optimization: only copy when callback is present (keyIsBinary && keyGetValueSize == sizeof(void(int))
-	const Key * m = 0;
-
-	keyRewindMeta (dest);
-	while ((m = keyNextMeta (dest)))
+	// keyRewindMeta() would copy shared metadata, even if there are no callbacks
+	KeySet * meta = elektraKeyGetMetaKeySet (dest);
+	for (elektraCursor it = ksGetSize (meta) - 1; it >= 0; --it)
 	{
-		const char * metaname = keyName (m);
+		const char * metaname = keyName (ksAtCursor (meta, it));
 		if (!strncmp (metaname, "callback/", sizeof ("callback")))
 		{
 			keySetMeta (dest, metaname, 0);
+			meta = elektraKeyGetMetaKeySet (dest);
 		}
 	}
 
-	keyRewindMeta (source);
-	while ((m = keyNextMeta (source)))
+	meta = elektraKeyGetMetaKeySet (source);
+	for (elektraCursor it = 0; it < ksGetSize (meta); ++it)
 	{
-		const char * metaname = keyName (m);
+		const char * metaname = keyName (ksAtCursor (meta, it));
 		if (!strncmp (metaname, "callback/", sizeof ("callback")))
 		{
 			keyCopyMeta (dest, source, metaname);
@@ -2754,6 +3302,7 @@ int ksInit (KeySet * ks)
 	ks->flags = 0;
 	ks->refs = 0;
 	ks->cursor = 0;
+	ks->changes = 0;
 
 	ksRewind (ks);
 
@@ -2788,14 +3337,18 @@ int ksClose (KeySet * ks)
 {
 	if (ks == NULL) return -1;
 
+	ksStopTracking (ks);
+
 	if (ks->array)
 	{
 		for (size_t i = 0; i < ks->size; i++)
 		{
+			ksUntrackKey (ks, ks->array[i]);
 			keyDecRef (ks->array[i]);
 			keyDel (ks->array[i]);
 		}
 	}
+	clear_bit (ks->flags, (keyflag_t) KS_FLAG_OWNER);
 	if (ks->array && !test_bit (ks->flags, KS_FLAG_MMAP_ARRAY))
 	{
 		elektraFree (ks->array);
@@ -565,7 +565,7 @@ ssize_t keySetRaw (Key * key, const void * newBinary, size_t dataSize)
 			clear_bit (key->flags, (keyflag_t) KEY_FLAG_MMAP_DATA);
 		}
 		key->dataSize = 0;
-		set_bit (key->flags, KEY_FLAG_SYNC);
+		elektraKeyMarkSync (key);
 		if (keyIsBinary (key)) return 0;
 		return 1;
 	}
@@ -605,6 +605,6 @@ ssize_t keySetRaw (Key * key, const void * newBinary, size_t dataSize)
 		memcpy (key->data.v, newBinary, key->dataSize);
 	}
 
-	set_bit (key->flags, KEY_FLAG_SYNC);
+	elektraKeyMarkSync (key);
 	return keyGetValueSize (key);
 }
@@ -352,9 +352,94 @@ int splitBuildup (Split * split, KDB * kdb, Key * parentKey)
 }
 
 
+static int splitCompareMountpoints (const void * p1, const void * p2)
+{
+	return keyCmp (*(const Key **) p1, *(const Key **) p2);
+}
+
+/**
+ * @brief Find the end of the range of keys that belong to the same backend
+ *
+ * The keys at or below a mountpoint are contiguous in @p ks, only interrupted
+ * by the hierarchies of mountpoints below it. So the range ends either at the
+ * end of the hierarchy of the mountpoint of @p start or at the next mountpoint.
+ * Keys without a mountpoint (e.g. in namespaces without mountpoints) belong to
+ * the same backend up to the end of their namespace or the next mountpoint.
+ *
+ * @param handle the handle with all mountpoints
+ * @param mountpoints all mountpoints of @p handle sorted like keys
+ * @param ks the keyset to divide
+ * @param start the first key of the range
+ * @param backend the backend responsible for the key at @p start
+ *
+ * @return the position after the last key of the range
+ */
+static elektraCursor splitFindRangeEnd (KDB * handle, Key ** mountpoints, KeySet * ks, elektraCursor start, Backend * backend)
+{
+	Key * curKey = ksAtCursor (ks, start);
+
+	Key * mountpoint = 0;
+	for (size_t i = 0; i < handle->split->size; ++i)
+	{
+		Key * parent = handle->split->parents[i];
+		if (handle->split->handles[i] != backend || keyGetNamespace (parent) != keyGetNamespace (curKey) ||
+		    keyIsBelowOrSame (parent, curKey) != 1)
+		{
+			continue;
+		}
+		if (!mountpoint || parent->keyUSize > mountpoint->keyUSize) mountpoint = parent;
+	}
+
+	elektraCursor end;
+	if (mountpoint)
+	{
+		ksFindHierarchy (ks, mountpoint, &end);
+	}
+	else
+	{
+		// the root of the namespace of the key
+		Key * root = keyNew ("/", KEY_END);
+		if (!root || keySetNamespace (root, keyGetNamespace (curKey)) < 0)
+		{
+			keyDel (root);
+			return start + 1;
+		}
+		ksFindHierarchy (ks, root, &end);
+		keyDel (root);
+	}
+
+	size_t low = 0;
+	size_t high = handle->split->size;
+	while (low < high)
+	{
+		size_t mid = low + (high - low) / 2;
+		if (keyCmp (mountpoints[mid], curKey) <= 0)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	if (low < handle->split->size)
+	{
+		ssize_t next = ksSearch (ks, mountpoints[low]);
+		if (next < 0) next = -next - 1;
+		if (next < end) end = next;
+	}
+
+	return end;
+}
+
 /**
  * Splits up the keysets and search for a sync bit in every key.
  *
+ * Because the keys of a backend are contiguous in the sorted keyset,
+ * the backend is only looked up once per range of keys and every
+ * range is appended in one go.
+ *
  * It does not check if there were removed keys,
  * see splitSync() for the next step.
  *
@@ -375,36 +460,208 @@ int splitBuildup (Split * split, KDB * kdb, Key * parentKey)
 int splitDivide (Split * split, KDB * handle, KeySet * ks)
 {
 	int needsSync = 0;
-	Key * curKey = 0;
 
-	ksRewind (ks);
-	while ((curKey = ksNext (ks)) != 0)
+	Key ** mountpoints = elektraMalloc ((handle->split->size + 1) * sizeof (Key *));
+	if (!mountpoints) return -1;
+	memcpy (mountpoints, handle->split->parents, handle->split->size * sizeof (Key *));
+	qsort (mountpoints, handle->split->size, sizeof (Key *), splitCompareMountpoints);
+
+	elektraCursor size = ksGetSize (ks);
+	for (elektraCursor it = 0; it < size;)
 	{
+		Key * curKey = ksAtCursor (ks, it);
+
 		// TODO: handle keys in wrong namespaces
 		Backend * curHandle = mountGetBackend (handle, keyName (curKey));
-		if (!curHandle) return -1;
+		if (!curHandle)
+		{
+			elektraFree (mountpoints);
+			return -1;
+		}
+
+		elektraCursor end = splitFindRangeEnd (handle, mountpoints, ks, it, curHandle);
 
 		/* If key could be appended to any of the existing split keysets */
 		ssize_t curFound = splitSearchBackend (split, curHandle, curKey);
 
 		if (curFound == -1)
 		{
-			ELEKTRA_LOG_DEBUG ("SKIPPING NOT RELEVANT KEY: %p key: %s, string: %s", (void *) curKey, keyName (curKey),
-					   keyString (curKey));
-			continue; // key not relevant in this kdbSet
+			ELEKTRA_LOG_DEBUG ("SKIPPING NOT RELEVANT KEYS: %p key: %s, string: %s and %zd more", (void *) curKey,
+					   keyName (curKey), keyString (curKey), (ssize_t) (end - it - 1));
+			it = end;
+			continue; // keys not relevant in this kdbSet
 		}
 
-		ksAppendKey (split->keysets[curFound], curKey);
-		if (keyNeedSync (curKey) == 1)
+		ksAppendRange (split->keysets[curFound], ks, it, end);
+		for (; it < end; ++it)
 		{
-			split->syncbits[curFound] |= 1;
-			needsSync = 1;
+			if (keyNeedSync (ksAtCursor (ks, it)) == 1)
+			{
+				split->syncbits[curFound] |= 1;
+				needsSync = 1;
+			}
 		}
 	}
 
+	elektraFree (mountpoints);
 	return needsSync;
 }
 
+/**
+ * @brief The number of keys the backend of a split had at the last kdbGet() or kdbSet()
+ *
+ * @param split the split object to work with
+ * @param i the index of the split
+ *
+ * @return the size of the keyset of the backend for the namespace of the split
+ * @retval -1 if kdbGet() was not executed before or the namespace is not stored in backends
+ */
+static ssize_t splitBackendSize (Split * split, size_t i)
+{
+	switch (keyGetNamespace (split->parents[i]))
+	{
+	case KEY_NS_SPEC:
+		return split->handles[i]->specsize;
+	case KEY_NS_DIR:
+		return split->handles[i]->dirsize;
+	case KEY_NS_USER:
+		return split->handles[i]->usersize;
+	case KEY_NS_SYSTEM:
+		return split->handles[i]->systemsize;
+	default:
+		return -1;
+	}
+}
+
+/**
+ * A range of keys of the same backend, see splitDivideChanged()
+ */
+typedef struct
+{
+	elektraCursor start;
+	elektraCursor end;
+	ssize_t split;
+} SplitRange;
+
+/**
+ * Splits up the keysets like splitDivide(), but only for changed backends.
+ *
+ * Instead of searching for a sync bit in every key, only the keys logged
+ * in the changes of @p ks are checked, see elektraKsTrackChanges().
+ * The ranges of keys of a backend are only counted. A backend without
+ * logged keys, that still has as many keys as after the last kdbGet()
+ * or kdbSet(), does not need to be synced and is removed from @p split
+ * right away. All other backends are divided, so that splitSync()
+ * can detect removed keys and wrong states as usual.
+ *
+ * So a single changed key only needs the keys of its own backend to be
+ * touched, independent of the size of @p ks.
+ *
+ * @pre splitBuildup() need to be executed before.
+ * @pre the changes of @p ks are tracked
+ *
+ * @param split the split object to work with
+ * @param handle to get information where the individual keys belong
+ * @param ks the keyset to divide
+ *
+ * @retval 0 if there were no sync bits
+ * @retval 1 if there were sync bits
+ * @retval -1 if no backend was found for any key
+ * @ingroup split
+ */
+int splitDivideChanged (Split * split, KDB * handle, KeySet * ks)
+{
+	int needsSync = 0;
+	int ret = -1;
+
+	Key ** mountpoints = elektraMalloc ((handle->split->size + 1) * sizeof (Key *));
+	size_t * counts = elektraCalloc ((split->size + 1) * sizeof (size_t));
+	size_t rangesAlloc = 16;
+	size_t rangesSize = 0;
+	SplitRange * ranges = elektraMalloc (rangesAlloc * sizeof (SplitRange));
+	if (!mountpoints || !counts || !ranges) goto memerror;
+	memcpy (mountpoints, handle->split->parents, handle->split->size * sizeof (Key *));
+	qsort (mountpoints, handle->split->size, sizeof (Key *), splitCompareMountpoints);
+
+	elektraCursor size = ksGetSize (ks);
+	for (elektraCursor it = 0; it < size;)
+	{
+		Key * curKey = ksAtCursor (ks, it);
+
+		Backend * curHandle = mountGetBackend (handle, keyName (curKey));
+		if (!curHandle) goto cleanup;
+
+		elektraCursor end = splitFindRangeEnd (handle, mountpoints, ks, it, curHandle);
+		ssize_t curFound = splitSearchBackend (split, curHandle, curKey);
+		if (curFound != -1)
+		{
+			if (rangesSize == rangesAlloc)
+			{
+				rangesAlloc *= 2;
+				if (elektraRealloc ((void **) &ranges, rangesAlloc * sizeof (SplitRange)) == -1) goto memerror;
+			}
+			ranges[rangesSize].start = it;
+			ranges[rangesSize].end = end;
+			ranges[rangesSize].split = curFound;
+			++rangesSize;
+			counts[curFound] += end - it;
+		}
+		it = end;
+	}
+
+	for (elektraCursor it = 0; it < ksGetSize (ks->changes); ++it)
+	{
+		ssize_t pos = ksSearch (ks, ksAtCursor (ks->changes, it));
+		if (pos < 0) continue; // removed again, splitSync() will notice if the size changed
+
+		Key * curKey = ksAtCursor (ks, pos);
+		if (keyNeedSync (curKey) != 1) continue;
+
+		Backend * curHandle = mountGetBackend (handle, keyName (curKey));
+		if (!curHandle) goto cleanup;
+
+		ssize_t curFound = splitSearchBackend (split, curHandle, curKey);
+		if (curFound == -1) continue; // not relevant in this kdbSet
+
+		split->syncbits[curFound] |= 1;
+		needsSync = 1;
+	}
+
+	for (size_t i = 0; i < rangesSize; ++i)
+	{
+		ssize_t curFound = ranges[i].split;
+		if (!(split->syncbits[curFound] & SPLIT_FLAG_SYNC) && (ssize_t) counts[curFound] == splitBackendSize (split, curFound))
+		{
+			continue;
+		}
+		ksAppendRange (split->keysets[curFound], ks, ranges[i].start, ranges[i].end);
+	}
+
+	for (size_t i = split->size; i > 0; --i)
+	{
+		if (!(split->syncbits[i - 1] & SPLIT_FLAG_SYNC) && (ssize_t) counts[i - 1] == splitBackendSize (split, i - 1))
+		{
+			// unchanged, would be removed by splitPrepare() anyway
+			splitRemove (split, i - 1);
+		}
+	}
+
+	ret = needsSync;
+
+cleanup:
+	elektraFree (mountpoints);
+	elektraFree (counts);
+	elektraFree (ranges);
+	return ret;
+
+memerror:
+	// nothing was divided yet, so check every key instead
+	elektraFree (mountpoints);
+	elektraFree (counts);
+	elektraFree (ranges);
+	return splitDivide (split, handle, ks);
+}
+
 /**
  * @brief Update the (configuration) file name for the parent key
  *
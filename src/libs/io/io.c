@@ -15,7 +15,34 @@
 #include <kdblogger.h>
 #include <kdbprivate.h>
 
+#include <errno.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef ELEKTRA_IO_THREADS
+#include <pthread.h>
+#endif
+
+// Indices for array returned by pipe()
+#define IO_PIPE_READ_END 0
+#define IO_PIPE_WRITE_END 1
+
+typedef struct
+{
+	KDB * kdb;
+	KeySet * returned;
+	Key * parentKey;
+	ElektraIoKdbGetCallback callback;
+	void * data;
+
+	int result;
+	int fds[2];
+	ElektraIoFdOperation * fdOp;
+#ifdef ELEKTRA_IO_THREADS
+	pthread_t thread;
+#endif
+} IoKdbGetOperation;
 
 int elektraIoContract (KeySet * contract, ElektraIoInterface * ioBinding)
 {
@@ -27,6 +54,15 @@ int elektraIoContract (KeySet * contract, ElektraIoInterface * ioBinding)
 	return 0;
 }
 
+int elektraIoWatchContract (KeySet * contract)
+{
+	if (contract == NULL) return -1;
+
+	ksAppendKey (contract, keyNew ("system:/elektra/contract/globalkeyset/resolver/inotify", KEY_VALUE, "1", KEY_END));
+
+	return 0;
+}
+
 ElektraIoInterface * elektraIoGetBinding (KDB * kdb)
 {
 	Key * ioBindingKey = ksLookupByName (kdb->global, "system:/elektra/io/binding", 0);
@@ -35,6 +71,107 @@ ElektraIoInterface * elektraIoGetBinding (KDB * kdb)
 	return binding;
 }
 
+// ################################
+// # Asynchronous kdbGet
+// ################################
+
+static void ioKdbGetRun (IoKdbGetOperation * op)
+{
+	op->result = kdbGet (op->kdb, op->returned, op->parentKey);
+
+	// wake up the event loop, the pipe cannot be full
+	char done = 1;
+	while (write (op->fds[IO_PIPE_WRITE_END], &done, 1) == -1 && errno == EINTR)
+		;
+}
+
+#ifdef ELEKTRA_IO_THREADS
+static void * ioKdbGetThread (void * data)
+{
+	ioKdbGetRun (data);
+	return NULL;
+}
+#endif
+
+static void ioKdbGetFree (IoKdbGetOperation * op)
+{
+	close (op->fds[IO_PIPE_READ_END]);
+	close (op->fds[IO_PIPE_WRITE_END]);
+	elektraFree (op->fdOp);
+	op->kdb->ioGetPending = 0;
+	elektraFree (op);
+}
+
+static void ioKdbGetDone (ElektraIoFdOperation * fdOp, int flags ELEKTRA_UNUSED)
+{
+	IoKdbGetOperation * op = elektraIoFdGetData (fdOp);
+#ifdef ELEKTRA_IO_THREADS
+	pthread_join (op->thread, NULL);
+#endif
+	elektraIoBindingRemoveFd (fdOp);
+
+	KDB * kdb = op->kdb;
+	KeySet * returned = op->returned;
+	Key * parentKey = op->parentKey;
+	ElektraIoKdbGetCallback callback = op->callback;
+	void * data = op->data;
+	int result = op->result;
+	ioKdbGetFree (op);
+
+	// the callback may start the next operation
+	callback (kdb, returned, parentKey, result, data);
+}
+
+int elektraIoKdbGetAsync (ElektraIoInterface * binding, KDB * kdb, KeySet * returned, Key * parentKey, ElektraIoKdbGetCallback callback,
+			  void * data)
+{
+	if (binding == NULL || kdb == NULL || returned == NULL || parentKey == NULL || callback == NULL) return -1;
+	if (kdb->ioGetPending)
+	{
+		ELEKTRA_LOG_WARNING ("asynchronous kdbGet already pending for this KDB instance");
+		return -1;
+	}
+
+	IoKdbGetOperation * op = elektraCalloc (sizeof (IoKdbGetOperation));
+	if (op == NULL) return -1;
+	op->kdb = kdb;
+	op->returned = returned;
+	op->parentKey = parentKey;
+	op->callback = callback;
+	op->data = data;
+
+	if (pipe (op->fds) == -1)
+	{
+		ELEKTRA_LOG_WARNING ("pipe() failed: %s", strerror (errno));
+		elektraFree (op);
+		return -1;
+	}
+	kdb->ioGetPending = 1;
+
+	op->fdOp = elektraIoNewFdOperation (op->fds[IO_PIPE_READ_END], ELEKTRA_IO_READABLE, 1, ioKdbGetDone, op);
+	if (op->fdOp == NULL || !elektraIoBindingAddFd (binding, op->fdOp))
+	{
+		ELEKTRA_LOG_WARNING ("could not add completion descriptor to I/O binding");
+		ioKdbGetFree (op);
+		return -1;
+	}
+
+#ifdef ELEKTRA_IO_THREADS
+	int error = pthread_create (&op->thread, NULL, ioKdbGetThread, op);
+	if (error != 0)
+	{
+		ELEKTRA_LOG_WARNING ("could not start worker thread: %s", strerror (error));
+		elektraIoBindingRemoveFd (op->fdOp);
+		ioKdbGetFree (op);
+		return -1;
+	}
+#else
+	ioKdbGetRun (op);
+#endif
+
+	return 0;
+}
+
 // ################################
 // # Binding accessors
 // ################################
@@ -352,7 +352,7 @@ KeySet * elektraMetaArrayToKS (Key * key, const char * metaName)
 	}
 	else
 	{
-		result = elektraArrayGet (meta, keyMeta (key));
+		result = elektraArrayGet (meta, elektraKeyGetMetaKeySet (key));
 		ksAppendKey (result, (Key *) meta);
 	}
 
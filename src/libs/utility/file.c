@@ -0,0 +1,237 @@
+/**
+ * @file
+ *
+ * @brief Helpers for storage plugins working on files
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#define _GNU_SOURCE // needed for copy_file_range
+
+#include <kdbconfig.h>
+#include <kdbhelper.h>
+#include <kdbutility.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+static int copyFileRangeFallback (int in, off_t inOffset, int out, off_t outOffset, size_t size)
+{
+	char buffer[65536];
+	while (size > 0)
+	{
+		ssize_t length = pread (in, buffer, size < sizeof (buffer) ? size : sizeof (buffer), inOffset);
+		if (length == -1 && errno == EINTR) continue;
+		if (length <= 0)
+		{
+			if (length == 0) errno = EIO; // the file got shorter
+			return -1;
+		}
+
+		for (ssize_t done = 0; done < length;)
+		{
+			ssize_t written = pwrite (out, buffer + done, length - done, outOffset + done);
+			if (written == -1 && errno == EINTR) continue;
+			if (written == -1) return -1;
+			done += written;
+		}
+
+		inOffset += length;
+		outOffset += length;
+		size -= length;
+	}
+	return 0;
+}
+
+/**
+ * @brief Copies a range of bytes from one file to another
+ *
+ * Storage plugins use it to take over unchanged parts of the old file into
+ * the new one. Where available copy_file_range() is used, so that the
+ * kernel does not need to copy the data to user space and file systems
+ * supporting it may even share the blocks (reflink).
+ *
+ * The file offsets of @p in and @p out are not changed.
+ *
+ * @param in the file descriptor to copy from
+ * @param inOffset the offset in @p in to start at
+ * @param out the file descriptor to copy to
+ * @param outOffset the offset in @p out to write to
+ * @param size the number of bytes to copy
+ *
+ * @retval 0 on success
+ * @retval -1 on error, `errno` is set
+ */
+int elektraCopyFileRange (int in, off_t inOffset, int out, off_t outOffset, size_t size)
+{
+#ifdef HAVE_COPY_FILE_RANGE
+	while (size > 0)
+	{
+		ssize_t copied = copy_file_range (in, &inOffset, out, &outOffset, size, 0);
+		if (copied == -1 && errno == EINTR) continue;
+		if (copied == -1 && (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP))
+		{
+			// e.g. old kernel or different file systems
+			break;
+		}
+		if (copied <= 0)
+		{
+			if (copied == 0) errno = EIO; // the file got shorter
+			return -1;
+		}
+		size -= copied;
+	}
+#endif
+	return copyFileRangeFallback (in, inOffset, out, outOffset, size);
+}
+
+/**
+ * @brief Replaces the content of a file with a single write()
+ *
+ * The file is created if it does not exist.
+ *
+ * @param fileName the file to write
+ * @param data the new content
+ * @param size the number of bytes in @p data
+ *
+ * @retval 0 on success
+ * @retval -1 on error, `errno` is set
+ */
+int elektraWriteFile (const char * fileName, const void * data, size_t size)
+{
+	int fd = open (fileName, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd == -1) return -1;
+
+	const char * current = data;
+	while (size > 0)
+	{
+		ssize_t written = write (fd, current, size);
+		if (written == -1 && errno == EINTR) continue;
+		if (written == -1)
+		{
+			int errnosave = errno;
+			close (fd);
+			errno = errnosave;
+			return -1;
+		}
+		current += written;
+		size -= written;
+	}
+
+	return close (fd);
+}
+
+/**
+ * @brief Estimates the size of a serialized KeySet
+ *
+ * The estimate is the size of all names and values plus some bytes per key
+ * for the syntax. It is meant as initial size for elektraOutputBufferInit(),
+ * so that the buffer rarely needs to grow.
+ *
+ * @param ks the KeySet to be serialized
+ *
+ * @return the estimated number of bytes
+ */
+size_t elektraOutputBufferEstimate (KeySet * ks)
+{
+	size_t size = 0;
+	for (elektraCursor it = 0; it < ksGetSize (ks); ++it)
+	{
+		const Key * key = ksAtCursor (ks, it);
+		size += keyGetNameSize (key) + keyGetValueSize (key) + 8;
+	}
+	return size;
+}
+
+/**
+ * @brief Initializes an output buffer
+ *
+ * Storage plugins append their output to the buffer and write it with
+ * elektraOutputBufferWrite() at the end, so that the file is written with
+ * a single system call.
+ *
+ * @param buffer the buffer to initialize
+ * @param size the initial size, e.g. from elektraOutputBufferEstimate()
+ */
+void elektraOutputBufferInit (ElektraOutputBuffer * buffer, size_t size)
+{
+	buffer->alloc = size < 64 ? 64 : size;
+	buffer->size = 0;
+	buffer->data = elektraMalloc (buffer->alloc);
+	buffer->failed = buffer->data == NULL;
+}
+
+static int ensureSize (ElektraOutputBuffer * buffer, size_t size)
+{
+	if (buffer->failed) return 0;
+	if (buffer->alloc - buffer->size >= size) return 1;
+
+	size_t alloc = buffer->alloc;
+	while (alloc - buffer->size < size)
+	{
+		alloc *= 2;
+	}
+
+	if (elektraRealloc ((void **) &buffer->data, alloc) == -1)
+	{
+		buffer->failed = 1;
+		return 0;
+	}
+	buffer->alloc = alloc;
+	return 1;
+}
+
+/**
+ * @brief Appends @p size bytes of @p data to @p buffer
+ */
+void elektraOutputBufferAppend (ElektraOutputBuffer * buffer, const void * data, size_t size)
+{
+	if (!ensureSize (buffer, size)) return;
+	memcpy (buffer->data + buffer->size, data, size);
+	buffer->size += size;
+}
+
+/**
+ * @brief Appends a null-terminated @p string without its terminator to @p buffer
+ */
+void elektraOutputBufferAppendString (ElektraOutputBuffer * buffer, const char * string)
+{
+	elektraOutputBufferAppend (buffer, string, strlen (string));
+}
+
+/**
+ * @brief Appends a single character to @p buffer
+ */
+void elektraOutputBufferAppendChar (ElektraOutputBuffer * buffer, char c)
+{
+	if (!ensureSize (buffer, 1)) return;
+	buffer->data[buffer->size++] = c;
+}
+
+/**
+ * @brief Writes the content of @p buffer to a file, see elektraWriteFile()
+ *
+ * @retval 0 on success
+ * @retval -1 on error, `errno` is set (`ENOMEM` if appending failed)
+ */
+int elektraOutputBufferWrite (ElektraOutputBuffer * buffer, const char * fileName)
+{
+	if (buffer->failed)
+	{
+		errno = ENOMEM;
+		return -1;
+	}
+	return elektraWriteFile (fileName, buffer->data, buffer->size);
+}
+
+/**
+ * @brief Frees the memory of @p buffer
+ */
+void elektraOutputBufferFree (ElektraOutputBuffer * buffer)
+{
+	elektraFree (buffer->data);
+	buffer->data = NULL;
+	buffer->size = buffer->alloc = 0;
+}
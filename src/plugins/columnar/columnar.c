@@ -0,0 +1,668 @@
+/**
+ * @file
+ *
+ * @brief Source for columnar plugin
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+#include "columnar.h"
+
+#include <kdbendian.h>
+#include <kdberrors.h>
+#include <kdbhelper.h>
+#include <kdbprivate.h> // for ksResize and keySetRaw
+
+#include <stdio.h>
+#include <string.h>
+
+struct buffer
+{
+	size_t alloc;
+	size_t size;
+	unsigned char * data;
+};
+
+struct metaSetSlot
+{
+	uint64_t hash;
+	size_t id; ///< 0 for unused slots, otherwise index of the set + 1
+};
+
+/**
+ * Deduplicates metadata sets while writing
+ *
+ * Every distinct set is encoded once into `sets`. The hash table maps
+ * the encoded form to its index, `index` holds the offsets into `sets`.
+ */
+struct metaSets
+{
+	struct buffer sets;
+	struct buffer index;
+	size_t count;
+	struct metaSetSlot * slots;
+	size_t slotCount;
+	struct buffer scratch;
+	const Key * previous;
+	uint32_t previousId;
+};
+
+static void bufferEnsure (struct buffer * buffer, size_t additional)
+{
+	if (buffer->size + additional <= buffer->alloc) return;
+
+	size_t alloc = buffer->alloc > 0 ? buffer->alloc : 64;
+	while (alloc < buffer->size + additional)
+	{
+		alloc *= 2;
+	}
+	elektraRealloc ((void **) &buffer->data, alloc);
+	buffer->alloc = alloc;
+}
+
+static void bufferAppend (struct buffer * buffer, const void * data, size_t size)
+{
+	if (size == 0) return;
+	bufferEnsure (buffer, size);
+	memcpy (buffer->data + buffer->size, data, size);
+	buffer->size += size;
+}
+
+// the counterpart of elektraColumnarReadSize
+static void bufferAppendSize (struct buffer * buffer, size_t value)
+{
+	bufferEnsure (buffer, sizeof (size_t) * 8 / 7 + 1);
+	do
+	{
+		unsigned char byte = value & 0x7f;
+		value >>= 7;
+		buffer->data[buffer->size++] = value > 0 ? byte | 0x80 : byte;
+	} while (value > 0);
+}
+
+static void bufferAppendU64 (struct buffer * buffer, uint64_t value)
+{
+	value = htole64 (value);
+	bufferAppend (buffer, &value, sizeof (value));
+}
+
+static void bufferAppendU32 (struct buffer * buffer, uint32_t value)
+{
+	value = htole32 (value);
+	bufferAppend (buffer, &value, sizeof (value));
+}
+
+static uint64_t hashBytes (const unsigned char * data, size_t size)
+{
+	// FNV-1a
+	uint64_t hash = 14695981039346656037UL;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= data[i];
+		hash *= 1099511628211UL;
+	}
+	return hash;
+}
+
+// true if both keys share the very same metakeys, e.g. because of keyCopyAllMeta() or keyCopyMeta()
+static bool sameMetaKeys (const Key * a, const Key * b)
+{
+	// keyMeta() would copy shared metadata
+	KeySet * aMeta = a->meta;
+	KeySet * bMeta = b->meta;
+	if (aMeta == bMeta) return true;
+	if (ksGetSize (aMeta) != ksGetSize (bMeta)) return false;
+
+	for (elektraCursor it = 0; it < ksGetSize (aMeta); ++it)
+	{
+		if (ksAtCursor (aMeta, it) != ksAtCursor (bMeta, it)) return false;
+	}
+	return true;
+}
+
+static void metaSetsGrow (struct metaSets * metaSets)
+{
+	size_t slotCount = metaSets->slotCount > 0 ? 2 * metaSets->slotCount : 64;
+	struct metaSetSlot * slots = elektraCalloc (slotCount * sizeof (struct metaSetSlot));
+
+	for (size_t i = 0; i < metaSets->slotCount; ++i)
+	{
+		if (metaSets->slots[i].id == 0) continue;
+
+		size_t slot = metaSets->slots[i].hash & (slotCount - 1);
+		while (slots[slot].id != 0)
+		{
+			slot = (slot + 1) & (slotCount - 1);
+		}
+		slots[slot] = metaSets->slots[i];
+	}
+
+	elektraFree (metaSets->slots);
+	metaSets->slots = slots;
+	metaSets->slotCount = slotCount;
+}
+
+/**
+ * Returns the id of the metadata set of @p key, adding the set to the dictionary if it is new.
+ *
+ * @retval 0 if @p key has no metadata
+ */
+static uint32_t metaSetsAdd (struct metaSets * metaSets, const Key * key)
+{
+	KeySet * meta = key->meta;
+	if (ksGetSize (meta) <= 0) return 0;
+
+	if (metaSets->previous != NULL && sameMetaKeys (metaSets->previous, key))
+	{
+		metaSets->previous = key;
+		return metaSets->previousId;
+	}
+
+	// names and values are stored null-terminated, so that they can be used from the mapped file directly
+	struct buffer * scratch = &metaSets->scratch;
+	scratch->size = 0;
+	bufferAppendSize (scratch, ksGetSize (meta));
+	for (elektraCursor it = 0; it < ksGetSize (meta); ++it)
+	{
+		const Key * current = ksAtCursor (meta, it);
+		const char * name = keyName (current) + sizeof ("meta:/") - 1;
+		size_t nameSize = strlen (name) + 1;
+		size_t valueSize = strlen (keyString (current)) + 1;
+
+		bufferAppendSize (scratch, nameSize);
+		bufferAppend (scratch, name, nameSize);
+		bufferAppendSize (scratch, valueSize);
+		bufferAppend (scratch, keyString (current), valueSize);
+	}
+
+	if (2 * (metaSets->count + 1) > metaSets->slotCount)
+	{
+		metaSetsGrow (metaSets);
+	}
+
+	uint64_t hash = hashBytes (scratch->data, scratch->size);
+	const uint64_t * index = (const uint64_t *) metaSets->index.data;
+	size_t slot = hash & (metaSets->slotCount - 1);
+	while (metaSets->slots[slot].id != 0)
+	{
+		size_t id = metaSets->slots[slot].id - 1;
+		uint64_t begin = le64toh (index[id]);
+		uint64_t end = le64toh (index[id + 1]);
+
+		if (metaSets->slots[slot].hash == hash && end - begin == scratch->size &&
+		    memcmp (metaSets->sets.data + begin, scratch->data, scratch->size) == 0)
+		{
+			break;
+		}
+		slot = (slot + 1) & (metaSets->slotCount - 1);
+	}
+
+	if (metaSets->slots[slot].id == 0)
+	{
+		bufferAppend (&metaSets->sets, scratch->data, scratch->size);
+		bufferAppendU64 (&metaSets->index, metaSets->sets.size);
+		metaSets->slots[slot].hash = hash;
+		metaSets->slots[slot].id = ++metaSets->count;
+	}
+
+	metaSets->previous = key;
+	metaSets->previousId = metaSets->slots[slot].id;
+	return metaSets->previousId;
+}
+
+static bool writeSection (FILE * file, const void * data, size_t size, uint64_t * position)
+{
+	static const char padding[sizeof (uint64_t)] = { 0 };
+
+	if (size > 0 && fwrite (data, 1, size, file) < size) return false;
+	*position += size;
+
+	size_t paddingSize = (sizeof (uint64_t) - *position % sizeof (uint64_t)) % sizeof (uint64_t);
+	if (paddingSize > 0 && fwrite (padding, 1, paddingSize, file) < paddingSize) return false;
+	*position += paddingSize;
+
+	return true;
+}
+
+static uint64_t sectionEnd (uint64_t offset, size_t size)
+{
+	uint64_t end = offset + size;
+	return end + (sizeof (uint64_t) - end % sizeof (uint64_t)) % sizeof (uint64_t);
+}
+
+static int writeFile (const char * filename, ColumnarHeader * header, struct buffer * sections, size_t sectionCount, Key * parentKey)
+{
+	FILE * file = fopen (filename, "wb");
+	if (file == NULL)
+	{
+		ELEKTRA_SET_ERROR_SET (parentKey);
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+
+	uint64_t position = 0;
+	bool success = writeSection (file, header, sizeof (ColumnarHeader), &position);
+	for (size_t i = 0; success && i < sectionCount; ++i)
+	{
+		success = writeSection (file, sections[i].data, sections[i].size, &position);
+	}
+
+	if (fclose (file) != 0 || !success)
+	{
+		ELEKTRA_SET_RESOURCE_ERRORF (parentKey, "Could not write columnar file '%s'", filename);
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+
+	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
+
+int elektraColumnarSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
+{
+	size_t offset = elektraColumnarRelativeOffset (parentKey);
+	const char * parentName = keyUnescapedName (parentKey);
+	size_t keyCount = ksGetSize (returned);
+
+	// the order of the sections within the file
+	enum
+	{
+		NAMES,
+		BLOCKS,
+		INFOS,
+		VALUE_INDEX,
+		VALUES,
+		META_INDEX,
+		META_SETS,
+		SECTION_COUNT
+	};
+	struct buffer sections[SECTION_COUNT];
+	memset (sections, 0, sizeof (sections));
+
+	struct metaSets metaSets;
+	memset (&metaSets, 0, sizeof (metaSets));
+	bufferAppendU64 (&metaSets.index, 0);
+
+	const char * previousName = NULL;
+	size_t previousSize = 0;
+	int ret = ELEKTRA_PLUGIN_STATUS_SUCCESS;
+
+	for (elektraCursor it = 0; it < (elektraCursor) keyCount; ++it)
+	{
+		const Key * cur = ksAtCursor (returned, it);
+		const char * name = keyUnescapedName (cur);
+		size_t nameSize = keyGetUnescapedNameSize (cur);
+
+		if (nameSize < offset || memcmp (name, parentName, offset) != 0)
+		{
+			ELEKTRA_SET_INTERFACE_ERRORF (parentKey, "Key '%s' is not below the parent key '%s'", keyName (cur),
+						      keyName (parentKey));
+			ret = ELEKTRA_PLUGIN_STATUS_ERROR;
+			break;
+		}
+		name += offset;
+		nameSize -= offset;
+
+		// front coding: store only the part that differs from the previous name, except at the start of a block
+		size_t shared = 0;
+		if (it % COLUMNAR_BLOCK_SIZE == 0)
+		{
+			bufferAppendU64 (&sections[BLOCKS], sections[NAMES].size);
+		}
+		else
+		{
+			size_t maxShared = nameSize < previousSize ? nameSize : previousSize;
+			while (shared < maxShared && name[shared] == previousName[shared])
+			{
+				++shared;
+			}
+		}
+		bufferAppendSize (&sections[NAMES], shared);
+		bufferAppendSize (&sections[NAMES], nameSize - shared);
+		bufferAppend (&sections[NAMES], name + shared, nameSize - shared);
+		previousName = name;
+		previousSize = nameSize;
+
+		uint32_t info = metaSetsAdd (&metaSets, cur);
+		bufferAppendU64 (&sections[VALUE_INDEX], sections[VALUES].size);
+		if (keyIsBinary (cur))
+		{
+			info |= COLUMNAR_BINARY_FLAG;
+			bufferAppend (&sections[VALUES], keyValue (cur), keyGetValueSize (cur));
+		}
+		else
+		{
+			const char * value = keyString (cur);
+			bufferAppend (&sections[VALUES], value, strlen (value) + 1);
+		}
+		bufferAppendU32 (&sections[INFOS], info);
+	}
+	bufferAppendU64 (&sections[VALUE_INDEX], sections[VALUES].size);
+
+	sections[META_INDEX] = metaSets.index;
+	sections[META_SETS] = metaSets.sets;
+
+	if (ret == ELEKTRA_PLUGIN_STATUS_SUCCESS)
+	{
+		ColumnarHeader header;
+		uint64_t sectionOffsets[SECTION_COUNT];
+		uint64_t position = sectionEnd (0, sizeof (ColumnarHeader));
+		for (size_t i = 0; i < SECTION_COUNT; ++i)
+		{
+			sectionOffsets[i] = position;
+			position = sectionEnd (position, sections[i].size);
+		}
+
+		header.magic = htobe64 (COLUMNAR_MAGIC_NUMBER);
+		header.keyCount = htole64 (keyCount);
+		header.namesOffset = htole64 (sectionOffsets[NAMES]);
+		header.namesSize = htole64 (sections[NAMES].size);
+		header.blocksOffset = htole64 (sectionOffsets[BLOCKS]);
+		header.infosOffset = htole64 (sectionOffsets[INFOS]);
+		header.valueIndexOffset = htole64 (sectionOffsets[VALUE_INDEX]);
+		header.valuesOffset = htole64 (sectionOffsets[VALUES]);
+		header.valuesSize = htole64 (sections[VALUES].size);
+		header.metaSetCount = htole64 (metaSets.count);
+		header.metaIndexOffset = htole64 (sectionOffsets[META_INDEX]);
+		header.metaSetsOffset = htole64 (sectionOffsets[META_SETS]);
+		header.metaSetsSize = htole64 (sections[META_SETS].size);
+
+		ret = writeFile (keyString (parentKey), &header, sections, SECTION_COUNT, parentKey);
+	}
+
+	for (size_t i = 0; i < SECTION_COUNT; ++i)
+	{
+		elektraFree (sections[i].data);
+	}
+	elektraFree (metaSets.slots);
+	elektraFree (metaSets.scratch.data);
+
+	return ret;
+}
+
+/**
+ * Creates a key that holds the metadata set @p id, metadata of other keys is
+ * copied from it, so that all keys with the same set share their metakeys.
+ */
+static Key * createMetaTemplate (const ColumnarSnapshot * snapshot, size_t id, Key * parentKey)
+{
+	const unsigned char * cursor = snapshot->metaSets + le64toh (snapshot->metaIndex[id]);
+	const unsigned char * end = snapshot->metaSets + le64toh (snapshot->metaIndex[id + 1]);
+
+	Key * metaTemplate = keyNew ("/", KEY_END);
+	size_t count;
+	if (!elektraColumnarReadSize (&cursor, end, &count) || count == 0) goto error;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		size_t nameSize;
+		if (!elektraColumnarReadSize (&cursor, end, &nameSize) || nameSize == 0 || nameSize > (size_t) (end - cursor) ||
+		    cursor[nameSize - 1] != '\0')
+		{
+			goto error;
+		}
+		const char * name = (const char *) cursor;
+		cursor += nameSize;
+
+		size_t valueSize;
+		if (!elektraColumnarReadSize (&cursor, end, &valueSize) || valueSize == 0 || valueSize > (size_t) (end - cursor) ||
+		    cursor[valueSize - 1] != '\0')
+		{
+			goto error;
+		}
+		const char * value = (const char *) cursor;
+		cursor += valueSize;
+
+		if (keySetMeta (metaTemplate, name, value) < 0) goto error;
+	}
+
+	return metaTemplate;
+
+error:
+	ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Columnar file contains an invalid metadata set %zu", id);
+	keyDel (metaTemplate);
+	return NULL;
+}
+
+/**
+ * Builds escaped key names from the unescaped relative names of the name column
+ *
+ * Consecutive names share most of their parts, only the parts after the
+ * shared prefix are escaped again.
+ */
+struct nameBuilder
+{
+	char * name; ///< escaped name of the current key
+	size_t nameAlloc;
+	size_t baseSize;  ///< size of the escaped parent name
+	size_t * partEnds; ///< for every part: end of the part within the relative name and within the escaped name
+	size_t partCount;
+	size_t partAlloc;
+	char * escapedPart;
+};
+
+static bool nameBuilderUpdate (struct nameBuilder * builder, const char * relative, size_t relativeSize, size_t shared)
+{
+	// keep parts that are entirely within the shared prefix
+	while (builder->partCount > 0 && builder->partEnds[2 * (builder->partCount - 1)] > shared)
+	{
+		--builder->partCount;
+	}
+
+	size_t position = builder->partCount > 0 ? builder->partEnds[2 * (builder->partCount - 1)] : 0;
+	size_t nameSize = builder->partCount > 0 ? builder->partEnds[2 * builder->partCount - 1] : builder->baseSize;
+
+	while (position < relativeSize)
+	{
+		const char * partEnd = memchr (relative + position, '\0', relativeSize - position);
+		if (partEnd == NULL) return false;
+
+		size_t escapedSize = elektraKeyNameEscapePart (relative + position, &builder->escapedPart);
+		if (nameSize + escapedSize + 2 > builder->nameAlloc)
+		{
+			builder->nameAlloc = 2 * (nameSize + escapedSize + 2);
+			elektraRealloc ((void **) &builder->name, builder->nameAlloc);
+		}
+		builder->name[nameSize++] = '/';
+		memcpy (builder->name + nameSize, builder->escapedPart, escapedSize);
+		nameSize += escapedSize;
+
+		if (builder->partCount == builder->partAlloc)
+		{
+			builder->partAlloc = builder->partAlloc > 0 ? 2 * builder->partAlloc : 16;
+			elektraRealloc ((void **) &builder->partEnds, 2 * builder->partAlloc * sizeof (size_t));
+		}
+		position = partEnd - relative + 1;
+		builder->partEnds[2 * builder->partCount] = position;
+		builder->partEnds[2 * builder->partCount + 1] = nameSize;
+		++builder->partCount;
+	}
+
+	builder->name[nameSize] = '\0';
+	return true;
+}
+
+static int readSnapshot (const ColumnarSnapshot * snapshot, KeySet * returned, Key * parentKey)
+{
+	if (ksGetSize (returned) + snapshot->keyCount > returned->alloc)
+	{
+		ksResize (returned, ksGetSize (returned) + snapshot->keyCount);
+	}
+
+	struct nameBuilder builder;
+	memset (&builder, 0, sizeof (builder));
+	builder.baseSize = keyGetNameSize (parentKey) - 1;
+	bool rootParent = keyName (parentKey)[builder.baseSize - 1] == '/';
+	if (rootParent)
+	{
+		// the root key of a namespace
+		--builder.baseSize;
+	}
+	builder.nameAlloc = builder.baseSize + 64;
+	builder.name = elektraMalloc (builder.nameAlloc);
+	memcpy (builder.name, keyName (parentKey), builder.baseSize);
+
+	Key ** templates = elektraCalloc ((snapshot->metaSetCount + 1) * sizeof (Key *));
+
+	const unsigned char * cursor = snapshot->names;
+	const unsigned char * namesEnd = snapshot->names + snapshot->namesSize;
+	char * relative = NULL;
+	size_t relativeSize = 0;
+	size_t relativeAlloc = 0;
+
+	int ret = ELEKTRA_PLUGIN_STATUS_SUCCESS;
+	for (size_t i = 0; i < snapshot->keyCount; ++i)
+	{
+		size_t shared;
+		size_t suffixSize;
+		if (!elektraColumnarReadSize (&cursor, namesEnd, &shared) || !elektraColumnarReadSize (&cursor, namesEnd, &suffixSize) ||
+		    shared > relativeSize || suffixSize > (size_t) (namesEnd - cursor))
+		{
+			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Columnar file contains an invalid name for key %zu", i);
+			ret = ELEKTRA_PLUGIN_STATUS_ERROR;
+			break;
+		}
+
+		if (shared + suffixSize > relativeAlloc)
+		{
+			relativeAlloc = 2 * (shared + suffixSize);
+			elektraRealloc ((void **) &relative, relativeAlloc);
+		}
+		memcpy (relative + shared, cursor, suffixSize);
+		cursor += suffixSize;
+		relativeSize = shared + suffixSize;
+
+		Key * key = NULL;
+		if (rootParent && relativeSize == 1)
+		{
+			// the unescaped name of the root key ends with a single null byte, that must not become an empty part
+			builder.partCount = 0;
+			key = keyNew (keyName (parentKey), KEY_END);
+		}
+		else if (nameBuilderUpdate (&builder, relative, relativeSize, shared))
+		{
+			key = keyNew (builder.name, KEY_END);
+		}
+		if (key == NULL)
+		{
+			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Columnar file contains an invalid name for key %zu", i);
+			ret = ELEKTRA_PLUGIN_STATUS_ERROR;
+			break;
+		}
+
+		// set string values before any metadata, so that keySetString does not have to look for stale meta:/binary
+		size_t valueSize;
+		bool binary;
+		const char * value = elektraColumnarValue (snapshot, i, &valueSize, &binary);
+		if (!binary && valueSize > 0 && value[valueSize - 1] == '\0')
+		{
+			keySetString (key, value);
+		}
+		else if (!binary)
+		{
+			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Columnar file contains an invalid value for key '%s'", keyName (key));
+			keyDel (key);
+			ret = ELEKTRA_PLUGIN_STATUS_ERROR;
+			break;
+		}
+
+		size_t metaSet = le32toh (snapshot->infos[i]) & ~COLUMNAR_BINARY_FLAG;
+		if (metaSet > snapshot->metaSetCount)
+		{
+			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Columnar file contains an invalid metadata set for key '%s'",
+								 keyName (key));
+			keyDel (key);
+			ret = ELEKTRA_PLUGIN_STATUS_ERROR;
+			break;
+		}
+
+		if (metaSet > 0)
+		{
+			// metadata can only be shared by UINT16_MAX - 1 keys, start over with a fresh template before that
+			Key * metaTemplate = templates[metaSet];
+			if (metaTemplate != NULL && metaTemplate->meta->refs >= UINT16_MAX - 2)
+			{
+				keyDel (metaTemplate);
+				metaTemplate = NULL;
+			}
+			if (metaTemplate == NULL)
+			{
+				metaTemplate = templates[metaSet] = createMetaTemplate (snapshot, metaSet - 1, parentKey);
+			}
+			if (metaTemplate == NULL)
+			{
+				keyDel (key);
+				ret = ELEKTRA_PLUGIN_STATUS_ERROR;
+				break;
+			}
+			keyCopyAllMeta (key, metaTemplate);
+		}
+
+		// the metadata set of binary keys already contains meta:/binary, so only set the value,
+		// keySetBinary would copy the shared metadata to set meta:/binary again
+		if (binary && keyIsBinary (key))
+		{
+			keySetRaw (key, valueSize > 0 ? value : NULL, valueSize);
+		}
+		else if (binary)
+		{
+			keySetBinary (key, valueSize > 0 ? value : NULL, valueSize);
+		}
+
+		ksAppendKey (returned, key);
+	}
+
+	for (size_t i = 0; i <= snapshot->metaSetCount; ++i)
+	{
+		keyDel (templates[i]);
+	}
+	elektraFree (templates);
+	elektraFree (relative);
+	elektraFree (builder.name);
+	elektraFree (builder.partEnds);
+	elektraFree (builder.escapedPart);
+
+	return ret;
+}
+
+int elektraColumnarGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
+{
+	if (!elektraStrCmp (keyName (parentKey), "system:/elektra/modules/columnar"))
+	{
+		KeySet * contract = ksNew (
+			30, keyNew ("system:/elektra/modules/columnar", KEY_VALUE, "columnar plugin waits for your orders", KEY_END),
+			keyNew ("system:/elektra/modules/columnar/exports", KEY_END),
+			keyNew ("system:/elektra/modules/columnar/exports/get", KEY_FUNC, elektraColumnarGet, KEY_END),
+			keyNew ("system:/elektra/modules/columnar/exports/set", KEY_FUNC, elektraColumnarSet, KEY_END),
+			keyNew ("system:/elektra/modules/columnar/exports/snapshotopen", KEY_FUNC, elektraColumnarOpen, KEY_END),
+			keyNew ("system:/elektra/modules/columnar/exports/snapshotclose", KEY_FUNC, elektraColumnarClose, KEY_END),
+			keyNew ("system:/elektra/modules/columnar/exports/lookup", KEY_FUNC, elektraColumnarLookupKey, KEY_END),
+			keyNew ("system:/elektra/modules/columnar/exports/foreachname", KEY_FUNC, elektraColumnarForEachName, KEY_END),
+			keyNew ("system:/elektra/modules/columnar/exports/value", KEY_FUNC, elektraColumnarValue, KEY_END),
+#include ELEKTRA_README
+			keyNew ("system:/elektra/modules/columnar/infos/version", KEY_VALUE, PLUGINVERSION, KEY_END), KS_END);
+		ksAppend (returned, contract);
+		ksDel (contract);
+
+		return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+	}
+
+	ColumnarSnapshot * snapshot = elektraColumnarOpen (keyString (parentKey), parentKey);
+	if (snapshot == NULL)
+	{
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+
+	int ret = readSnapshot (snapshot, returned, parentKey);
+	elektraColumnarClose (snapshot);
+
+	return ret;
+}
+
+Plugin * ELEKTRA_PLUGIN_EXPORT
+{
+	// clang-format off
+	return elektraPluginExport ("columnar",
+				    ELEKTRA_PLUGIN_GET,	&elektraColumnarGet,
+				    ELEKTRA_PLUGIN_SET,	&elektraColumnarSet,
+				    ELEKTRA_PLUGIN_END);
+	// clang-format on
+}
@@ -0,0 +1,93 @@
+/**
+ * @file
+ *
+ * @brief Header for columnar plugin
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+#ifndef ELEKTRA_PLUGIN_COLUMNAR_H
+#define ELEKTRA_PLUGIN_COLUMNAR_H
+
+#include <kdbplugin.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define COLUMNAR_MAGIC_NUMBER ((uint64_t) 0x454b444300000001UL) // EKDC (in ASCII) + Version 1
+
+// every COLUMNAR_BLOCK_SIZE-th name is stored in full, so that lookups can bisect the name column
+#define COLUMNAR_BLOCK_SIZE 16
+
+// set in the key info column for keys with a binary value, the remaining bits are the metadata set
+#define COLUMNAR_BINARY_FLAG ((uint32_t) 1 << 31)
+
+/**
+ * On-disk header of a columnar file
+ *
+ * All fields are stored little-endian, except for the magic number, which is
+ * stored big-endian so that `EKDC` is readable at the start of the file.
+ * All offsets are relative to the start of the file and aligned to 8 bytes.
+ */
+typedef struct
+{
+	uint64_t magic;
+	uint64_t keyCount;
+	uint64_t namesOffset;	   ///< front-coded names, see columnar.c for the encoding
+	uint64_t namesSize;
+	uint64_t blocksOffset;	   ///< offset into the names of every COLUMNAR_BLOCK_SIZE-th name (uint64_t)
+	uint64_t infosOffset;	   ///< binary flag and metadata set of every key (uint32_t)
+	uint64_t valueIndexOffset; ///< keyCount + 1 offsets into the value heap (uint64_t)
+	uint64_t valuesOffset;	   ///< value heap, strings are stored null-terminated
+	uint64_t valuesSize;
+	uint64_t metaSetCount;
+	uint64_t metaIndexOffset; ///< metaSetCount + 1 offsets into the metadata sets (uint64_t)
+	uint64_t metaSetsOffset;  ///< distinct metadata sets
+	uint64_t metaSetsSize;
+} ColumnarHeader;
+
+/**
+ * A columnar file mapped into memory
+ *
+ * Names are unescaped and relative to the parent key, i.e. the parts below the
+ * parent key, each terminated by a null byte (see keyUnescapedName()).
+ */
+typedef struct
+{
+	char * map;
+	size_t mapSize;
+	size_t keyCount;
+	size_t blockCount;
+	const unsigned char * names;
+	size_t namesSize;
+	const uint64_t * blocks;
+	const uint32_t * infos;
+	const uint64_t * valueIndex;
+	const char * values;
+	size_t valuesSize;
+	size_t metaSetCount;
+	const uint64_t * metaIndex;
+	const unsigned char * metaSets;
+	size_t metaSetsSize;
+} ColumnarSnapshot;
+
+typedef int (*ColumnarNameCallback) (size_t index, const char * name, size_t nameSize, void * data);
+
+ColumnarSnapshot * elektraColumnarOpen (const char * filename, Key * errorKey);
+void elektraColumnarClose (ColumnarSnapshot * snapshot);
+
+ssize_t elektraColumnarLookup (const ColumnarSnapshot * snapshot, const char * name, size_t nameSize);
+ssize_t elektraColumnarLookupKey (const ColumnarSnapshot * snapshot, const Key * parentKey, const Key * key);
+int elektraColumnarForEachName (const ColumnarSnapshot * snapshot, ColumnarNameCallback callback, void * data);
+const char * elektraColumnarValue (const ColumnarSnapshot * snapshot, size_t index, size_t * valueSize, bool * binary);
+
+size_t elektraColumnarRelativeOffset (const Key * parentKey);
+bool elektraColumnarReadSize (const unsigned char ** cursor, const unsigned char * end, size_t * value);
+
+int elektraColumnarGet (Plugin * handle, KeySet * ks, Key * parentKey);
+int elektraColumnarSet (Plugin * handle, KeySet * ks, Key * parentKey);
+
+Plugin * ELEKTRA_PLUGIN_EXPORT;
+
+#endif
@@ -0,0 +1,385 @@
+/**
+ * @file
+ *
+ * @brief Read-only access to memory mapped columnar files
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+#include "columnar.h"
+
+#include <kdbendian.h>
+#include <kdberrors.h>
+#include <kdbhelper.h>
+#include <kdbtypes.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Reads a variable length integer (7 bits per byte, least significant group first,
+ * highest bit set on all but the last byte).
+ *
+ * @retval false if the integer does not end before @p end
+ */
+bool elektraColumnarReadSize (const unsigned char ** cursor, const unsigned char * end, size_t * value)
+{
+	size_t result = 0;
+	for (unsigned int shift = 0; *cursor < end && shift < sizeof (size_t) * 8; shift += 7)
+	{
+		unsigned char byte = *(*cursor)++;
+		result |= (size_t) (byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			*value = result;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Offset of the relative names of keys below @p parentKey within their unescaped names.
+ *
+ * For the root key of a namespace, the relative names start directly after the namespace,
+ * otherwise after the null byte terminating the last part of @p parentKey.
+ */
+size_t elektraColumnarRelativeOffset (const Key * parentKey)
+{
+	size_t parentSize = keyGetUnescapedNameSize (parentKey);
+	return parentSize == 3 ? 2 : parentSize;
+}
+
+static bool sectionInFile (uint64_t offset, uint64_t size, size_t mapSize)
+{
+	return offset <= mapSize && size <= mapSize - offset && offset % sizeof (uint64_t) == 0;
+}
+
+static bool arrayInFile (uint64_t offset, uint64_t count, size_t elementSize, size_t mapSize)
+{
+	return count <= mapSize / elementSize && sectionInFile (offset, count * elementSize, mapSize);
+}
+
+static bool indexValid (const uint64_t * index, size_t count, size_t heapSize)
+{
+	uint64_t previous = 0;
+	for (size_t i = 0; i <= count; ++i)
+	{
+		uint64_t current = le64toh (index[i]);
+		if (current < previous || current > heapSize) return false;
+		previous = current;
+	}
+	return true;
+}
+
+static bool mapSnapshot (ColumnarSnapshot * snapshot, Key * errorKey)
+{
+	if (snapshot->mapSize < sizeof (ColumnarHeader))
+	{
+		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (errorKey, "Columnar file is too small to contain a header (%zu bytes)",
+							 snapshot->mapSize);
+		return false;
+	}
+
+	ColumnarHeader header;
+	memcpy (&header, snapshot->map, sizeof (ColumnarHeader));
+
+	uint64_t magic = be64toh (header.magic);
+	if (magic != COLUMNAR_MAGIC_NUMBER)
+	{
+		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (errorKey, "Unknown magic number " ELEKTRA_UNSIGNED_LONG_LONG_F,
+							 (kdb_unsigned_long_long_t) magic);
+		return false;
+	}
+
+	uint64_t keyCount = le64toh (header.keyCount);
+	uint64_t blockCount = (keyCount + COLUMNAR_BLOCK_SIZE - 1) / COLUMNAR_BLOCK_SIZE;
+	uint64_t metaSetCount = le64toh (header.metaSetCount);
+	size_t mapSize = snapshot->mapSize;
+
+	if (!sectionInFile (le64toh (header.namesOffset), le64toh (header.namesSize), mapSize) ||
+	    !arrayInFile (le64toh (header.blocksOffset), blockCount, sizeof (uint64_t), mapSize) ||
+	    !arrayInFile (le64toh (header.infosOffset), keyCount, sizeof (uint32_t), mapSize) ||
+	    !arrayInFile (le64toh (header.valueIndexOffset), keyCount + 1, sizeof (uint64_t), mapSize) ||
+	    !sectionInFile (le64toh (header.valuesOffset), le64toh (header.valuesSize), mapSize) ||
+	    !arrayInFile (le64toh (header.metaIndexOffset), metaSetCount + 1, sizeof (uint64_t), mapSize) ||
+	    !sectionInFile (le64toh (header.metaSetsOffset), le64toh (header.metaSetsSize), mapSize))
+	{
+		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERROR (errorKey, "Columnar file is truncated or its header is corrupted");
+		return false;
+	}
+
+	snapshot->keyCount = keyCount;
+	snapshot->blockCount = blockCount;
+	snapshot->names = (const unsigned char *) snapshot->map + le64toh (header.namesOffset);
+	snapshot->namesSize = le64toh (header.namesSize);
+	snapshot->blocks = (const uint64_t *) (snapshot->map + le64toh (header.blocksOffset));
+	snapshot->infos = (const uint32_t *) (snapshot->map + le64toh (header.infosOffset));
+	snapshot->valueIndex = (const uint64_t *) (snapshot->map + le64toh (header.valueIndexOffset));
+	snapshot->values = snapshot->map + le64toh (header.valuesOffset);
+	snapshot->valuesSize = le64toh (header.valuesSize);
+	snapshot->metaSetCount = metaSetCount;
+	snapshot->metaIndex = (const uint64_t *) (snapshot->map + le64toh (header.metaIndexOffset));
+	snapshot->metaSets = (const unsigned char *) snapshot->map + le64toh (header.metaSetsOffset);
+	snapshot->metaSetsSize = le64toh (header.metaSetsSize);
+
+	for (size_t i = 0; i < blockCount; ++i)
+	{
+		if (le64toh (snapshot->blocks[i]) >= snapshot->namesSize)
+		{
+			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERROR (errorKey, "Columnar file contains an invalid name block");
+			return false;
+		}
+	}
+
+	if (!indexValid (snapshot->valueIndex, snapshot->keyCount, snapshot->valuesSize) ||
+	    !indexValid (snapshot->metaIndex, snapshot->metaSetCount, snapshot->metaSetsSize))
+	{
+		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERROR (errorKey, "Columnar file contains an invalid value or metadata index");
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Maps a columnar file into memory.
+ *
+ * An empty file is a valid snapshot without keys.
+ *
+ * @param filename the file to map
+ * @param errorKey used to report errors
+ *
+ * @return the snapshot, must be closed with elektraColumnarClose()
+ * @retval NULL on errors
+ */
+ColumnarSnapshot * elektraColumnarOpen (const char * filename, Key * errorKey)
+{
+	int fd = open (filename, O_RDONLY);
+	if (fd == -1)
+	{
+		ELEKTRA_SET_ERROR_GET (errorKey);
+		return NULL;
+	}
+
+	struct stat buf;
+	if (fstat (fd, &buf) == -1)
+	{
+		ELEKTRA_SET_ERROR_GET (errorKey);
+		close (fd);
+		return NULL;
+	}
+
+	ColumnarSnapshot * snapshot = elektraCalloc (sizeof (ColumnarSnapshot));
+	if (buf.st_size == 0)
+	{
+		close (fd);
+		return snapshot;
+	}
+
+	snapshot->mapSize = buf.st_size;
+	snapshot->map = mmap (NULL, snapshot->mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	close (fd);
+
+	if (snapshot->map == MAP_FAILED)
+	{
+		ELEKTRA_SET_RESOURCE_ERRORF (errorKey, "Could not map file '%s' into memory. Reason: %s", filename, strerror (errno));
+		elektraFree (snapshot);
+		return NULL;
+	}
+
+	if (!mapSnapshot (snapshot, errorKey))
+	{
+		elektraColumnarClose (snapshot);
+		return NULL;
+	}
+
+	return snapshot;
+}
+
+void elektraColumnarClose (ColumnarSnapshot * snapshot)
+{
+	if (!snapshot) return;
+
+	if (snapshot->map)
+	{
+		munmap (snapshot->map, snapshot->mapSize);
+	}
+	elektraFree (snapshot);
+}
+
+/**
+ * Decodes the name entry at @p cursor into @p name.
+ *
+ * @p name must hold the previous name, of which the entry shares a prefix.
+ */
+static bool decodeName (const ColumnarSnapshot * snapshot, const unsigned char ** cursor, char ** name, size_t * nameSize,
+			size_t * nameAlloc)
+{
+	const unsigned char * end = snapshot->names + snapshot->namesSize;
+	size_t shared;
+	size_t suffixSize;
+
+	if (!elektraColumnarReadSize (cursor, end, &shared) || !elektraColumnarReadSize (cursor, end, &suffixSize) ||
+	    shared > *nameSize || suffixSize > (size_t) (end - *cursor))
+	{
+		return false;
+	}
+
+	if (shared + suffixSize > *nameAlloc)
+	{
+		*nameAlloc = 2 * (shared + suffixSize);
+		if (elektraRealloc ((void **) name, *nameAlloc) < 0) return false;
+	}
+
+	memcpy (*name + shared, *cursor, suffixSize);
+	*cursor += suffixSize;
+	*nameSize = shared + suffixSize;
+	return true;
+}
+
+// orders names like the unescaped names in a KeySet
+static int compareNames (const char * a, size_t aSize, const char * b, size_t bSize)
+{
+	int result = memcmp (a, b, aSize < bSize ? aSize : bSize);
+	if (result != 0) return result;
+	return aSize < bSize ? -1 : aSize > bSize;
+}
+
+/**
+ * Searches a key by its name.
+ *
+ * Bisects the names stored in full at the start of every block and then
+ * decodes only the names within the one matching block.
+ *
+ * @param snapshot the mapped file
+ * @param name the unescaped name relative to the parent key, see elektraColumnarRelativeOffset()
+ * @param nameSize the size of @p name
+ *
+ * @return the index of the key
+ * @retval -1 if there is no such key
+ */
+ssize_t elektraColumnarLookup (const ColumnarSnapshot * snapshot, const char * name, size_t nameSize)
+{
+	const unsigned char * end = snapshot->names + snapshot->namesSize;
+
+	size_t left = 0;
+	size_t right = snapshot->blockCount;
+	while (left < right)
+	{
+		size_t middle = left + (right - left) / 2;
+		const unsigned char * cursor = snapshot->names + le64toh (snapshot->blocks[middle]);
+		size_t shared;
+		size_t size;
+		if (!elektraColumnarReadSize (&cursor, end, &shared) || !elektraColumnarReadSize (&cursor, end, &size) || shared != 0 ||
+		    size > (size_t) (end - cursor))
+		{
+			return -1;
+		}
+
+		if (compareNames ((const char *) cursor, size, name, nameSize) <= 0)
+		{
+			left = middle + 1;
+		}
+		else
+		{
+			right = middle;
+		}
+	}
+
+	if (left == 0) return -1;
+
+	size_t block = left - 1;
+	const unsigned char * cursor = snapshot->names + le64toh (snapshot->blocks[block]);
+	size_t first = block * COLUMNAR_BLOCK_SIZE;
+	size_t last = first + COLUMNAR_BLOCK_SIZE < snapshot->keyCount ? first + COLUMNAR_BLOCK_SIZE : snapshot->keyCount;
+
+	char * current = NULL;
+	size_t currentSize = 0;
+	size_t currentAlloc = 0;
+	ssize_t found = -1;
+	for (size_t i = first; i < last; ++i)
+	{
+		if (!decodeName (snapshot, &cursor, &current, &currentSize, &currentAlloc)) break;
+
+		int result = compareNames (current, currentSize, name, nameSize);
+		if (result == 0) found = i;
+		if (result >= 0) break;
+	}
+
+	elektraFree (current);
+	return found;
+}
+
+/**
+ * Searches @p key in a snapshot that was written for @p parentKey.
+ *
+ * @return the index of the key
+ * @retval -1 if there is no such key or it is not below @p parentKey
+ */
+ssize_t elektraColumnarLookupKey (const ColumnarSnapshot * snapshot, const Key * parentKey, const Key * key)
+{
+	size_t offset = elektraColumnarRelativeOffset (parentKey);
+	size_t keySize = keyGetUnescapedNameSize (key);
+	const char * keyUName = keyUnescapedName (key);
+
+	if (keySize < offset || memcmp (keyUName, keyUnescapedName (parentKey), offset) != 0)
+	{
+		return -1;
+	}
+
+	return elektraColumnarLookup (snapshot, keyUName + offset, keySize - offset);
+}
+
+/**
+ * Calls @p callback with the name of every key in order.
+ *
+ * Only the name column is read, the values and metadata are not touched.
+ * The name passed to @p callback is only valid during the call.
+ *
+ * @return the first non-zero return value of @p callback
+ * @retval 0 if all names were passed to @p callback
+ * @retval -1 if the name column is corrupted
+ */
+int elektraColumnarForEachName (const ColumnarSnapshot * snapshot, ColumnarNameCallback callback, void * data)
+{
+	const unsigned char * cursor = snapshot->names;
+	char * name = NULL;
+	size_t nameSize = 0;
+	size_t nameAlloc = 0;
+
+	int result = 0;
+	for (size_t i = 0; i < snapshot->keyCount && result == 0; ++i)
+	{
+		if (!decodeName (snapshot, &cursor, &name, &nameSize, &nameAlloc))
+		{
+			result = -1;
+			break;
+		}
+		result = callback (i, name, nameSize, data);
+	}
+
+	elektraFree (name);
+	return result;
+}
+
+/**
+ * Returns the value of the key at @p index without copying it.
+ *
+ * @param valueSize set to the size of the value, for strings including the null terminator
+ * @param binary set to whether the key has a binary value
+ *
+ * @return pointer into the mapped file, valid until elektraColumnarClose()
+ */
+const char * elektraColumnarValue (const ColumnarSnapshot * snapshot, size_t index, size_t * valueSize, bool * binary)
+{
+	uint64_t begin = le64toh (snapshot->valueIndex[index]);
+	*valueSize = le64toh (snapshot->valueIndex[index + 1]) - begin;
+	*binary = (le32toh (snapshot->infos[index]) & COLUMNAR_BINARY_FLAG) != 0;
+	return snapshot->values + begin;
+}
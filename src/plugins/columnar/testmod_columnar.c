@@ -0,0 +1,352 @@
+/**
+ * @file
+ *
+ * @brief Tests for columnar plugin
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <kdbconfig.h>
+#include <kdbendian.h>
+
+#include <tests_plugin.h>
+
+#include "columnar.h"
+
+static KeySet * roundtrip (KeySet * input, const char * parentName)
+{
+	char * outfile = elektraStrDup (elektraFilename ());
+	KeySet * actual = ksNew (0, KS_END);
+
+	{
+		Key * setKey = keyNew (parentName, KEY_VALUE, outfile, KEY_END);
+
+		KeySet * conf = ksNew (0, KS_END);
+		PLUGIN_OPEN ("columnar");
+
+		succeed_if (plugin->kdbSet (plugin, input, setKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+
+		keyDel (setKey);
+		PLUGIN_CLOSE ();
+	}
+
+	{
+		Key * getKey = keyNew (parentName, KEY_VALUE, outfile, KEY_END);
+
+		KeySet * conf = ksNew (0, KS_END);
+		PLUGIN_OPEN ("columnar");
+
+		succeed_if (plugin->kdbGet (plugin, actual, getKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+
+		keyDel (getKey);
+		PLUGIN_CLOSE ();
+	}
+
+	remove (outfile);
+	elektraFree (outfile);
+
+	return actual;
+}
+
+static void test_basics (void)
+{
+	printf ("test basics\n");
+
+	KeySet * input = ksNew (
+		10, keyNew ("dir:/tests/bench", KEY_VALUE, "parent", KEY_END), keyNew ("dir:/tests/bench/a", KEY_VALUE, "a", KEY_END),
+		keyNew ("dir:/tests/bench/a/b", KEY_VALUE, "", KEY_META, "type", "string", KEY_META, "order", "1", KEY_END),
+		keyNew ("dir:/tests/bench/a\\/b", KEY_BINARY, KEY_SIZE, 3, KEY_VALUE, "\0x\0", KEY_END),
+		keyNew ("dir:/tests/bench/empty", KEY_BINARY, KEY_END), keyNew ("dir:/tests/bench/#0", KEY_VALUE, "array", KEY_END),
+		keyNew ("dir:/tests/bench/\\%", KEY_VALUE, "percent", KEY_META, "type", "string", KEY_END),
+		keyNew ("dir:/tests/bench/%/x", KEY_VALUE, "empty part", KEY_END), KS_END);
+
+	KeySet * actual = roundtrip (input, "dir:/tests/bench");
+	compare_keyset (input, actual);
+
+	Key * binary = ksLookupByName (actual, "dir:/tests/bench/a\\/b", 0);
+	succeed_if (binary != NULL && keyIsBinary (binary) && keyGetValueSize (binary) == 3, "binary value not restored");
+	succeed_if (binary != NULL && memcmp (keyValue (binary), "\0x\0", 3) == 0, "binary value differs");
+
+	Key * empty = ksLookupByName (actual, "dir:/tests/bench/empty", 0);
+	succeed_if (empty != NULL && keyIsBinary (empty) && keyGetValueSize (empty) == 0, "empty binary value not restored");
+
+	ksDel (actual);
+	ksDel (input);
+}
+
+static void test_rootParent (void)
+{
+	printf ("test root parent\n");
+
+	KeySet * input = ksNew (3, keyNew ("user:/", KEY_VALUE, "root", KEY_END), keyNew ("user:/a", KEY_VALUE, "a", KEY_END),
+				keyNew ("user:/a/b", KEY_VALUE, "b", KEY_END), KS_END);
+
+	KeySet * actual = roundtrip (input, "user:/");
+	compare_keyset (input, actual);
+	ksDel (actual);
+	ksDel (input);
+
+	input = ksNew (2, keyNew ("/", KEY_VALUE, "root", KEY_END), keyNew ("/x/y", KEY_VALUE, "y", KEY_END), KS_END);
+
+	actual = roundtrip (input, "/");
+	compare_keyset (input, actual);
+	ksDel (actual);
+	ksDel (input);
+}
+
+static void test_notBelowParent (void)
+{
+	printf ("test not below parent\n");
+
+	char * outfile = elektraStrDup (elektraFilename ());
+	KeySet * input = ksNew (2, keyNew ("dir:/tests/bench/a", KEY_END), keyNew ("dir:/tests/other", KEY_END), KS_END);
+	Key * setKey = keyNew ("dir:/tests/bench", KEY_VALUE, outfile, KEY_END);
+
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("columnar");
+
+	succeed_if (plugin->kdbSet (plugin, input, setKey) == ELEKTRA_PLUGIN_STATUS_ERROR, "kdbSet should fail");
+	succeed_if (keyGetMeta (setKey, "error") != NULL, "no error set");
+
+	keyDel (setKey);
+	PLUGIN_CLOSE ();
+
+	remove (outfile);
+	elektraFree (outfile);
+	ksDel (input);
+}
+
+static void test_sharedMeta (void)
+{
+	printf ("test shared meta\n");
+
+	// more keys than a single metakey can be shared with
+	const size_t count = 140000;
+	KeySet * input = ksNew (count, KS_END);
+	char name[64];
+	for (size_t i = 0; i < count; ++i)
+	{
+		snprintf (name, sizeof (name), "dir:/tests/bench/#_%zu", i);
+		ksAppendKey (input, keyNew (name, KEY_VALUE, "value", KEY_META, "type", i % 2 == 0 ? "string" : "long", KEY_META,
+					    "check/range", "0-10", KEY_END));
+	}
+
+	KeySet * actual = roundtrip (input, "dir:/tests/bench");
+	succeed_if (ksGetSize (actual) == (ssize_t) count, "wrong number of keys");
+
+	Key * first = ksLookupByName (actual, "dir:/tests/bench/#_0", 0);
+	Key * third = ksLookupByName (actual, "dir:/tests/bench/#_2", 0);
+	succeed_if (keyGetMeta (first, "type") == keyGetMeta (third, "type"), "metadata should be shared");
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		Key * key = ksAtCursor (actual, i);
+		// the keys are not sorted numerically, the number is part of the name
+		size_t number = strtoul (keyBaseName (key) + 2, NULL, 10);
+		if (strcmp (keyString (keyGetMeta (key, "type")), number % 2 == 0 ? "string" : "long") != 0 ||
+		    strcmp (keyString (keyGetMeta (key, "check/range")), "0-10") != 0)
+		{
+			yield_error ("wrong metadata");
+			break;
+		}
+	}
+
+	ksDel (actual);
+	ksDel (input);
+}
+
+static void test_sharedBinaryMeta (void)
+{
+	printf ("test shared binary meta\n");
+
+	// binary keys have meta:/binary in addition to the shared metadata
+	const size_t count = 70000;
+	KeySet * input = ksNew (count, KS_END);
+	char name[64];
+	for (size_t i = 0; i < count; ++i)
+	{
+		snprintf (name, sizeof (name), "dir:/tests/bench/#_%zu", i);
+		Key * key = keyNew (name, KEY_META, "type", "octet", KEY_END);
+		unsigned char value = i % 256;
+		keySetBinary (key, &value, sizeof (value));
+		ksAppendKey (input, key);
+	}
+
+	KeySet * actual = roundtrip (input, "dir:/tests/bench");
+	succeed_if (ksGetSize (actual) == (ssize_t) count, "wrong number of keys");
+
+	Key * first = ksLookupByName (actual, "dir:/tests/bench/#_0", 0);
+	Key * second = ksLookupByName (actual, "dir:/tests/bench/#_1", 0);
+	succeed_if (keyGetMeta (first, "type") == keyGetMeta (second, "type"), "metadata should be shared");
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		Key * key = ksAtCursor (actual, i);
+		size_t number = strtoul (keyBaseName (key) + 2, NULL, 10);
+		const Key * type = keyGetMeta (key, "type");
+		if (!keyIsBinary (key) || type == NULL || strcmp (keyString (type), "octet") != 0 || keyGetValueSize (key) != 1 ||
+		    *(const unsigned char *) keyValue (key) != number % 256)
+		{
+			yield_error ("wrong binary key");
+			break;
+		}
+	}
+
+	ksDel (actual);
+	ksDel (input);
+}
+
+static int collectNames (size_t index, const char * name ELEKTRA_UNUSED, size_t nameSize ELEKTRA_UNUSED, void * data)
+{
+	size_t * next = data;
+	if (index != *next) return -1;
+	++*next;
+	return 0;
+}
+
+static void test_snapshot (void)
+{
+	printf ("test snapshot\n");
+
+	char * outfile = elektraStrDup (elektraFilename ());
+	KeySet * input = ksNew (0, KS_END);
+	char name[64];
+	for (size_t i = 0; i < 100; ++i)
+	{
+		snprintf (name, sizeof (name), "user:/tests/columnar/section/#_%zu", i);
+		ksAppendKey (input, keyNew (name, KEY_VALUE, name + sizeof ("user:/tests/columnar/section/") - 1, KEY_END));
+	}
+
+	Key * parentKey = keyNew ("user:/tests/columnar", KEY_VALUE, outfile, KEY_END);
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("columnar");
+	succeed_if (plugin->kdbSet (plugin, input, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+
+	ColumnarSnapshot * snapshot = elektraColumnarOpen (outfile, parentKey);
+	exit_if_fail (snapshot != NULL, "could not open snapshot");
+	succeed_if (snapshot->keyCount == 100, "wrong key count");
+
+	for (elektraCursor it = 0; it < ksGetSize (input); ++it)
+	{
+		Key * cur = ksAtCursor (input, it);
+		ssize_t index = elektraColumnarLookupKey (snapshot, parentKey, cur);
+		succeed_if (index == it, "lookup returned wrong index");
+
+		size_t valueSize;
+		bool binary;
+		const char * value = elektraColumnarValue (snapshot, index, &valueSize, &binary);
+		succeed_if (!binary && (ssize_t) valueSize == keyGetValueSize (cur), "wrong value size");
+		succeed_if_same_string (value, keyString (cur));
+	}
+
+	Key * missing = keyNew ("user:/tests/columnar/section/#_50/x", KEY_END);
+	succeed_if (elektraColumnarLookupKey (snapshot, parentKey, missing) == -1, "found missing key");
+	keySetName (missing, "user:/tests/columnar/a");
+	succeed_if (elektraColumnarLookupKey (snapshot, parentKey, missing) == -1, "found key before first");
+	keySetName (missing, "user:/tests/columnar/z");
+	succeed_if (elektraColumnarLookupKey (snapshot, parentKey, missing) == -1, "found key after last");
+	keySetName (missing, "user:/tests/other");
+	succeed_if (elektraColumnarLookupKey (snapshot, parentKey, missing) == -1, "found key not below parent");
+	keyDel (missing);
+
+	size_t next = 0;
+	succeed_if (elektraColumnarForEachName (snapshot, collectNames, &next) == 0, "iterating names failed");
+	succeed_if (next == 100, "not all names visited");
+
+	elektraColumnarClose (snapshot);
+
+	PLUGIN_CLOSE ();
+	keyDel (parentKey);
+	remove (outfile);
+	elektraFree (outfile);
+	ksDel (input);
+}
+
+static void test_emptyFile (void)
+{
+	printf ("test empty file\n");
+
+	char * outfile = elektraStrDup (elektraFilename ());
+	FILE * file = fopen (outfile, "w");
+	fclose (file);
+
+	Key * getKey = keyNew ("dir:/tests/bench", KEY_VALUE, outfile, KEY_END);
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("columnar");
+
+	KeySet * actual = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGet (plugin, actual, getKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+	succeed_if (ksGetSize (actual) == 0, "empty file should not contain keys");
+	ksDel (actual);
+
+	keyDel (getKey);
+	PLUGIN_CLOSE ();
+	remove (outfile);
+	elektraFree (outfile);
+}
+
+static void test_truncatedFile (void)
+{
+	printf ("test truncated file\n");
+
+	char * outfile = elektraStrDup (elektraFilename ());
+	KeySet * input = ksNew (2, keyNew ("dir:/tests/bench/a", KEY_VALUE, "a", KEY_END),
+				keyNew ("dir:/tests/bench/b", KEY_VALUE, "b", KEY_META, "type", "string", KEY_END), KS_END);
+
+	Key * parentKey = keyNew ("dir:/tests/bench", KEY_VALUE, outfile, KEY_END);
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("columnar");
+	succeed_if (plugin->kdbSet (plugin, input, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+
+	// the padding after the last section is not needed
+	ColumnarHeader header;
+	FILE * file = fopen (outfile, "rb");
+	succeed_if (fread (&header, sizeof (header), 1, file) == 1, "could not read header");
+	fclose (file);
+	long size = le64toh (header.metaSetsOffset) + le64toh (header.metaSetsSize);
+
+	for (long truncated = size - 1; truncated > 0; truncated -= 7)
+	{
+		succeed_if (truncate (outfile, truncated) == 0, "could not truncate file");
+
+		KeySet * actual = ksNew (0, KS_END);
+		Key * getKey = keyNew ("dir:/tests/bench", KEY_VALUE, outfile, KEY_END);
+		succeed_if (plugin->kdbGet (plugin, actual, getKey) == ELEKTRA_PLUGIN_STATUS_ERROR, "truncated file should not be read");
+		succeed_if (keyGetMeta (getKey, "error") != NULL, "no error set");
+		keyDel (getKey);
+		ksDel (actual);
+	}
+
+	PLUGIN_CLOSE ();
+	keyDel (parentKey);
+	remove (outfile);
+	elektraFree (outfile);
+	ksDel (input);
+}
+
+int main (int argc, char ** argv)
+{
+	printf ("COLUMNAR       TESTS\n");
+	printf ("==================\n\n");
+
+	init (argc, argv);
+
+	test_basics ();
+	test_rootParent ();
+	test_notBelowParent ();
+	test_sharedMeta ();
+	test_sharedBinaryMeta ();
+	test_snapshot ();
+	test_emptyFile ();
+	test_truncatedFile ();
+
+	print_result ("testmod_columnar");
+
+	return nbError;
+}
@@ -27,6 +27,7 @@
 #include "conditionals.h"
 
 #define EPSILON 0.00001
+#define MAX_COMPILED_CONDITIONS 4096 ///< the cache is cleared when it would grow beyond this
 
 #define REGEX_FLAGS_CONDITION (REG_EXTENDED)
 
@@ -58,6 +59,39 @@ typedef enum
 	NOEXPR = -3,
 } CondResult;
 
+/**
+ * A condition string split into its parts, see compileConditionString().
+ * If the condition string has invalid syntax, all parts are NULL.
+ */
+typedef struct
+{
+	char * conditionString; ///< the value of the metakey, key of the CompiledConditionMap
+	size_t hash;
+
+	char * condition;
+	char * thenExpr;
+	char * elseExpr;
+} CompiledCondition;
+
+/**
+ * Hash map (open addressing, linear probing) from condition strings to their compiled form.
+ */
+typedef struct
+{
+	CompiledCondition ** entries; ///< NULL for unused slots
+	size_t size;
+	size_t alloc; ///< 0 or a power of two
+} CompiledConditionMap;
+
+typedef struct
+{
+	regex_t conditionRegex;
+	regex_t thenRegex;
+	regex_t elseRegex;
+	regex_t bracketRegex;
+	CompiledConditionMap compiled;
+} Conditionals;
+
 static int isValidSuffix (char * suffix, const Key * suffixList)
 {
 	if (!suffixList) return 0;
@@ -554,28 +588,17 @@ static const char * isAssign (Key * key, char * expr, Key * parentKey, KeySet *
 	}
 }
 
-static CondResult parseCondition (Key * key, const char * condition, const Key * suffixList, KeySet * ks, Key * parentKey)
+static CondResult parseCondition (Conditionals * data, Key * key, const char * condition, const Key * suffixList, KeySet * ks,
+				  Key * parentKey)
 {
 	CondResult result = FALSE;
-	const char * regexString = "((\\(([^\\(\\)]*)\\)))";
-	regex_t regex;
-
-	if ((regcomp (&regex, regexString, REG_EXTENDED | REG_NEWLINE)))
-	{
-		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (parentKey); // the regex compiles so the only
-		// possible error would be out of
-		// memory
-		ksDel (ks);
-		return ERROR;
-	}
-
 	char * localCondition = elektraStrDup (condition);
 	size_t subMatches = 4;
 	regmatch_t m[subMatches];
 	char * ptr = localCondition;
 	while (1)
 	{
-		int nomatch = regexec (&regex, ptr, subMatches, m, 0);
+		int nomatch = regexec (&data->bracketRegex, ptr, subMatches, m, 0);
 		if (nomatch)
 		{
 			break;
@@ -601,197 +624,239 @@ static CondResult parseCondition (Key * key, const char * condition, const Key *
 		elektraFree (singleCondition);
 	}
 	elektraFree (localCondition);
-	regfree (&regex);
 	return result;
 }
 
 
-static CondResult parseConditionString (const Key * meta, const Key * suffixList, Key * parentKey, Key * key, KeySet * ks, Operation op)
+static char * copyMatch (const char * string, const regmatch_t * match)
 {
-	const char * conditionString = keyString (meta);
-	const char * regexString1 = "(\\(((.*)?)\\))[[:space:]]*\\?";
-	const char * regexString2 = "\\?[[:space:]]*(\\(((.*)?)\\))";
-	const char * regexString3 = "[[:space:]]*:[[:space:]]*(\\(((.*)?)\\))";
-	regex_t regex1, regex2, regex3;
-	CondResult ret;
-	if ((ret = regcomp (&regex1, regexString1, REGEX_FLAGS_CONDITION)))
+	size_t length = (size_t) (match->rm_eo - match->rm_so);
+	char * copy = elektraMalloc (length + 1);
+	strncpy (copy, string + match->rm_so, length);
+	copy[length] = '\0';
+	return copy;
+}
+
+/**
+ * Splits a condition string of the form `(condition) ? (then) : (else)` into its parts.
+ *
+ * @return a newly allocated CompiledCondition, all parts are NULL if @p conditionString has invalid syntax
+ */
+static CompiledCondition * compileConditionString (Conditionals * data, const char * conditionString)
+{
+	CompiledCondition * compiled = elektraCalloc (sizeof (CompiledCondition));
+	if (compiled == NULL) return NULL;
+
+	size_t subMatches = 6;
+	regmatch_t m[subMatches];
+	if (regexec (&data->conditionRegex, conditionString, subMatches, m, 0) || m[1].rm_so == -1)
 	{
-		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (parentKey); // the regex compiles so the only
-		// possible error would be out of
-		// memory
-		ksDel (ks);
-		return ERROR;
+		return compiled;
 	}
-	if ((ret = regcomp (&regex2, regexString2, REGEX_FLAGS_CONDITION)))
+	char * condition = copyMatch (conditionString, &m[1]);
+
+	if (regexec (&data->thenRegex, conditionString, subMatches, m, 0) || m[1].rm_so == -1)
 	{
-		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (parentKey); // the regex compiles so the only
-		// possible error would be out of
-		// memory
-		regfree (&regex1);
-		ksDel (ks);
-		return ERROR;
+		elektraFree (condition);
+		return compiled;
 	}
-	if ((ret = regcomp (&regex3, regexString3, REGEX_FLAGS_CONDITION)))
+	char * thenExpr = copyMatch (conditionString, &m[1]);
+	char * elseExpr = NULL;
+
+	if (!regexec (&data->elseRegex, conditionString, subMatches, m, 0))
 	{
-		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (parentKey); // the regex compiles so the only
-		// possible error would be out of
-		// memory
-		regfree (&regex1);
-		regfree (&regex2);
-		ksDel (ks);
-		return ERROR;
+		if (m[1].rm_so == -1)
+		{
+			elektraFree (condition);
+			elektraFree (thenExpr);
+			return compiled;
+		}
+		thenExpr[strlen (thenExpr) - (size_t) ((m[0].rm_eo - m[0].rm_so))] = '\0';
+		elseExpr = copyMatch (conditionString, &m[1]);
 	}
-	size_t subMatches = 6;
-	regmatch_t m[subMatches];
-	int nomatch = regexec (&regex1, conditionString, subMatches, m, 0);
-	if (nomatch)
+
+	compiled->condition = condition;
+	compiled->thenExpr = thenExpr;
+	compiled->elseExpr = elseExpr;
+	return compiled;
+}
+
+static void freeCompiledCondition (CompiledCondition * compiled)
+{
+	elektraFree (compiled->conditionString);
+	elektraFree (compiled->condition);
+	elektraFree (compiled->thenExpr);
+	elektraFree (compiled->elseExpr);
+	elektraFree (compiled);
+}
+
+static size_t hashConditionString (const char * conditionString)
+{
+	// FNV-1a
+	size_t hash = 2166136261u;
+	for (const unsigned char * c = (const unsigned char *) conditionString; *c; ++c)
 	{
-		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (
-			parentKey, "Invalid syntax: '%s'. Check kdb plugin-info conditionals for additional information", conditionString);
-		regfree (&regex1);
-		regfree (&regex2);
-		regfree (&regex3);
-		ksDel (ks);
-		return ERROR;
+		hash = (hash ^ *c) * 16777619u;
+	}
+	return hash;
+}
+
+static void clearCompiledConditions (CompiledConditionMap * map)
+{
+	for (size_t i = 0; i < map->alloc; ++i)
+	{
+		if (map->entries[i] != NULL) freeCompiledCondition (map->entries[i]);
 	}
-	if (m[1].rm_so == -1)
+	elektraFree (map->entries);
+	map->entries = NULL;
+	map->size = 0;
+	map->alloc = 0;
+}
+
+static void insertCompiledCondition (CompiledConditionMap * map, CompiledCondition * compiled)
+{
+	size_t i = compiled->hash & (map->alloc - 1);
+	while (map->entries[i] != NULL)
 	{
-		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (
-			parentKey, "Invalid syntax: '%s'. Check kdb plugin-info conditionals for additional information", conditionString);
-		regfree (&regex1);
-		regfree (&regex2);
-		regfree (&regex3);
-		ksDel (ks);
+		i = (i + 1) & (map->alloc - 1);
+	}
+	map->entries[i] = compiled;
+	++map->size;
+}
+
+static int growCompiledConditions (CompiledConditionMap * map)
+{
+	CompiledConditionMap grown = { .size = 0, .alloc = map->alloc ? map->alloc * 2 : 16 };
+	grown.entries = elektraCalloc (grown.alloc * sizeof (CompiledCondition *));
+	if (grown.entries == NULL) return -1;
+
+	for (size_t i = 0; i < map->alloc; ++i)
+	{
+		if (map->entries[i] != NULL) insertCompiledCondition (&grown, map->entries[i]);
+	}
+	elektraFree (map->entries);
+	*map = grown;
+	return 0;
+}
+
+/**
+ * Returns the compiled form of @p conditionString.
+ *
+ * Metadata is often shared between many keys (e.g. via keyCopyMeta), so the
+ * result is cached until the plugin is closed. To bound the memory, the cache
+ * is cleared once it holds #MAX_COMPILED_CONDITIONS condition strings.
+ *
+ * @retval NULL on memory problems
+ */
+static const CompiledCondition * lookupCompiledCondition (Conditionals * data, const char * conditionString)
+{
+	CompiledConditionMap * map = &data->compiled;
+	size_t hash = hashConditionString (conditionString);
+	for (size_t i = hash & (map->alloc - 1); map->alloc > 0 && map->entries[i] != NULL; i = (i + 1) & (map->alloc - 1))
+	{
+		if (map->entries[i]->hash == hash && !strcmp (map->entries[i]->conditionString, conditionString))
+		{
+			return map->entries[i];
+		}
+	}
+
+	if (map->size >= MAX_COMPILED_CONDITIONS) clearCompiledConditions (map);
+
+	// keep the load factor below 1/2
+	if (2 * (map->size + 1) > map->alloc && growCompiledConditions (map) == -1) return NULL;
+
+	CompiledCondition * compiled = compileConditionString (data, conditionString);
+	if (compiled == NULL) return NULL;
+	compiled->conditionString = elektraStrDup (conditionString);
+	if (compiled->conditionString == NULL)
+	{
+		freeCompiledCondition (compiled);
+		return NULL;
+	}
+	compiled->hash = hash;
+	insertCompiledCondition (map, compiled);
+	return compiled;
+}
+
+static CondResult assignExpr (Key * key, const char * expr, Key * parentKey, KeySet * ks)
+{
+	// isAssign modifies the expression
+	char * localExpr = elektraStrDup (expr);
+	const char * assign = isAssign (key, localExpr, parentKey, ks);
+	if (assign == NULL)
+	{
+		elektraFree (localExpr);
 		return ERROR;
 	}
-	int startPos = (int) m[1].rm_so;
-	int endPos = (int) m[1].rm_eo;
-	char * condition = elektraMalloc ((size_t) (endPos - startPos + 1));
-	char * thenexpr = NULL;
-	char * elseexpr = NULL;
-	strncpy (condition, conditionString + startPos, (size_t) (endPos - startPos));
-	condition[endPos - startPos] = '\0';
-	nomatch = regexec (&regex2, conditionString, subMatches, m, 0);
-	if (nomatch)
+
+	keySetString (key, assign);
+	elektraFree (localExpr);
+	return TRUE;
+}
+
+static CondResult parseConditionString (Conditionals * data, const Key * meta, const Key * suffixList, Key * parentKey, Key * key,
+					KeySet * ks, Operation op)
+{
+	const char * conditionString = keyString (meta);
+	const CompiledCondition * compiled = lookupCompiledCondition (data, conditionString);
+	if (compiled == NULL)
 	{
-		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (
-			parentKey, "Invalid syntax: '%s'. Check kdb plugin-info conditionals for additional information", conditionString);
-		regfree (&regex1);
-		regfree (&regex2);
-		regfree (&regex3);
-		ksDel (ks);
+		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (parentKey);
 		return ERROR;
 	}
-	if (m[1].rm_so == -1)
+	if (compiled->condition == NULL)
 	{
 		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (
 			parentKey, "Invalid syntax: '%s'. Check kdb plugin-info conditionals for additional information", conditionString);
-		regfree (&regex1);
-		regfree (&regex2);
-		regfree (&regex3);
-		ksDel (ks);
 		return ERROR;
 	}
 
-	startPos = (int) m[1].rm_so;
-	endPos = (int) m[1].rm_eo;
-	thenexpr = elektraMalloc ((size_t) (endPos - startPos + 1));
-	strncpy (thenexpr, conditionString + startPos, (size_t) (endPos - startPos));
-	thenexpr[endPos - startPos] = '\0';
+	const char * condition = compiled->condition;
+	const char * thenexpr = compiled->thenExpr;
+	const char * elseexpr = compiled->elseExpr;
 
-	nomatch = regexec (&regex3, conditionString, subMatches, m, 0);
-	if (!nomatch)
+	CondResult ret = parseCondition (data, key, condition, suffixList, ks, parentKey);
+	if (ret == TRUE)
 	{
-		if (m[1].rm_so == -1)
+		if (op == ASSIGN)
+		{
+			return assignExpr (key, thenexpr, parentKey, ks);
+		}
+
+		ret = parseCondition (data, key, thenexpr, suffixList, ks, parentKey);
+		if (ret == FALSE)
+		{
+			ELEKTRA_SET_VALIDATION_SEMANTIC_ERRORF (parentKey, "Validation of Key %s: %s failed. (%s failed)",
+								keyName (key) + strlen (keyName (parentKey)) + 1, conditionString, thenexpr);
+		}
+		else if (ret == ERROR)
 		{
 			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (
-				parentKey, "Invalid syntax: '%s'. Check kdb plugin-info conditionals for additional information",
-				conditionString);
-			regfree (&regex1);
-			regfree (&regex2);
-			regfree (&regex3);
-			ksDel (ks);
-			return ERROR;
+				parentKey, "Invalid syntax: '%s'. Check kdb plugin-info conditionals for additional information", thenexpr);
 		}
-		thenexpr[strlen (thenexpr) - (size_t) ((m[0].rm_eo - m[0].rm_so))] = '\0';
-		startPos = (int) m[1].rm_so;
-		endPos = (int) m[1].rm_eo;
-		elseexpr = elektraMalloc ((size_t) (endPos - startPos + 1));
-		strncpy (elseexpr, conditionString + startPos, (size_t) (endPos - startPos));
-		elseexpr[endPos - startPos] = '\0';
 	}
-
-	ret = parseCondition (key, condition, suffixList, ks, parentKey);
-	if (ret == TRUE)
+	else if (ret == FALSE)
 	{
-		if (op == ASSIGN)
+		if (elseexpr)
 		{
-			const char * assign = isAssign (key, thenexpr, parentKey, ks);
-			if (assign != NULL)
-			{
-				keySetString (key, assign);
-				ret = TRUE;
-				goto CleanUp;
-			}
-			else
+			if (op == ASSIGN)
 			{
-				ret = ERROR;
-				goto CleanUp;
+				return assignExpr (key, elseexpr, parentKey, ks);
 			}
-		}
-		else
-		{
-			ret = parseCondition (key, thenexpr, suffixList, ks, parentKey);
+
+			ret = parseCondition (data, key, elseexpr, suffixList, ks, parentKey);
+
 			if (ret == FALSE)
 			{
 				ELEKTRA_SET_VALIDATION_SEMANTIC_ERRORF (parentKey, "Validation of Key %s: %s failed. (%s failed)",
 									keyName (key) + strlen (keyName (parentKey)) + 1, conditionString,
-									thenexpr);
+									elseexpr);
 			}
 			else if (ret == ERROR)
 			{
 				ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (
 					parentKey, "Invalid syntax: '%s'. Check kdb plugin-info conditionals for additional information",
-					thenexpr);
-			}
-		}
-	}
-	else if (ret == FALSE)
-	{
-		if (elseexpr)
-		{
-			if (op == ASSIGN)
-			{
-				const char * assign = isAssign (key, elseexpr, parentKey, ks);
-				if (assign != NULL)
-				{
-					keySetString (key, assign);
-					ret = TRUE;
-					goto CleanUp;
-				}
-				else
-				{
-					ret = ERROR;
-					goto CleanUp;
-				}
-			}
-			else
-			{
-				ret = parseCondition (key, elseexpr, suffixList, ks, parentKey);
-
-				if (ret == FALSE)
-				{
-					ELEKTRA_SET_VALIDATION_SEMANTIC_ERRORF (parentKey, "Validation of Key %s: %s failed. (%s failed)",
-										keyName (key) + strlen (keyName (parentKey)) + 1,
-										conditionString, elseexpr);
-				}
-				else if (ret == ERROR)
-				{
-					ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (
-						parentKey,
-						"Invalid syntax: '%s'. Check kdb plugin-info conditionals for additional information",
-						elseexpr);
-				}
+					elseexpr);
 			}
 		}
 		else
@@ -805,21 +870,17 @@ static CondResult parseConditionString (const Key * meta, const Key * suffixList
 			parentKey, "Invalid syntax: '%s'. Check kdb plugin-info conditionals for additional information", condition);
 	}
 
-CleanUp:
-	elektraFree (condition);
-	elektraFree (thenexpr);
-	if (elseexpr) elektraFree (elseexpr);
-	regfree (&regex1);
-	regfree (&regex2);
-	regfree (&regex3);
-	ksDel (ks);
 	return ret;
 }
 
-static CondResult evaluateKey (const Key * meta, const Key * suffixList, Key * parentKey, Key * key, KeySet * ks, Operation op)
+static CondResult evaluateKey (Conditionals * data, const Key * meta, const Key * suffixList, Key * parentKey, Key * key, KeySet * ks,
+			       Operation op)
 {
 	CondResult result;
-	result = parseConditionString (meta, suffixList, parentKey, key, ksDup (ks), op);
+	// lookups move the cursor, but the callers iterate over ks
+	elektraCursor cursor = ksGetCursor (ks);
+	result = parseConditionString (data, meta, suffixList, parentKey, key, ks, op);
+	ksSetCursor (ks, cursor);
 	if (result == ERROR)
 	{
 		return ERROR;
@@ -839,7 +900,8 @@ static CondResult evaluateKey (const Key * meta, const Key * suffixList, Key * p
 	return TRUE;
 }
 
-static CondResult evalMultipleConditions (Key * key, const Key * meta, const Key * suffixList, Key * parentKey, KeySet * returned)
+static CondResult evalMultipleConditions (Conditionals * data, Key * key, const Key * meta, const Key * suffixList, Key * parentKey,
+					  KeySet * returned)
 {
 	int countSucceeded = 0;
 	int countFailed = 0;
@@ -850,7 +912,7 @@ static CondResult evalMultipleConditions (Key * key, const Key * meta, const Key
 	while ((c = ksNext (condKS)) != NULL)
 	{
 		if (!keyCmp (c, meta)) continue;
-		result = evaluateKey (c, suffixList, parentKey, key, returned, CONDITION);
+		result = evaluateKey (data, c, suffixList, parentKey, key, returned, CONDITION);
 		if (result == TRUE)
 			++countSucceeded;
 		else if (result == ERROR)
@@ -885,7 +947,66 @@ static CondResult evalMultipleConditions (Key * key, const Key * meta, const Key
 	}
 }
 
-int elektraConditionalsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA_UNUSED, Key * parentKey ELEKTRA_UNUSED)
+int elektraConditionalsOpen (Plugin * handle, Key * errorKey)
+{
+	Conditionals * data = elektraCalloc (sizeof (Conditionals));
+
+	// the regexes compile, so the only possible error would be out of memory
+	if (regcomp (&data->conditionRegex, "(\\(((.*)?)\\))[[:space:]]*\\?", REGEX_FLAGS_CONDITION))
+	{
+		elektraFree (data);
+		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (errorKey);
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+	if (regcomp (&data->thenRegex, "\\?[[:space:]]*(\\(((.*)?)\\))", REGEX_FLAGS_CONDITION))
+	{
+		regfree (&data->conditionRegex);
+		elektraFree (data);
+		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (errorKey);
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+	if (regcomp (&data->elseRegex, "[[:space:]]*:[[:space:]]*(\\(((.*)?)\\))", REGEX_FLAGS_CONDITION))
+	{
+		regfree (&data->conditionRegex);
+		regfree (&data->thenRegex);
+		elektraFree (data);
+		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (errorKey);
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+	if (regcomp (&data->bracketRegex, "((\\(([^\\(\\)]*)\\)))", REG_EXTENDED | REG_NEWLINE))
+	{
+		regfree (&data->conditionRegex);
+		regfree (&data->thenRegex);
+		regfree (&data->elseRegex);
+		elektraFree (data);
+		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (errorKey);
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+
+	elektraPluginSetData (handle, data);
+	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
+
+int elektraConditionalsClose (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
+{
+	Conditionals * data = elektraPluginGetData (handle);
+	if (data == NULL)
+	{
+		return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+	}
+
+	clearCompiledConditions (&data->compiled);
+
+	regfree (&data->conditionRegex);
+	regfree (&data->thenRegex);
+	regfree (&data->elseRegex);
+	regfree (&data->bracketRegex);
+	elektraFree (data);
+	elektraPluginSetData (handle, NULL);
+	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
+
+int elektraConditionalsGet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
 	if (!strcmp (keyName (parentKey), "system:/elektra/modules/conditionals"))
 	{
@@ -893,6 +1014,8 @@ int elektraConditionalsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 			30,
 			keyNew ("system:/elektra/modules/conditionals", KEY_VALUE, "conditionals plugin waits for your orders", KEY_END),
 			keyNew ("system:/elektra/modules/conditionals/exports", KEY_END),
+			keyNew ("system:/elektra/modules/conditionals/exports/open", KEY_FUNC, elektraConditionalsOpen, KEY_END),
+			keyNew ("system:/elektra/modules/conditionals/exports/close", KEY_FUNC, elektraConditionalsClose, KEY_END),
 			keyNew ("system:/elektra/modules/conditionals/exports/get", KEY_FUNC, elektraConditionalsGet, KEY_END),
 			keyNew ("system:/elektra/modules/conditionals/exports/set", KEY_FUNC, elektraConditionalsSet, KEY_END),
 #include ELEKTRA_README
@@ -902,6 +1025,7 @@ int elektraConditionalsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 
 		return 1; /* success */
 	}
+	Conditionals * data = elektraPluginGetData (handle);
 	Key * cur;
 	ksRewind (returned);
 	CondResult ret = FALSE;
@@ -918,7 +1042,7 @@ int elektraConditionalsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 		{
 			CondResult result;
 
-			result = evaluateKey (conditionMeta, suffixList, parentKey, cur, returned, CONDITION);
+			result = evaluateKey (data, conditionMeta, suffixList, parentKey, cur, returned, CONDITION);
 			if (result == NOEXPR)
 			{
 				ret |= TRUE;
@@ -931,19 +1055,19 @@ int elektraConditionalsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 		else if (allConditionMeta)
 		{
 			CondResult result;
-			result = evalMultipleConditions (cur, allConditionMeta, suffixList, parentKey, returned);
+			result = evalMultipleConditions (data, cur, allConditionMeta, suffixList, parentKey, returned);
 			ret |= result;
 		}
 		else if (anyConditionMeta)
 		{
 			CondResult result;
-			result = evalMultipleConditions (cur, anyConditionMeta, suffixList, parentKey, returned);
+			result = evalMultipleConditions (data, cur, anyConditionMeta, suffixList, parentKey, returned);
 			ret |= result;
 		}
 		else if (noneConditionMeta)
 		{
 			CondResult result;
-			result = evalMultipleConditions (cur, noneConditionMeta, suffixList, parentKey, returned);
+			result = evalMultipleConditions (data, cur, noneConditionMeta, suffixList, parentKey, returned);
 			ret |= result;
 		}
 
@@ -956,7 +1080,7 @@ int elektraConditionalsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 				while ((a = ksNext (assignKS)) != NULL)
 				{
 					if (keyCmp (a, assignMeta) == 0) continue;
-					CondResult result = evaluateKey (a, suffixList, parentKey, cur, returned, ASSIGN);
+					CondResult result = evaluateKey (data, a, suffixList, parentKey, cur, returned, ASSIGN);
 					if (result == TRUE)
 					{
 						ret |= TRUE;
@@ -975,7 +1099,7 @@ int elektraConditionalsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 			}
 			else
 			{
-				ret |= evaluateKey (assignMeta, suffixList, parentKey, cur, returned, ASSIGN);
+				ret |= evaluateKey (data, assignMeta, suffixList, parentKey, cur, returned, ASSIGN);
 			}
 		}
 	}
@@ -984,8 +1108,9 @@ int elektraConditionalsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 }
 
 
-int elektraConditionalsSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA_UNUSED, Key * parentKey ELEKTRA_UNUSED)
+int elektraConditionalsSet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
+	Conditionals * data = elektraPluginGetData (handle);
 	Key * cur;
 	ksRewind (returned);
 	CondResult ret = FALSE;
@@ -1002,7 +1127,7 @@ int elektraConditionalsSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 		{
 			CondResult result;
 
-			result = evaluateKey (conditionMeta, suffixList, parentKey, cur, returned, CONDITION);
+			result = evaluateKey (data, conditionMeta, suffixList, parentKey, cur, returned, CONDITION);
 			if (result == NOEXPR)
 			{
 				ret |= TRUE;
@@ -1015,19 +1140,19 @@ int elektraConditionalsSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 		else if (allConditionMeta)
 		{
 			CondResult result;
-			result = evalMultipleConditions (cur, allConditionMeta, suffixList, parentKey, returned);
+			result = evalMultipleConditions (data, cur, allConditionMeta, suffixList, parentKey, returned);
 			ret |= result;
 		}
 		else if (anyConditionMeta)
 		{
 			CondResult result;
-			result = evalMultipleConditions (cur, anyConditionMeta, suffixList, parentKey, returned);
+			result = evalMultipleConditions (data, cur, anyConditionMeta, suffixList, parentKey, returned);
 			ret |= result;
 		}
 		else if (noneConditionMeta)
 		{
 			CondResult result;
-			result = evalMultipleConditions (cur, noneConditionMeta, suffixList, parentKey, returned);
+			result = evalMultipleConditions (data, cur, noneConditionMeta, suffixList, parentKey, returned);
 			ret |= result;
 		}
 
@@ -1040,7 +1165,7 @@ int elektraConditionalsSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 				while ((a = ksNext (assignKS)) != NULL)
 				{
 					if (keyCmp (a, assignMeta) == 0) continue;
-					CondResult result = evaluateKey (a, suffixList, parentKey, cur, returned, ASSIGN);
+					CondResult result = evaluateKey (data, a, suffixList, parentKey, cur, returned, ASSIGN);
 					if (result == TRUE)
 					{
 						ret |= TRUE;
@@ -1059,7 +1184,7 @@ int elektraConditionalsSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 			}
 			else
 			{
-				ret |= evaluateKey (assignMeta, suffixList, parentKey, cur, returned, ASSIGN);
+				ret |= evaluateKey (data, assignMeta, suffixList, parentKey, cur, returned, ASSIGN);
 			}
 		}
 	}
@@ -1071,6 +1196,8 @@ Plugin * ELEKTRA_PLUGIN_EXPORT
 {
 	// clang-format off
     return elektraPluginExport ("conditionals",
+	    ELEKTRA_PLUGIN_OPEN, &elektraConditionalsOpen,
+	    ELEKTRA_PLUGIN_CLOSE, &elektraConditionalsClose,
 	    ELEKTRA_PLUGIN_GET, &elektraConditionalsGet,
 	    ELEKTRA_PLUGIN_SET, &elektraConditionalsSet,
 	    ELEKTRA_PLUGIN_END);
@@ -13,6 +13,8 @@
 #include <kdbplugin.h>
 
 
+int elektraConditionalsOpen (Plugin * handle, Key * errorKey);
+int elektraConditionalsClose (Plugin * handle, Key * errorKey);
 int elektraConditionalsGet (Plugin * handle, KeySet * ks, Key * parentKey);
 int elektraConditionalsSet (Plugin * handle, KeySet * ks, Key * parentKey);
 
@@ -653,6 +653,62 @@ static void test_multiAssign3 (void)
 	PLUGIN_CLOSE ();
 }
 
+static void test_sharedCondition (void)
+{
+	Key * parentKey = keyNew ("user:/tests/conditionals", KEY_VALUE, "", KEY_END);
+	KeySet * ks = ksNew (5,
+			     keyNew ("user:/tests/conditionals/a", KEY_VALUE, "1", KEY_META, "check/condition",
+				     "(./ == '1') ? (../bla/val1 == '100')", KEY_END),
+			     keyNew ("user:/tests/conditionals/b", KEY_VALUE, "1", KEY_META, "check/condition",
+				     "(./ == '1') ? (../bla/val1 == '100')", KEY_END),
+			     keyNew ("user:/tests/conditionals/bla/val1", KEY_VALUE, "100", KEY_END), KS_END);
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("conditionals");
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == 1, "error");
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == 1, "error");
+
+	// the cached condition must be evaluated against the current values
+	keySetString (ksLookupByName (ks, "user:/tests/conditionals/bla/val1", 0), "50");
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == -1, "error");
+
+	keySetString (ksLookupByName (ks, "user:/tests/conditionals/bla/val1", 0), "100");
+	keySetMeta (ksLookupByName (ks, "user:/tests/conditionals/b", 0), "check/condition", "(./ == '1' ? (../bla/val1 == '100')");
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == -1, "invalid syntax not detected");
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == -1, "invalid syntax not detected on second call");
+
+	ksDel (ks);
+	keyDel (parentKey);
+	PLUGIN_CLOSE ();
+}
+
+static void test_manyConditions (void)
+{
+	Key * parentKey = keyNew ("user:/tests/conditionals", KEY_VALUE, "", KEY_END);
+	KeySet * ks = ksNew (0, KS_END);
+	for (int i = 0; i < 100; ++i)
+	{
+		char name[64];
+		char value[16];
+		char condition[64];
+		snprintf (name, sizeof (name), "user:/tests/conditionals/key%d", i);
+		snprintf (value, sizeof (value), "%d", i);
+		snprintf (condition, sizeof (condition), "(./ == '%d') ? (../bla/val1 == '100')", i);
+		ksAppendKey (ks, keyNew (name, KEY_VALUE, value, KEY_META, "check/condition", condition, KEY_END));
+	}
+	ksAppendKey (ks, keyNew ("user:/tests/conditionals/bla/val1", KEY_VALUE, "100", KEY_END));
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("conditionals");
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == 1, "error");
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == 1, "error");
+
+	keySetString (ksLookupByName (ks, "user:/tests/conditionals/bla/val1", 0), "50");
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == -1, "error");
+
+	ksDel (ks);
+	keyDel (parentKey);
+	PLUGIN_CLOSE ();
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("CONDITIONALS     TESTS\n");
@@ -694,6 +750,8 @@ int main (int argc, char ** argv)
 	test_multiCond2NoFail ();
 	test_multiAssign2 ();
 	test_multiAssign3 ();
+	test_sharedCondition ();
+	test_manyConditions ();
 	print_result ("testmod_conditionals");
 
 	return nbError;
@@ -23,11 +23,30 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 
 #define PARSE 1
 #define COLCOUNT 2
 #define READLINE 3
 
+#define WRITE_BUFFER_SIZE (64 * 1024)
+
+/**
+ * The content of a CSV file. Regular files are mapped into memory,
+ * everything else (e.g. `/dev/stdin`) is read into a buffer.
+ */
+typedef struct
+{
+	char * data;
+	size_t size;
+	size_t pos;
+	int mapped;
+} CsvFile;
+
 static char * parseRecord (char ** ptr, char delim, int * isQuoted, int * isCol, int * hasUnescapedDQuote, unsigned long * counter,
 			   unsigned short mode)
 {
@@ -173,20 +192,90 @@ static char * parseLine (char * origLine, char delim, unsigned long offset, Key
 	return line;
 }
 
-static unsigned long getLineLength (FILE * fp)
+static int csvFileOpen (CsvFile * file, const char * fileName)
 {
-	int startPos = ftell (fp);
-	char c;
-	while ((c = fgetc (fp)) && (!feof (fp)))
+	memset (file, 0, sizeof (CsvFile));
+
+	int fd = open (fileName, O_RDONLY);
+	if (fd == -1) return -1;
+
+	struct stat buf;
+	if (fstat (fd, &buf) == -1)
 	{
-		if (c == '\n') break;
+		close (fd);
+		return -1;
 	}
-	int endPos = ftell (fp);
-	fseek (fp, startPos, SEEK_SET);
-	if ((endPos - startPos) == 0)
+
+	if (S_ISREG (buf.st_mode))
+	{
+		file->size = buf.st_size;
+		if (file->size > 0)
+		{
+			void * data = mmap (NULL, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (data == MAP_FAILED)
+			{
+				close (fd);
+				return -1;
+			}
+			madvise (data, file->size, MADV_SEQUENTIAL);
+			file->data = data;
+			file->mapped = 1;
+		}
+		close (fd);
 		return 0;
+	}
+
+	size_t alloc = 0;
+	ssize_t bytesRead;
+	do
+	{
+		if (file->size == alloc)
+		{
+			alloc = alloc == 0 ? BUFSIZ : 2 * alloc;
+			if (elektraRealloc ((void **) &file->data, alloc) < 0)
+			{
+				elektraFree (file->data);
+				close (fd);
+				return -1;
+			}
+		}
+		bytesRead = read (fd, file->data + file->size, alloc - file->size);
+		if (bytesRead > 0) file->size += bytesRead;
+	} while (bytesRead > 0 || (bytesRead == -1 && errno == EINTR));
+
+	close (fd);
+	if (bytesRead == -1)
+	{
+		elektraFree (file->data);
+		return -1;
+	}
+	return 0;
+}
+
+static void csvFileClose (CsvFile * file)
+{
+	if (file->mapped)
+	{
+		munmap (file->data, file->size);
+	}
 	else
-		return (endPos - startPos) + 1;
+	{
+		elektraFree (file->data);
+	}
+}
+
+/// @returns the number of lines in the unread part of @p file
+static size_t csvFileCountLines (const CsvFile * file)
+{
+	size_t lines = 0;
+	const char * ptr = file->data + file->pos;
+	const char * end = file->data + file->size;
+	while (ptr < end && (ptr = memchr (ptr, '\n', end - ptr)) != NULL)
+	{
+		++lines;
+		++ptr;
+	}
+	return lines + 1;
 }
 
 // count columns in lineBuffer
@@ -216,48 +305,50 @@ static unsigned long getColumnCount (char * lineBuffer, char delim)
 // if EOL is reached with unbalanced quotes, assume record continues at the next
 // line. append succeeding lines until quotes are balanced or EOF is reached
 
-static char * readNextLine (FILE * fp, char delim, int * lastLine, int * linesRead)
+static char * readNextLine (CsvFile * file, char delim, int * lastLine, int * linesRead)
 {
-	int done = 0;
-	unsigned long bufLen = 0;
-	unsigned long offset = 0;
+	size_t bufLen = 0;
 	*linesRead = 0;
 	char * lineBuffer = NULL;
-	*linesRead = 0;
 	int isQuoted = 0;
 	int isCol = 0;
-	while (!done)
+	while (file->pos < file->size)
 	{
+		const char * line = file->data + file->pos;
+		size_t remaining = file->size - file->pos;
+		const char * newline = memchr (line, '\n', remaining);
+		size_t len = newline ? (size_t) (newline - line) + 1 : remaining;
+		file->pos += len;
+		++(*linesRead);
 
-		unsigned long len = getLineLength (fp);
-		if (!len)
+		if (elektraRealloc ((void **) &lineBuffer, bufLen + len + 1) < 0)
 		{
-			if (!lineBuffer)
-			{
-				*lastLine = 0;
-				return NULL;
-			}
-			else
-				return lineBuffer;
+			elektraFree (lineBuffer);
+			*lastLine = 0;
+			return NULL;
 		}
-		else
+		char * segment = lineBuffer + bufLen;
+		memcpy (segment, line, len);
+		segment[len] = '\0';
+		bufLen += len;
+
+		// without double-quotes, the line can't change whether we are inside a quoted field
+		if (memchr (segment, '"', len) == NULL)
 		{
-			++(*linesRead);
+			if (!isQuoted) break;
+			continue;
 		}
-		char buffer[len];
-		fgets (buffer, len, fp);
-		char * ptr = buffer;
+
+		char * ptr = segment;
 		while (*ptr)
 		{
 			parseRecord (&ptr, delim, &isQuoted, &isCol, &(int){ 0 }, &(unsigned long){ 0 }, COLCOUNT);
 		}
-		len = elektraStrLen (buffer);
-		bufLen += len;
-		lineBuffer = realloc (lineBuffer, bufLen);
-
-		memcpy (lineBuffer + offset, buffer, len);
-		offset += (len - 1);
-		if (!isCol && !isQuoted) done = 1;
+		if (!isCol && !isQuoted) break;
+	}
+	if (!lineBuffer)
+	{
+		*lastLine = 0;
 	}
 	return lineBuffer;
 }
@@ -332,18 +423,18 @@ static int csvRead (KeySet * returned, Key * parentKey, char delim, Key * colAsP
 {
 	const char * fileName;
 	fileName = keyString (parentKey);
-	FILE * fp = fopen (fileName, "rb");
-	if (!fp)
+	CsvFile file;
+	if (csvFileOpen (&file, fileName) == -1)
 	{
 		ELEKTRA_SET_RESOURCE_ERRORF (parentKey, "Couldn't open file %s", fileName);
 		return -1;
 	}
 	int lastLine = 0;
 	int linesRead = 0;
-	char * lineBuffer = readNextLine (fp, delim, &lastLine, &linesRead);
+	char * lineBuffer = readNextLine (&file, delim, &lastLine, &linesRead);
 	if (!lineBuffer)
 	{
-		fclose (fp);
+		csvFileClose (&file);
 		return 0;
 	}
 	unsigned long columns = 0;
@@ -355,7 +446,7 @@ static int csvRead (KeySet * returned, Key * parentKey, char delim, Key * colAsP
 			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Illegal number of columns (%lu - %lu) in Header line: %s",
 								 columns, fixColumnCount, lineBuffer);
 			elektraFree (lineBuffer);
-			fclose (fp);
+			csvFileClose (&file);
 			return -1;
 		}
 	}
@@ -371,10 +462,10 @@ static int csvRead (KeySet * returned, Key * parentKey, char delim, Key * colAsP
 		header = readHeaders (parentKey, lineBuffer, delim, lineCounter, lastLine, colNames);
 		if (!header)
 		{
-			fclose (fp);
+			csvFileClose (&file);
 			return -1;
 		}
-		fseek (fp, 0, SEEK_SET);
+		file.pos = 0;
 		lineCounter += linesRead;
 	}
 	else
@@ -383,15 +474,19 @@ static int csvRead (KeySet * returned, Key * parentKey, char delim, Key * colAsP
 		if (!header)
 		{
 			elektraFree (lineBuffer);
-			fclose (fp);
+			csvFileClose (&file);
 			return -1;
 		}
 		if (useHeader == 0)
 		{
-			fseek (fp, 0, SEEK_SET);
+			file.pos = 0;
 		}
 		lineCounter += 1;
 	}
+	// every line of the file becomes at most one record with a key per column and the record key
+	size_t expectedSize = ksGetSize (returned) + csvFileCountLines (&file) * (columns + 1);
+	if (expectedSize > returned->alloc) ksResize (returned, expectedSize);
+
 	Key * dirKey;
 	Key * cur;
 	dirKey = keyDup (parentKey, KEY_CP_ALL);
@@ -400,10 +495,10 @@ static int csvRead (KeySet * returned, Key * parentKey, char delim, Key * colAsP
 	ksRewind (header);
 	while (1)
 	{
-		lineBuffer = readNextLine (fp, delim, &lastLine, &linesRead);
+		lineBuffer = readNextLine (&file, delim, &lastLine, &linesRead);
 		if (!lineBuffer)
 		{
-			fclose (fp);
+			csvFileClose (&file);
 			keyDel (dirKey);
 			ksDel (header);
 			return (lineCounter > 0) ? 1 : 0;
@@ -414,7 +509,7 @@ static int csvRead (KeySet * returned, Key * parentKey, char delim, Key * colAsP
 			elektraFree (lineBuffer);
 			keyDel (dirKey);
 			ksDel (header);
-			fclose (fp);
+			csvFileClose (&file);
 			return -1;
 		}
 		++nr_keys;
@@ -428,18 +523,22 @@ static int csvRead (KeySet * returned, Key * parentKey, char delim, Key * colAsP
 		{
 			cur = ksNext (header);
 			offset += elektraStrLen (col);
-			key = keyDup (dirKey, KEY_CP_ALL);
+			// set the value before any metadata, so keySetString does not have to look for stale meta:/binary
+			key = keyDup (dirKey, KEY_CP_NAME);
+			int quoted = 0;
 			if (col[0] == '"')
 			{
 				if (col[elektraStrLen (col) - 2] == '"')
 				{
-					keySetMeta (key, "internal/csvstorage/quoted", "");
+					quoted = 1;
 					++col;
 					col[elektraStrLen (col) - 2] = '\0';
 				}
 			}
 			keyAddName (key, keyString (cur));
 			keySetString (key, col);
+			keyCopyAllMeta (key, dirKey);
+			if (quoted) keySetMeta (key, "internal/csvstorage/quoted", "");
 			ksAppendKey (tmpKs, key);
 			lastIndex = (char *) keyBaseName (cur);
 			++nr_keys;
@@ -485,7 +584,7 @@ static int csvRead (KeySet * returned, Key * parentKey, char delim, Key * colAsP
 				ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Illegal number of columns (%lu - %lu) in line %lu: %s",
 									 colCounter, columns, lineCounter, lineBuffer);
 				elektraFree (lineBuffer);
-				fclose (fp);
+				csvFileClose (&file);
 				keyDel (dirKey);
 				ksDel (header);
 				return -1;
@@ -501,7 +600,7 @@ static int csvRead (KeySet * returned, Key * parentKey, char delim, Key * colAsP
 	keySetString (key, keyBaseName (dirKey));
 	ksAppendKey (returned, key);
 	keyDel (dirKey);
-	fclose (fp);
+	csvFileClose (&file);
 	ksDel (header);
 	return 1;
 }
@@ -615,6 +714,13 @@ static int isExportKey (const Key * key, const Key * parent, KeySet * ks)
 	}
 }
 
+static void writeField (FILE * fp, const char * field, int quote)
+{
+	if (quote) fputc ('"', fp);
+	fputs (field, fp);
+	if (quote) fputc ('"', fp);
+}
+
 static int csvWrite (KeySet * returned, Key * parentKey, KeySet * exportKS, Key * colAsParent, char delim, short useHeader)
 {
 	FILE * fp;
@@ -624,6 +730,7 @@ static int csvWrite (KeySet * returned, Key * parentKey, KeySet * exportKS, Key
 		ELEKTRA_SET_ERROR_SET (parentKey);
 		return -1;
 	}
+	setvbuf (fp, NULL, _IOFBF, WRITE_BUFFER_SIZE);
 
 	keyDel (ksLookup (returned, parentKey, KDB_O_POP));
 
@@ -631,11 +738,9 @@ static int csvWrite (KeySet * returned, Key * parentKey, KeySet * exportKS, Key
 	unsigned long columns = 0; // TODO: not needed?
 	unsigned long lineCounter = 0;
 	Key * cur;
-	KeySet * toWriteKS;
 	Key * toWrite;
 
-	ksRewind (returned);
-	while ((cur = ksNext (returned)) != NULL)
+	for (elektraCursor it = 0; (cur = ksAtCursor (returned, it)) != NULL; ++it)
 	{
 		if (keyIsDirectlyBelow (parentKey, cur) != 1) continue;
 		colCounter = 0;
@@ -644,78 +749,50 @@ static int csvWrite (KeySet * returned, Key * parentKey, KeySet * exportKS, Key
 			useHeader = 0;
 			continue;
 		}
+
+		// the record cur consists of all keys below cur
+		elektraCursor end;
+		elektraCursor start = ksFindHierarchy (returned, cur, &end);
+		size_t curNameSize = keyGetNameSize (cur);
+
 		if (colAsParent)
 		{
-			KeySet * tmpKs = ksDup (returned);
-			ksRewind (tmpKs);
-			KeySet * headerKs = ksCut (tmpKs, cur);
-			ksRewind (headerKs);
-			ksDel (tmpKs);
-			ksNext (headerKs);
-			Key * tmp = ksNext (headerKs);
 			int printDelim = 0;
-			if (isExportKey (tmp, cur, exportKS))
-			{
-				fprintf (fp, "%s", keyName (tmp) + strlen (keyName (cur)) + 1);
-				printDelim = 1;
-				++colCounter;
-			}
-			while ((tmp = ksNext (headerKs)) != NULL)
+			for (elektraCursor headerIt = start + 1; headerIt < end; ++headerIt)
 			{
+				Key * tmp = ksAtCursor (returned, headerIt);
 				if (!isExportKey (tmp, cur, exportKS)) continue;
 				++colCounter;
-				if (printDelim) fprintf (fp, "%c", delim);
-				if ((strchr (keyName (tmp), '\n') != NULL) && (keyName (tmp)[0] != '"'))
-				{
-					fprintf (fp, "\"%s\"", keyName (tmp) + strlen (keyName (cur)) + 1);
-				}
-				else
-				{
-					fprintf (fp, "%s", keyName (tmp) + strlen (keyName (cur)) + 1);
-				}
+				if (printDelim) fputc (delim, fp);
+				const char * colName = keyName (tmp) + curNameSize;
+				writeField (fp, colName, printDelim && (strchr (keyName (tmp), '\n') != NULL) && (keyName (tmp)[0] != '"'));
 				printDelim = 1;
 			}
-			fprintf (fp, "\n");
+			fputc ('\n', fp);
 			if (columns == 0)
 			{
 				columns = colCounter;
 			}
 			colAsParent = NULL;
-			ksDel (headerKs);
 		}
 		colCounter = 0;
-		toWriteKS = ksCut (returned, cur);
-		ksRewind (toWriteKS);
 		int printDelim = 0;
-		while (1)
+		for (elektraCursor recordIt = start + 1; recordIt < end; ++recordIt)
 		{
-			toWrite = ksNext (toWriteKS);
-			if (!keyCmp (cur, toWrite)) continue;
-			if (!toWrite) break;
+			toWrite = ksAtCursor (returned, recordIt);
 			if (!isExportKey (toWrite, cur, exportKS))
 			{
 				continue;
 			}
-			if (printDelim) fprintf (fp, "%c", delim);
+			if (printDelim) fputc (delim, fp);
 			++colCounter;
-			if (keyGetMeta (toWrite, "internal/csvstorage/quoted"))
-			{
-				fprintf (fp, "\"%s\"", keyString (toWrite));
-				printDelim = 1;
-			}
-			else if ((strchr (keyString (toWrite), '\n') != NULL) && (keyString (toWrite)[0] != '"'))
-			{
-				fprintf (fp, "\"%s\"", keyString (toWrite));
-				printDelim = 1;
-			}
-			else
-			{
-				fprintf (fp, "%s", keyString (toWrite));
-				printDelim = 1;
-			}
+			const char * value = keyString (toWrite);
+			writeField (fp, value,
+				    keyGetMeta (toWrite, "internal/csvstorage/quoted") || ((strchr (value, '\n') != NULL) && (value[0] != '"')));
+			printDelim = 1;
 		}
-		ksDel (toWriteKS);
-		fprintf (fp, "\n");
+		fputc ('\n', fp);
+		it = end - 1;
 		if (columns == 0)
 		{
 			columns = colCounter;
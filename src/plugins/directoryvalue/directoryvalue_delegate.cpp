@@ -7,12 +7,15 @@
  *
  */
 
+#include <exception>
+#include <new>
 #include <numeric>
 
 #include <kdbassert.h>
 #include <kdbease.h>
 #include <kdberrors.h>
 #include <kdblogger.h>
+#include <kdbprivate.h> // for ksRenameEach
 
 #include <kdbplugin.hpp>
 
@@ -20,10 +23,13 @@
 #include "log.hpp"
 
 using std::accumulate;
-using std::ignore;
+using std::bad_alloc;
+using std::current_exception;
+using std::exception_ptr;
 using std::make_pair;
 using std::pair;
 using std::range_error;
+using std::rethrow_exception;
 using std::string;
 using std::tie;
 
@@ -276,6 +282,80 @@ pair<kdb::Key, string> changeArrayIndexByOne (kdb::Key const & parent, kdb::Key
 	return make_pair (elementNewIndex, newIndex);
 }
 
+/**
+ * @brief This structure stores the state of `renameArrayElement` while `ksRenameEach` updates the elements of a single array.
+ */
+struct ArrayRename
+{
+	kdb::Key parent;
+	bool increment;
+	kdb::KeySet * updatedParents;
+	kdb::KeySet renamedParents;
+	exception_ptr error;
+};
+
+/**
+ * @brief This callback for `ksRenameEach` changes the index of an array element below `ArrayRename::parent` by one.
+ *
+ * Exceptions must not cross the C code of `ksRenameEach`, so this function stores the first exception in `ArrayRename::error`.
+ *
+ * @param key This parameter stores the array element this function renames in-place.
+ * @param data This parameter points to the `ArrayRename` state.
+ *
+ * @retval 1 If the function renamed `key`
+ * @retval 0 If the function left `key` unchanged
+ */
+int renameArrayElement (ckdb::Key * key, void * data)
+{
+	auto rename = static_cast<ArrayRename *> (data);
+	if (rename->error) return 0;
+
+	kdb::Key element{ key };
+	try
+	{
+		kdb::Key updated;
+		string newIndex;
+		tie (updated, newIndex) = changeArrayIndexByOne (rename->parent, element, rename->increment);
+
+		// Array parents that are part of another array keep their original name in `updatedParents`
+		bool const isParent = rename->updatedParents && rename->updatedParents->lookup (element, KDB_O_POP);
+		element.setName (updated.getName ());
+		if (isParent) rename->renamedParents.append (element);
+
+		if (!rename->increment)
+		{
+			rename->parent.setMeta ("array", newIndex);
+			ELEKTRA_LOG_DEBUG ("New last index of “%s” is “%s”", rename->parent.getName ().c_str (),
+					   rename->parent.getMeta<string> ("array").c_str ());
+		}
+	}
+	catch (...)
+	{
+		rename->error = current_exception ();
+	}
+	element.release ();
+
+	return rename->error ? 0 : 1;
+}
+
+/**
+ * @brief Change the index of all array elements below `rename.parent` by one.
+ *
+ * @param arrays This key set stores the arrays elements this function updates in-place.
+ * @param rename This parameter specifies the array parent and the direction of the update.
+ */
+void changeArrayIndicesByOne (kdb::KeySet & arrays, ArrayRename & rename)
+{
+	ckdb::KeySet * ks = arrays.getKeySet ();
+	elektraCursor end;
+	elektraCursor start = ckdb::ksFindHierarchy (ks, *rename.parent, &end);
+	if (start < end && ckdb::keyCmp (ckdb::ksAtCursor (ks, start), *rename.parent) == 0) start++;
+
+	ssize_t result = ckdb::ksRenameEach (ks, start, end, renameArrayElement, &rename);
+	if (rename.error) rethrow_exception (rename.error);
+	if (result < 0) throw bad_alloc ();
+}
+
 /**
  * @brief Decrease the array index of array elements by one.
  *
@@ -295,20 +375,8 @@ kdb::KeySet decreaseArrayIndices (kdb::KeySet const & parents, kdb::KeySet const
 
 		parent.setMeta ("array", ""); // Set meta key for empty arrays
 
-		arraysIndexDecreased =
-			accumulate (arraysIndexDecreased.begin (), arraysIndexDecreased.end (), kdb::KeySet{},
-				    [&parent] (kdb::KeySet collected, kdb::Key key) {
-					    if (key.isBelow (parent))
-					    {
-						    string newIndex;
-						    tie (key, newIndex) = changeArrayIndexByOne (parent, key, false);
-						    parent.setMeta ("array", newIndex);
-						    ELEKTRA_LOG_DEBUG ("New last index of “%s” is “%s”", parent.getName ().c_str (),
-								       parent.getMeta<string> ("array").c_str ());
-					    }
-					    collected.append (key);
-					    return collected;
-				    });
+		ArrayRename rename{ parent, false, nullptr, kdb::KeySet{}, nullptr };
+		changeArrayIndicesByOne (arraysIndexDecreased, rename);
 
 		arraysIndexDecreased.append (parent); // Update meta data of parent key in `arrays`
 	}
@@ -428,22 +496,9 @@ KeySetPair increaseArrayIndices (kdb::KeySet const & parents, kdb::KeySet const
 	{
 		ELEKTRA_LOG_DEBUG ("Increase indices for array parent “%s”", parent.getName ().c_str ());
 
-		kdb::KeySet newArrays;
-		for (auto key : arraysIncreasedIndex)
-		{
-			if (key.isBelow (parent))
-			{
-				kdb::Key updated;
-				tie (updated, ignore) = changeArrayIndexByOne (parent, key);
-				if (updatedParents.lookup (key, KDB_O_POP)) updatedParents.append (updated);
-				newArrays.append (updated);
-			}
-			else
-			{
-				newArrays.append (key);
-			}
-		}
-		arraysIncreasedIndex = newArrays;
+		ArrayRename rename{ parent, true, &updatedParents, kdb::KeySet{}, nullptr };
+		changeArrayIndicesByOne (arraysIncreasedIndex, rename);
+		updatedParents.append (rename.renamedParents);
 	}
 
 	return make_pair (updatedParents, arraysIncreasedIndex);
@@ -8,25 +8,47 @@
 
 #include "dump.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
-#include <sstream>
+#include <limits>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <unistd.h>
 
 #include <kdberrors.h>
 #include <kdblogger.h>
+#include <kdbprivate.h>
 
 using namespace ckdb;
 
 namespace dump
 {
 
+// number of bytes serialise collects before handing them to the stream
+static const size_t bufferSize = 64 * 1024;
+
+static void appendSize (std::string & out, size_t value)
+{
+	char digits[std::numeric_limits<size_t>::digits10 + 1];
+	char * end = digits + sizeof (digits);
+	char * begin = end;
+	do
+	{
+		*--begin = static_cast<char> ('0' + value % 10);
+		value /= 10;
+	} while (value > 0);
+	out.append (begin, end - begin);
+}
+
 int serialise (std::ostream & os, ckdb::Key * parentKey, ckdb::KeySet * ks, bool useFullNames)
 {
-	os << "kdbOpen 2" << std::endl;
+	std::string buffer;
+	buffer.reserve (bufferSize);
+	buffer.append ("kdbOpen 2\n");
 
 	size_t rootOffset;
 	if (useFullNames)
@@ -42,7 +64,16 @@ int serialise (std::ostream & os, ckdb::Key * parentKey, ckdb::KeySet * ks, bool
 		}
 	}
 
-	ckdb::KeySet * metacopies = ksNew (0, KS_END);
+	struct MetaOrigin
+	{
+		const ckdb::Key * key;
+		size_t nameSize;
+	};
+
+	// metakeys which were already serialised, referenced by the first key they were written for
+	std::unordered_map<const ckdb::Key *, MetaOrigin> metacopies;
+	const size_t metaNsOffset = sizeof ("meta:/") - 1;
+
 	for (elektraCursor cursor = 0; cursor < ksGetSize (ks); ++cursor)
 	{
 		ckdb::Key * cur = ksAtCursor (ks, cursor);
@@ -56,189 +87,350 @@ int serialise (std::ostream & os, ckdb::Key * parentKey, ckdb::KeySet * ks, bool
 		size_t valuesize = keyGetValueSize (cur);
 
 		bool binary = keyIsBinary (cur) == 1;
-
-		std::string type;
-		if (binary)
+		if (!binary)
 		{
-			type = "binary";
-		}
-		else
-		{
-			type = "string";
 			valuesize -= 1;
 		}
 
-		os << "$key " << type << " " << namesize << " " << valuesize << std::endl;
+		buffer.append (binary ? "$key binary " : "$key string ");
+		appendSize (buffer, namesize);
+		buffer.push_back (' ');
+		appendSize (buffer, valuesize);
+		buffer.push_back ('\n');
 		if (namesize > 0)
 		{
-			os << &keyName (cur)[rootOffset];
+			buffer.append (&keyName (cur)[rootOffset]);
 		}
-		os << std::endl;
+		buffer.push_back ('\n');
 
 		if (binary)
 		{
-			os.write (static_cast<const char *> (keyValue (cur)), valuesize);
-			os << std::endl;
+			if (valuesize > 0)
+			{
+				buffer.append (static_cast<const char *> (keyValue (cur)), valuesize);
+			}
 		}
 		else
 		{
-			os << keyString (cur) << std::endl;
+			buffer.append (keyString (cur));
 		}
+		buffer.push_back ('\n');
 
-		ckdb::KeySet * metaKs = keyMeta (cur);
+		// keyMeta() would copy shared metadata
+		ckdb::KeySet * metaKs = ckdb::elektraKeyGetMetaKeySet (cur);
 		for (elektraCursor metaCursor = 0; metaCursor < ksGetSize (metaKs); ++metaCursor)
 		{
 			const ckdb::Key * meta = ksAtCursor (metaKs, metaCursor);
+			size_t metanamesize = keyGetNameSize (meta) - 1 - metaNsOffset;
 
-			std::stringstream ss;
-			ss << "/" << meta; // use the address of pointer as name
-
-			ckdb::Key * search = keyNew (ss.str ().c_str (), KEY_END);
-			ckdb::Key * ret = ksLookup (metacopies, search, 0);
-
-			if (!ret)
+			auto copy = metacopies.find (meta);
+			if (copy == metacopies.end ())
 			{
-				const size_t metaNsOffset = sizeof ("meta:/") - 1;
 				/* This metakey was not serialised up to now */
-				size_t metanamesize = keyGetNameSize (meta) - 1 - metaNsOffset;
 				size_t metavaluesize = keyGetValueSize (meta) - 1;
 
-				os << "$meta " << metanamesize << " " << metavaluesize << std::endl;
-				os << keyName (meta) + metaNsOffset << std::endl;
-				os << keyString (meta) << std::endl;
-
-				std::stringstream ssv;
-				ssv << namesize << " " << metanamesize << std::endl;
-				if (namesize > 0)
-				{
-					ssv << &keyName (cur)[rootOffset];
-				}
-				ssv << std::endl;
-				ssv << keyName (meta) + metaNsOffset << std::endl;
-				keySetString (search, ssv.str ().c_str ());
-
-				ksAppendKey (metacopies, search);
+				buffer.append ("$meta ");
+				appendSize (buffer, metanamesize);
+				buffer.push_back (' ');
+				appendSize (buffer, metavaluesize);
+				buffer.push_back ('\n');
+				buffer.append (keyName (meta) + metaNsOffset);
+				buffer.push_back ('\n');
+				buffer.append (keyString (meta));
+				buffer.push_back ('\n');
+
+				metacopies.emplace (meta, MetaOrigin{ cur, namesize });
 			}
 			else
 			{
 				/* Meta key already serialised, write out a reference to it */
-				keyDel (search);
-
-				os << "$copymeta " << keyString (ret);
+				buffer.append ("$copymeta ");
+				appendSize (buffer, copy->second.nameSize);
+				buffer.push_back (' ');
+				appendSize (buffer, metanamesize);
+				buffer.push_back ('\n');
+				if (copy->second.nameSize > 0)
+				{
+					buffer.append (&keyName (copy->second.key)[rootOffset]);
+				}
+				buffer.push_back ('\n');
+				buffer.append (keyName (meta) + metaNsOffset);
+				buffer.push_back ('\n');
 			}
 		}
 
-		// flush after every key to speed up streaming
-		os.flush ();
+		// hand out full buffers, so that a reader on the other end of a pipe can start early
+		if (buffer.size () >= bufferSize)
+		{
+			os.write (buffer.data (), buffer.size ());
+			buffer.clear ();
+		}
 	}
-	ksDel (metacopies);
 
-	os << "$end" << std::endl;
+	buffer.append ("$end\n");
+	os.write (buffer.data (), buffer.size ());
+	os.flush ();
 
 	return 1;
 }
 
-static int decodeLine (std::istream & is, ckdb::Key * parentKey, ckdb::KeySet * ks, std::string & line, ckdb::Key ** curPtr)
+/**
+ * Tokenizer for the dump format
+ *
+ * Reads the input in large chunks into a single buffer. Lines and
+ * raw name/value blocks are handed out as pointers into this buffer,
+ * which stay valid until the next call to getline or read.
+ */
+class Reader
 {
-	ckdb::Key * cur = *curPtr;
+	std::streambuf * sb_;
+	std::vector<char> buffer_;
+	size_t begin_;
+	size_t end_;
+	size_t consumed_;
+	bool eof_;
+
+	// makes sure at least size bytes are buffered, returns false if the input ends before
+	bool fill (size_t size)
+	{
+		if (end_ - begin_ >= size) return true;
+
+		if (begin_ > 0)
+		{
+			memmove (buffer_.data (), buffer_.data () + begin_, end_ - begin_);
+			end_ -= begin_;
+			begin_ = 0;
+		}
+
+		// one spare byte to null-terminate the last line
+		if (buffer_.size () < size + 1)
+		{
+			buffer_.resize (std::max (size + 1, 2 * buffer_.size ()));
+		}
+
+		while (end_ < size && !eof_)
+		{
+			// only read what is available, a pipe may not be closed after $end
+			std::streamsize available = sb_->in_avail ();
+			if (available <= 0)
+			{
+				if (sb_->sgetc () == std::char_traits<char>::eof ())
+				{
+					eof_ = true;
+					break;
+				}
+				available = sb_->in_avail ();
+			}
 
-	std::vector<char> namebuffer (4048);
-	std::vector<char> valuebuffer (4048);
-	std::string command;
-	size_t nrKeys;
-	size_t namesize;
-	size_t valuesize;
+			std::streamsize space = buffer_.size () - 1 - end_;
+			std::streamsize got = sb_->sgetn (buffer_.data () + end_, std::min (available, space));
+			if (got <= 0)
+			{
+				eof_ = true;
+				break;
+			}
+			end_ += got;
+		}
+
+		return end_ >= size;
+	}
 
-	std::stringstream ss (line);
-	ss >> command;
+public:
+	explicit Reader (std::istream & is) : sb_ (is.rdbuf ()), buffer_ (bufferSize), begin_ (0), end_ (0), consumed_ (0), eof_ (false)
+	{
+	}
 
-	if (command == "kdbOpen")
+	/**
+	 * Reads the next line, like std::getline.
+	 *
+	 * The newline is replaced by a null byte.
+	 *
+	 * @retval false if the input has ended
+	 */
+	bool getline (char *& line, size_t & length)
 	{
-		std::string version;
-		ss >> version;
-		if (version != "1")
+		size_t scanned = 0;
+		char * newline = nullptr;
+		while ((newline = static_cast<char *> (memchr (buffer_.data () + begin_ + scanned, '\n', end_ - begin_ - scanned))) ==
+		       nullptr)
 		{
-			ELEKTRA_SET_INSTALLATION_ERRORF (parentKey, "Wrong version detected in dumpfile: %s", version.c_str ());
-			return -1;
+			scanned = end_ - begin_;
+			if (!fill (scanned + 1)) break;
+		}
+
+		line = buffer_.data () + begin_;
+		if (newline)
+		{
+			length = newline - line;
+			*newline = '\0';
+			advance (length + 1);
+			return true;
 		}
+
+		// last line without newline
+		length = end_ - begin_;
+		if (length == 0) return false;
+		buffer_[end_] = '\0';
+		advance (length);
+		return true;
 	}
-	else if (command == "ksNew")
+
+	/**
+	 * Reads the next size bytes.
+	 *
+	 * @retval nullptr if the input ends before
+	 */
+	char * read (size_t size)
 	{
-		ss >> nrKeys;
+		if (!fill (size)) return nullptr;
+		char * data = buffer_.data () + begin_;
+		advance (size);
+		return data;
+	}
 
-		ksClear (ks);
+	size_t position () const
+	{
+		return consumed_;
 	}
-	else if (command == "keyNew")
+
+private:
+	void advance (size_t size)
 	{
-		ss >> namesize;
-		ss >> valuesize;
+		begin_ += size;
+		consumed_ += size;
+	}
+};
 
-		if (namesize > namebuffer.size ()) namebuffer.resize (namesize + 1);
-		is.read (&namebuffer[0], namesize);
-		namebuffer[namesize] = 0;
+static bool isBlank (char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
 
-		std::string name (namebuffer.data ());
-		size_t slashIndex = name.find ('/');
-		if (slashIndex > 0)
-		{
-			name = name.substr (0, slashIndex) + ":" + name.substr (slashIndex);
-		}
+// a word within a line, points into the buffer of the Reader
+struct Token
+{
+	const char * data;
+	int size;
 
-		cur = ckdb::keyNew (name.c_str (), KEY_END);
+	bool is (const char * word) const
+	{
+		return strlen (word) == static_cast<size_t> (size) && memcmp (data, word, size) == 0;
+	}
+};
 
-		if (valuesize > valuebuffer.size ()) valuebuffer.resize (valuesize + 1);
-		is.read (&valuebuffer[0], valuesize);
-		valuebuffer[valuesize] = 0;
+// extracts the next whitespace separated word of a line, like operator>> for std::string
+static Token nextToken (const char *& cursor, const char * end)
+{
+	while (cursor < end && isBlank (*cursor))
+		++cursor;
+	const char * begin = cursor;
+	while (cursor < end && !isBlank (*cursor))
+		++cursor;
+	return Token{ begin, static_cast<int> (cursor - begin) };
+}
 
-		ckdb::keySetRaw (cur, &valuebuffer[0], valuesize);
-		std::getline (is, line);
+static bool nextSize (const char *& cursor, const char * end, size_t & value)
+{
+	Token token = nextToken (cursor, end);
+	if (token.size == 0) return false;
+
+	value = 0;
+	for (int i = 0; i < token.size; ++i)
+	{
+		if (token.data[i] < '0' || token.data[i] > '9') return false;
+		value = value * 10 + (token.data[i] - '0');
 	}
-	else if (command == "keyMeta")
+	return true;
+}
+
+// converts names like user/tests to user:/tests
+static void convertVersion1Name (std::string & name)
+{
+	size_t slashIndex = name.find ('/');
+	if (slashIndex != std::string::npos && slashIndex > 0)
 	{
-		ss >> namesize;
-		ss >> valuesize;
+		name.insert (slashIndex, 1, ':');
+	}
+}
 
-		if (namesize > namebuffer.size ()) namebuffer.resize (namesize + 1);
-		is.read (&namebuffer[0], namesize);
-		namebuffer[namesize] = 0;
+static int decodeLine (Reader & reader, ckdb::Key * parentKey, ckdb::KeySet * ks, const char * line, size_t length, ckdb::Key ** curPtr,
+		       std::string & name, std::string & value)
+{
+	ckdb::Key * cur = *curPtr;
 
-		if (valuesize > valuebuffer.size ()) valuebuffer.resize (valuesize + 1);
-		is.read (&valuebuffer[0], valuesize);
-		valuebuffer[valuesize] = 0;
+	const char * cursor = line;
+	const char * end = line + length;
+	Token command = nextToken (cursor, end);
 
-		keySetMeta (cur, &namebuffer[0], &valuebuffer[0]);
-		std::getline (is, line);
+	if (command.is ("kdbOpen"))
+	{
+		Token version = nextToken (cursor, end);
+		if (!version.is ("1"))
+		{
+			ELEKTRA_SET_INSTALLATION_ERRORF (parentKey, "Wrong version detected in dumpfile: %.*s", version.size, version.data);
+			return -1;
+		}
 	}
-	else if (command == "keyCopyMeta")
+	else if (command.is ("ksNew"))
 	{
-		ss >> namesize;
-		ss >> valuesize;
+		ksClear (ks);
+	}
+	else if (command.is ("keyNew") || command.is ("keyMeta") || command.is ("keyCopyMeta"))
+	{
+		size_t namesize;
+		size_t valuesize;
+		if (!nextSize (cursor, end, namesize) || !nextSize (cursor, end, valuesize))
+		{
+			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Could not read sizes of command in dumpfile: %s", line);
+			return -1;
+		}
+
+		// line is invalid after reading
+		bool isKeyNew = command.is ("keyNew");
+		bool isKeyMeta = command.is ("keyMeta");
 
-		if (namesize > namebuffer.size ()) namebuffer.resize (namesize + 1);
-		is.read (&namebuffer[0], namesize);
-		namebuffer[namesize] = 0;
+		const char * data = reader.read (namesize + valuesize);
+		if (!data)
+		{
+			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Unexpected end of dumpfile at position %zu",
+								 reader.position ());
+			return -1;
+		}
 
-		if (valuesize > valuebuffer.size ()) valuebuffer.resize (valuesize + 1);
-		is.read (&valuebuffer[0], valuesize);
-		valuebuffer[valuesize] = 0;
+		// names and values are null-terminated within their size
+		name.assign (data, strnlen (data, namesize));
 
-		std::string name (namebuffer.data ());
-		size_t slashIndex = name.find ('/');
-		if (slashIndex > 0)
+		if (isKeyNew)
 		{
-			name = name.substr (0, slashIndex) + ":" + name.substr (slashIndex);
+			convertVersion1Name (name);
+			cur = ckdb::keyNew (name.c_str (), KEY_END);
+			ckdb::keySetRaw (cur, data + namesize, valuesize);
+		}
+		else
+		{
+			value.assign (data + namesize, strnlen (data + namesize, valuesize));
+			if (isKeyMeta)
+			{
+				keySetMeta (cur, name.c_str (), value.c_str ());
+			}
+			else
+			{
+				convertVersion1Name (name);
+				ckdb::Key * search = ckdb::ksLookupByName (ks, name.c_str (), 0);
+				ckdb::keyCopyMeta (cur, search, value.c_str ());
+			}
 		}
 
-		ckdb::Key * search = ckdb::ksLookupByName (ks, name.c_str (), 0);
-		ckdb::keyCopyMeta (cur, search, &valuebuffer[0]);
-		std::getline (is, line);
+		// skip the rest of the line
+		char * rest;
+		reader.getline (rest, length);
 	}
-	else if (command == "keyEnd")
+	else if (command.is ("keyEnd"))
 	{
 		ckdb::ksAppendKey (ks, cur);
 		cur = nullptr;
 	}
-	else if (command == "ksEnd")
+	else if (command.is ("ksEnd"))
 	{
 		return 1;
 	}
@@ -246,9 +438,9 @@ static int decodeLine (std::istream & is, ckdb::Key * parentKey, ckdb::KeySet *
 	{
 		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (
 			parentKey,
-			"Unknown command detected in dumpfile: %s.\nMaybe the file is not in dump configuration file format? "
+			"Unknown command detected in dumpfile: %.*s.\nMaybe the file is not in dump configuration file format? "
 			"Try to remount with another plugin (eg. ini, ni, etc.)",
-			command.c_str ());
+			command.size, command.data);
 		return -1;
 	}
 
@@ -257,14 +449,15 @@ static int decodeLine (std::istream & is, ckdb::Key * parentKey, ckdb::KeySet *
 	return 0;
 }
 
-int unserialiseVersion1 (std::istream & is, ckdb::Key * parentKey, ckdb::KeySet * ks, const std::string & firstLine)
+static int unserialiseVersion1 (Reader & reader, ckdb::Key * parentKey, ckdb::KeySet * ks, char * line, size_t length)
 {
 	ckdb::Key * cur = nullptr;
-	std::string line = firstLine;
+	std::string name;
+	std::string value;
 
 	do
 	{
-		int ret = decodeLine (is, parentKey, ks, line, &cur);
+		int ret = decodeLine (reader, parentKey, ks, line, length, &cur, name, value);
 
 		if (ret == -1)
 		{
@@ -275,15 +468,27 @@ int unserialiseVersion1 (std::istream & is, ckdb::Key * parentKey, ckdb::KeySet
 		{
 			break;
 		}
-	} while (std::getline (is, line));
+	} while (reader.getline (line, length));
 
 	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
 }
 
-int unserialiseVersion2 (std::istream & is, ckdb::Key * parentKey, ckdb::KeySet * ks, bool useFullNames)
+// checks that a name or value within block is followed by a newline and null-terminates it
+static bool terminateBlock (char * block, size_t offset, size_t blockPosition, ckdb::Key * parentKey)
+{
+	if (block[offset] != '\n')
+	{
+		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Expected newline '\\n' but got '%c' at position %zd.\n", block[offset],
+							 blockPosition + offset + 1);
+		return false;
+	}
+	block[offset] = '\0';
+	return true;
+}
+
+static int unserialiseVersion2 (Reader & reader, ckdb::Key * parentKey, ckdb::KeySet * ks, bool useFullNames)
 {
 	ckdb::Key * cur = nullptr;
-	std::string line;
 
 	std::string rootName (keyName (parentKey));
 	rootName += "/";
@@ -293,155 +498,96 @@ int unserialiseVersion2 (std::istream & is, ckdb::Key * parentKey, ckdb::KeySet
 		rootName = "";
 	}
 
-	char newline;
+	// reused for every key, so that building names does not allocate
+	std::string name;
 
-	while (std::getline (is, line))
+	char * line;
+	size_t length;
+	while (reader.getline (line, length))
 	{
-		std::stringstream ss (line);
-		std::string command;
-		ss >> command;
+		const char * cursor = line;
+		const char * end = line + length;
+		Token command = nextToken (cursor, end);
 
-		if (command == "$key")
+		if (command.is ("$key") || command.is ("$meta") || command.is ("$copymeta"))
 		{
-			std::string type;
-			size_t nameSize;
-			size_t valueSize;
-
-			ss >> type;
-			ss >> nameSize;
-			ss >> valueSize;
-
-			std::string name (nameSize, '\0');
-			is.read (&name[0], nameSize);
-
-			is.read (&newline, 1);
-			if (newline != '\n')
-			{
-				ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey,
-									 "Expected newline '\\n' but got '%c' at position %zd.\n", newline,
-									 static_cast<size_t> (is.tellg ()));
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
-			}
+			bool isKey = command.is ("$key");
+			bool isMeta = command.is ("$meta");
 
-			if (type == "string")
+			bool binary = false;
+			if (isKey)
 			{
-				std::string value (valueSize, '\0');
-				is.read (&value[0], valueSize);
-
-				is.read (&newline, 1);
-				if (newline != '\n')
+				Token type = nextToken (cursor, end);
+				if (type.is ("binary"))
 				{
-					ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey,
-										 "Expected newline '\\n' but got '%c' at position %zd.\n",
-										 newline, static_cast<size_t> (is.tellg ()));
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
+					binary = true;
 				}
-
-				cur = keyNew ((rootName + name).c_str (), KEY_VALUE, value.c_str (), KEY_END);
-			}
-			else if (type == "binary")
-			{
-				std::vector<char> value (valueSize);
-				is.read (value.data (), valueSize);
-
-				is.read (&newline, 1);
-				if (newline != '\n')
+				else if (!type.is ("string"))
 				{
-					ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey,
-										 "Expected newline '\\n' but got '%c' at position %zd.\n",
-										 newline, static_cast<size_t> (is.tellg ()));
+					ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (
+						parentKey, "Unknown key type detected in dumpfile: %.*s.\n", type.size, type.data);
 					return ELEKTRA_PLUGIN_STATUS_ERROR;
 				}
-
-				if (valueSize > 0)
-				{
-					cur = keyNew ((rootName + name).c_str (), KEY_BINARY, KEY_SIZE, valueSize, KEY_VALUE, value.data (),
-						      KEY_END);
-				}
-				else
-				{
-					cur = keyNew ((rootName + name).c_str (), KEY_BINARY, KEY_SIZE, valueSize, KEY_END);
-				}
 			}
-			else
+
+			size_t firstSize;
+			size_t secondSize;
+			if (!nextSize (cursor, end, firstSize) || !nextSize (cursor, end, secondSize))
 			{
-				ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Unknown key type detected in dumpfile: %s.\n",
-									 type.c_str ());
+				ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Could not read sizes of command in dumpfile: %s",
+									 line);
 				return ELEKTRA_PLUGIN_STATUS_ERROR;
 			}
 
-			ksAppendKey (ks, cur);
-		}
-		else if (command == "$meta")
-		{
-			size_t nameSize;
-			size_t valueSize;
-
-			ss >> nameSize;
-			ss >> valueSize;
-
-			std::string name (nameSize, '\0');
-			is.read (&name[0], nameSize);
-
-			is.read (&newline, 1);
-			if (newline != '\n')
+			// both blocks are terminated by a newline
+			size_t blockSize = firstSize + 1 + secondSize + 1;
+			char * first = reader.read (blockSize);
+			if (!first)
 			{
-				ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey,
-									 "Expected newline '\\n' but got '%c' at position %zd.\n", newline,
-									 static_cast<size_t> (is.tellg ()));
+				ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Unexpected end of dumpfile at position %zu",
+									 reader.position ());
 				return ELEKTRA_PLUGIN_STATUS_ERROR;
 			}
+			char * second = first + firstSize + 1;
 
-			std::string value (valueSize, '\0');
-			is.read (&value[0], valueSize);
-
-			is.read (&newline, 1);
-			if (newline != '\n')
+			size_t blockPosition = reader.position () - blockSize;
+			if (!terminateBlock (first, firstSize, blockPosition, parentKey) ||
+			    !terminateBlock (first, firstSize + 1 + secondSize, blockPosition, parentKey))
 			{
-				ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey,
-									 "Expected newline '\\n' but got '%c' at position %zd.\n", newline,
-									 static_cast<size_t> (is.tellg ()));
 				return ELEKTRA_PLUGIN_STATUS_ERROR;
 			}
 
-			keySetMeta (cur, name.c_str (), value.c_str ());
-		}
-		else if (command == "$copymeta")
-		{
-			size_t keyNameSize;
-			size_t metaNameSize;
-
-			ss >> keyNameSize;
-			ss >> metaNameSize;
+			if (isKey)
+			{
+				name.assign (rootName).append (first, firstSize);
 
-			std::string keyName (keyNameSize, '\0');
-			is.read (&keyName[0], keyNameSize);
+				if (!binary)
+				{
+					cur = keyNew (name.c_str (), KEY_VALUE, second, KEY_END);
+				}
+				else if (secondSize > 0)
+				{
+					cur = keyNew (name.c_str (), KEY_BINARY, KEY_SIZE, secondSize, KEY_VALUE, second, KEY_END);
+				}
+				else
+				{
+					cur = keyNew (name.c_str (), KEY_BINARY, KEY_SIZE, secondSize, KEY_END);
+				}
 
-			is.read (&newline, 1);
-			if (newline != '\n')
+				ksAppendKey (ks, cur);
+			}
+			else if (isMeta)
 			{
-				ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey,
-									 "Expected newline '\\n' but got '%c' at position %zd.\n", newline,
-									 static_cast<size_t> (is.tellg ()));
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
+				keySetMeta (cur, first, second);
 			}
-
-			std::string metaName (metaNameSize, '\0');
-			is.read (&metaName[0], metaNameSize);
-
-			is.read (&newline, 1);
-			if (newline != '\n')
+			else
 			{
-				ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey,
-									 "Expected newline '\\n' but got '%c' at position %zd.\n", newline,
-									 static_cast<size_t> (is.tellg ()));
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
+				name.assign (rootName).append (first, firstSize);
+				ckdb::Key * source = ckdb::ksLookupByName (ks, name.c_str (), 0);
+				keyCopyMeta (cur, source, second);
 			}
-
-			ckdb::Key * source = ckdb::ksLookupByName (ks, (rootName + keyName).c_str (), 0);
-			keyCopyMeta (cur, source, metaName.c_str ());
 		}
-		else if (command == "$end")
+		else if (command.is ("$end"))
 		{
 			break;
 		}
@@ -449,9 +595,9 @@ int unserialiseVersion2 (std::istream & is, ckdb::Key * parentKey, ckdb::KeySet
 		{
 			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (
 				parentKey,
-				"Unknown command detected in dumpfile: %s.\nMaybe the file is not in dump configuration file format? "
+				"Unknown command detected in dumpfile: %.*s.\nMaybe the file is not in dump configuration file format? "
 				"Try to remount with another plugin (eg. ini, ni, etc.)",
-				command.c_str ());
+				command.size, command.data);
 			return ELEKTRA_PLUGIN_STATUS_ERROR;
 		}
 	}
@@ -461,16 +607,18 @@ int unserialiseVersion2 (std::istream & is, ckdb::Key * parentKey, ckdb::KeySet
 
 int unserialise (std::istream & is, ckdb::Key * parentKey, ckdb::KeySet * ks, bool useFullNames)
 {
-	std::string line;
+	Reader reader (is);
+	char * line;
+	size_t length;
 
-	if (std::getline (is, line))
+	if (reader.getline (line, length))
 	{
-		if (line == "kdbOpen 2")
+		if (strcmp (line, "kdbOpen 2") == 0)
 		{
-			return unserialiseVersion2 (is, parentKey, ks, useFullNames);
+			return unserialiseVersion2 (reader, parentKey, ks, useFullNames);
 		}
 
-		return unserialiseVersion1 (is, parentKey, ks, line);
+		return unserialiseVersion1 (reader, parentKey, ks, line, length);
 	}
 
 	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
@@ -482,7 +630,7 @@ class pipebuf : public std::streambuf
 	int fd_;
 
 public:
-	pipebuf (int fd) : buffer_ (new char[4096]), fd_ (fd)
+	pipebuf (int fd) : buffer_ (new char[bufferSize]), fd_ (fd)
 	{
 	}
 	~pipebuf ()
@@ -494,7 +642,7 @@ public:
 		if (this->gptr () == this->egptr ())
 		{
 			// read from the pipe directly into the buffer
-			ssize_t r = read (fd_, buffer_, 4096);
+			ssize_t r = read (fd_, buffer_, bufferSize);
 			this->setg (this->buffer_, this->buffer_, this->buffer_ + r);
 		}
 		return this->gptr () == this->egptr () ? std::char_traits<char>::eof () :
@@ -612,6 +612,52 @@ static void test_v2_demo_root (void)
 	ksDel (ks);
 }
 
+static void test_v2_largeValue (void)
+{
+	printf ("test v2 large value\n");
+
+	// values larger than the read buffer and many keys spanning several buffers
+	size_t largeSize = 200 * 1024;
+	char * largeValue = elektraMalloc (largeSize + 1);
+	for (size_t i = 0; i < largeSize; ++i)
+	{
+		largeValue[i] = i % 100 == 99 ? '\n' : 'a' + i % 26;
+	}
+	largeValue[largeSize] = '\0';
+
+	KeySet * expected = ksNew (0, KS_END);
+	ksAppendKey (expected, keyNew ("user:/tests/script", KEY_VALUE, largeValue, KEY_META, "meta", largeValue, KEY_END));
+	for (int i = 0; i < 5000; ++i)
+	{
+		char name[64];
+		snprintf (name, sizeof (name), "user:/tests/script/key%d", i);
+		Key * key = keyNew (name, KEY_BINARY, KEY_SIZE, sizeof (name), KEY_VALUE, name, KEY_END);
+		keyCopyMeta (key, ksAtCursor (expected, 0), "meta");
+		ksAppendKey (expected, key);
+	}
+	ksAppendKey (expected, keyNew ("user:/tests/script/large", KEY_VALUE, largeValue, KEY_END));
+
+	char * outfile = elektraStrDup (elektraFilename ());
+	Key * parentKey = keyNew ("user:/tests/script", KEY_VALUE, outfile, KEY_END);
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("dump");
+
+	succeed_if (plugin->kdbSet (plugin, expected, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+
+	KeySet * ks = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+	compare_keyset (expected, ks);
+	succeed_if_same_string (keyString (keyGetMeta (ksLookupByName (ks, "user:/tests/script/key4999", 0), "meta")), largeValue);
+
+	remove (outfile);
+	ksDel (ks);
+	ksDel (expected);
+	keyDel (parentKey);
+	PLUGIN_CLOSE ();
+	elektraFree (outfile);
+	elektraFree (largeValue);
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("DUMP       TESTS\n");
@@ -633,6 +679,7 @@ int main (int argc, char ** argv)
 	test_v2_fullnames ();
 	test_v2_demo ();
 	test_v2_demo_root ();
+	test_v2_largeValue ();
 
 	print_result ("testmod_dump");
 
@@ -46,7 +46,7 @@ ssize_t keySetStringF (Key * key, const char * format, ...)
 
 	key->data.c = p;
 	key->dataSize = elektraStrLen (key->data.c);
-	set_bit (key->flags, KEY_FLAG_SYNC);
+	elektraKeyMarkSync (key);
 
 	return key->dataSize;
 }
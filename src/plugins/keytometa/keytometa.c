@@ -15,6 +15,7 @@
 
 
 #include <errno.h>
+#include <kdbprivate.h> // for ksRenameEach
 #include <stdbool.h>
 #include <stdlib.h>
 
@@ -53,6 +54,9 @@ static Key * findNearestParent (Key * key, KeySet * ks)
 
 	for (elektraCursor cursor = ksGetCursor (ks) - 1; (current = ksAtCursor (ks, cursor)) != NULL; --cursor)
 	{
+		/* skip keys that were already converted */
+		if (keyGetMeta (current, CONVERT_TARGET)) continue;
+
 		if (keyIsBelow (current, key))
 		{
 			return current;
@@ -114,13 +118,22 @@ static const char * getAppendMode (Key * key)
 	return appendMode;
 }
 
-void removeKeyFromResult (Key * convertKey, Key * target, KeySet * orig)
+static void removeKeyFromResult (Key * convertKey, Key * target)
 {
-	/* remember which key this key was converted to
-	 * before removing it from the result
+	/* remember which key this key was converted to,
+	 * it is removed from the result in removeConvertedKeys
 	 */
 	keySetMeta (convertKey, CONVERT_TARGET, keyName (target));
-	keyDel (ksLookup (orig, convertKey, KDB_O_POP));
+}
+
+static int removeConvertedKey (Key * key, void * data ELEKTRA_UNUSED)
+{
+	return keyGetMeta (key, CONVERT_TARGET) ? -1 : 0;
+}
+
+static void removeConvertedKeys (KeySet * orig)
+{
+	ksRenameEach (orig, 0, ksGetSize (orig), removeConvertedKey, NULL);
 }
 
 static void flushConvertedKeys (Key * target, KeySet * converted, KeySet * orig)
@@ -160,7 +173,7 @@ static void flushConvertedKeys (Key * target, KeySet * converted, KeySet * orig)
 		}
 
 		elektraKeyAppendMetaLine (appendTarget, metaName, keyString (current));
-		removeKeyFromResult (current, target, orig);
+		removeKeyFromResult (current, target);
 	}
 
 	ksClear (converted);
@@ -211,7 +224,7 @@ static KeySet * convertKeys (Key ** keyArray, size_t numKeys, KeySet * orig)
 			Key * parent = findNearestParent (current, orig);
 			elektraKeyAppendMetaLine (parent, metaName, keyString (current));
 			ksAppendKey (result, current);
-			removeKeyFromResult (current, parent, orig);
+			removeKeyFromResult (current, parent);
 		}
 
 		if (bufferKey)
@@ -262,6 +275,7 @@ int elektraKeyToMetaGet (Plugin * handle, KeySet * returned, Key * parentKey ELE
 	qsort (keyArray, numKeys, sizeof (Key *), elektraKeyCmpOrderWrapper);
 
 	KeySet * convertedKeys = convertKeys (keyArray, numKeys, returned);
+	removeConvertedKeys (returned);
 
 	elektraFree (keyArray);
 
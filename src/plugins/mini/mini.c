@@ -234,66 +234,31 @@ static int parseFile (KeySet * returned, Key * parentKey)
 }
 
 /**
- * @brief Add an error to `parentKey` and restore `errno` if `status` contains
- *        a negative number (write error).
+ * @brief Serialize the key value pairs of a key set using an INI like format
  *
- * @pre The parameter `parentKey` must not be `NULL`.
- *
- * @param status This value will be checked by this function to determine if
- *               the write function (`fprintf`) returned unsuccessfully
- * @param errorNumber A saved value for `errno` this function should restore
- *                    if `status` indicates an write error
- * @param parentKey The key to which this function will add error information
- *                  if `status` indicates an write error
- *
- * @retval ELEKTRA_PLUGIN_STATUS_SUCCESS if status indicates success (`status >= 0`)
- * @retval ELEKTRA_PLUGIN_STATUS_ERROR if there was a write error (`status < 0`)
- */
-static inline int checkWrite (int status, int errorNumber, Key * parentKey)
-{
-	ELEKTRA_NOT_NULL (parentKey);
-
-	if (status < 0)
-	{
-		ELEKTRA_SET_ERROR_SET (parentKey);
-		errno = errorNumber;
-		return ELEKTRA_PLUGIN_STATUS_ERROR;
-	}
-
-	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
-}
-
-/**
- * @brief Store the key value pairs of a key set in a file using an INI like format
- *
- * @pre The parameters `file`, `keySet`, and `parentKey` must not be `NULL`.
+ * @pre The parameters `buffer`, `keySet`, and `parentKey` must not be `NULL`.
  *
+ * @param buffer The function appends the serialized key value pairs to this buffer
  * @param keySet This key set contains the key value pairs that should be stored
- *               in `file`
- * @param parentKey The function uses this key to store error and warning information
- *
- * @retval ELEKTRA_PLUGIN_STATUS_SUCCESS if the function was able to store all key value
- *                                       pairs successfully
- * @retval ELEKTRA_PLUGIN_STATUS_ERROR if the function was unable to store all key value
- *                                     pairs in `file`
+ * @param parentKey The function stores the names of the keys relative to this key
  */
-static inline int writeFile (FILE * file, KeySet * keySet, Key * parentKey)
+static inline void writeKeys (ElektraOutputBuffer * buffer, KeySet * keySet, Key * parentKey)
 {
-	ELEKTRA_NOT_NULL (file);
+	ELEKTRA_NOT_NULL (buffer);
 	ELEKTRA_NOT_NULL (keySet);
 	ELEKTRA_NOT_NULL (parentKey);
 
-	int status = 0;
-	int errorNumber = errno;
-	ksRewind (keySet);
-	for (Key * key; (key = ksNext (keySet)) != 0 && status >= 0;)
+	for (elektraCursor it = 0; it < ksGetSize (keySet); ++it)
 	{
+		Key * key = ksAtCursor (keySet, it);
 		const char * name = elektraKeyGetRelativeName (key, parentKey);
 		ELEKTRA_LOG_DEBUG ("Write mapping “%s=%s”", name, keyString (key));
 
-		status = fprintf (file, "%s=%s\n", name, keyString (key));
+		elektraOutputBufferAppendString (buffer, name);
+		elektraOutputBufferAppendChar (buffer, '=');
+		elektraOutputBufferAppendString (buffer, keyString (key));
+		elektraOutputBufferAppendChar (buffer, '\n');
 	}
-	return checkWrite (status, errorNumber, parentKey);
 }
 
 // ====================
@@ -321,9 +286,13 @@ int elektraMiniSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * par
 {
 	ELEKTRA_LOG ("Write configuration data");
 	int errorNumber = errno;
-	FILE * destination = fopen (keyString (parentKey), "w");
+	ElektraOutputBuffer buffer;
+	elektraOutputBufferInit (&buffer, elektraOutputBufferEstimate (returned));
+	writeKeys (&buffer, returned, parentKey);
 
-	if (!destination || (writeFile (destination, returned, parentKey) < 0) | (fclose (destination) == EOF)) //! OCLint
+	int status = elektraOutputBufferWrite (&buffer, keyString (parentKey));
+	elektraOutputBufferFree (&buffer);
+	if (status == -1)
 	{
 		ELEKTRA_SET_ERROR_SET (parentKey);
 		errno = errorNumber;
@@ -113,6 +113,23 @@ static void test_set (void)
 	PLUGIN_CLOSE ();
 }
 
+static void test_setError (void)
+{
+	printf ("• Write to invalid file\n");
+
+	Key * parentKey = keyNew ("user:/mini/tests/write", KEY_VALUE, "/this/directory/does/not/exist/write.ini", KEY_END);
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("mini");
+
+	KeySet * keySet = ksNew (1, keyNew ("user:/mini/tests/write/key", KEY_VALUE, "value", KEY_END), KS_END);
+	succeed_if (plugin->kdbSet (plugin, keySet, parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR, "Writing to an invalid file should fail");
+	succeed_if (keyGetMeta (parentKey, "error") != NULL, "No error was added to the parent key");
+
+	keyDel (parentKey);
+	ksDel (keySet);
+	PLUGIN_CLOSE ();
+}
+
 /* -- Main ------------------------------------------------------------------------------------------------------------------------------ */
 
 int main (int argc, char ** argv)
@@ -125,6 +142,7 @@ int main (int argc, char ** argv)
 	test_basics ();
 	test_get ();
 	test_set ();
+	test_setError ();
 
 	print_result ("testmod_mini");
 
@@ -1,14 +1,14 @@
 /**
  * @file
  *
- * @brief Source for DynArray, a simple dynamic array for meta-key deduplication.
+ * @brief Source for DynArray, a simple dynamic array for meta-key and meta-keyset deduplication.
  *
- * The DynArray is used to store pointers of meta-keys. The dynArrayFindOrInsert function
+ * The DynArray is used to store pointers of meta-keys or meta-keysets. The dynArrayFindOrInsert function
  * searches for a pointer in the structure. If it is not yet in the array, it will be inserted.
  * If the underlying array is too small, it is resized such that it can accomodate further elements.
  * The dynArrayFind function only searches for elements.
  *
- * The mmapstorage plugin uses the DynArray to deduplicate meta-keys.
+ * The mmapstorage plugin uses the DynArray to deduplicate meta-keys and meta-keysets.
  *
  * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
  *
@@ -30,7 +30,7 @@
 DynArray * ELEKTRA_PLUGIN_FUNCTION (dynArrayNew) (void)
 {
 	DynArray * dynArray = elektraCalloc (sizeof (DynArray));
-	dynArray->keyArray = elektraCalloc (sizeof (Key *) * ELEKTRA_MMAP_DYNARRAY_MINSIZE);
+	dynArray->keyArray = elektraCalloc (sizeof (void *) * ELEKTRA_MMAP_DYNARRAY_MINSIZE);
 	dynArray->mappedKeyArray = 0;
 	dynArray->size = 0;
 	dynArray->alloc = ELEKTRA_MMAP_DYNARRAY_MINSIZE;
@@ -60,7 +60,7 @@ void ELEKTRA_PLUGIN_FUNCTION (dynArrayDelete) (DynArray * dynArray)
 }
 
 /**
- * @brief Find position or insert Key pointer into DynArray.
+ * @brief Find position or insert pointer (of a Key or KeySet) into DynArray.
  *
  * @param key to be found or inserted
  * @param dynArray where the key should be searched for or inserted
@@ -69,7 +69,7 @@ void ELEKTRA_PLUGIN_FUNCTION (dynArrayDelete) (DynArray * dynArray)
  * @retval 0 if the key was inserted
  * @retval 1 if the key was found
  */
-int ELEKTRA_PLUGIN_FUNCTION (dynArrayFindOrInsert) (Key * key, DynArray * dynArray)
+int ELEKTRA_PLUGIN_FUNCTION (dynArrayFindOrInsert) (void * key, DynArray * dynArray)
 {
 	size_t l = 0;
 	size_t h = dynArray->size;
@@ -105,8 +105,8 @@ int ELEKTRA_PLUGIN_FUNCTION (dynArrayFindOrInsert) (Key * key, DynArray * dynArr
 		{
 			return -1; // error
 		}
-		Key ** new = elektraCalloc ((2 * oldAllocSize) * sizeof (Key *));
-		memcpy (new, dynArray->keyArray, dynArray->size * sizeof (Key *));
+		void ** new = elektraCalloc ((2 * oldAllocSize) * sizeof (void *));
+		memcpy (new, dynArray->keyArray, dynArray->size * sizeof (void *));
 		elektraFree (dynArray->keyArray);
 		dynArray->keyArray = new;
 		dynArray->alloc = 2 * oldAllocSize;
@@ -120,14 +120,14 @@ int ELEKTRA_PLUGIN_FUNCTION (dynArrayFindOrInsert) (Key * key, DynArray * dynArr
 }
 
 /**
- * @brief Find Key pointer in the DynArray.
+ * @brief Find pointer (of a Key or KeySet) in the DynArray.
  *
  * @param key Key pointer to search for
  * @param dynArray where the Key should be searched for
  *
  * @return position of the Key pointer in the DynArray, or -1 if not found or size exceeded
  */
-ssize_t ELEKTRA_PLUGIN_FUNCTION (dynArrayFind) (Key * key, DynArray * dynArray)
+ssize_t ELEKTRA_PLUGIN_FUNCTION (dynArrayFind) (void * key, DynArray * dynArray)
 {
 	size_t l = 0;
 	size_t h = dynArray->size;
@@ -1,7 +1,7 @@
 /**
  * @file
  *
- * @brief Header for DynArray, a simple dynamic array for meta-key deduplication.
+ * @brief Header for DynArray, a simple dynamic array for meta-key and meta-keyset deduplication.
  *
  * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
  *
@@ -15,8 +15,8 @@ struct _dynArray
 {
 	size_t size;
 	size_t alloc;
-	Key ** keyArray;
-	Key ** mappedKeyArray;
+	void ** keyArray;
+	void ** mappedKeyArray;
 };
 
 typedef struct _dynArray DynArray;
@@ -24,7 +24,7 @@ typedef struct _dynArray DynArray;
 // DynArray functions
 DynArray * ELEKTRA_PLUGIN_FUNCTION (dynArrayNew) (void);
 void ELEKTRA_PLUGIN_FUNCTION (dynArrayDelete) (DynArray * dynArray);
-int ELEKTRA_PLUGIN_FUNCTION (dynArrayFindOrInsert) (Key * key, DynArray * dynArray);
-ssize_t ELEKTRA_PLUGIN_FUNCTION (dynArrayFind) (Key * key, DynArray * dynArray);
+int ELEKTRA_PLUGIN_FUNCTION (dynArrayFindOrInsert) (void * key, DynArray * dynArray);
+ssize_t ELEKTRA_PLUGIN_FUNCTION (dynArrayFind) (void * key, DynArray * dynArray);
 
 #endif
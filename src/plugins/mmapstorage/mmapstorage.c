@@ -407,6 +407,7 @@ static void initMagicKeySet (const uintptr_t magicNumber)
 	magicKeySet.flags = KS_FLAG_MMAP_ARRAY | KS_FLAG_SYNC;
 	magicKeySet.refs = UINT16_MAX;
 	magicKeySet.reserved = 0;
+	magicKeySet.changes = 0;
 #ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
 	magicKeySet.opmphm = (Opmphm *) ELEKTRA_MMAP_MAGIC_BOM;
 	magicKeySet.opmphmPredictor = 0;
@@ -427,6 +428,7 @@ static void initMagicKey (const uintptr_t magicNumber)
 	magicKey.ukey = 0;
 	magicKey.keyUSize = 0;
 	magicKey.meta = (KeySet *) ELEKTRA_MMAP_MAGIC_BOM;
+	magicKey.owner = 0;
 	magicKey.flags = KEY_FLAG_MMAP_STRUCT | KEY_FLAG_MMAP_DATA | KEY_FLAG_MMAP_KEY | KEY_FLAG_SYNC;
 	magicKey.refs = UINT16_MAX / 2;
 	magicKey.reserved = UINT16_MAX;
@@ -614,21 +616,22 @@ static int verifyChecksum (char * mappedRegion, MmapHeader * mmapHeader, PluginM
  * Iterates over the KeySet and calculates the complete size in bytes, needed to store the KeySet
  * within a mapped region. The size includes all mmap meta-information, magic KeySet and Key for
  * consistency checks, KeySets, meta-KeySets, Keys, meta-Keys, Key names and values.
- * Copied meta-Keys are counted once for deduplication. If needed, padding is added to align the
+ * Copied meta-Keys and shared meta-KeySets are counted once for deduplication. If needed, padding is added to align the
  * MmapFooter properly at the end of the mapping. When the plugin is in a global position,
  * acting as a cache, the calculated size includes the global KeySet.
  *
  * The complete size and some other meta-information are stored in the MmapHeader and MmapMetaData.
- * The DynArray stores the unique meta-Key pointers needed for deduplication.
+ * The DynArrays store the unique meta-Key and meta-KeySet pointers needed for deduplication.
  *
  * @param mmapHeader to store the allocation size
  * @param mmapMetaData to store the number of KeySets and Keys
  * @param returned the KeySet that should be stored
  * @param global the global KeySet
  * @param dynArray to store meta-key pointers for deduplication
+ * @param metaKsArray to store meta-keyset pointers for deduplication
  */
 static void calculateMmapDataSize (MmapHeader * mmapHeader, MmapMetaData * mmapMetaData, KeySet * returned, KeySet * global,
-				   DynArray * dynArray)
+				   DynArray * dynArray, DynArray * metaKsArray)
 {
 	Key * cur;
 	ksRewind (returned);
@@ -640,8 +643,9 @@ static void calculateMmapDataSize (MmapHeader * mmapHeader, MmapMetaData * mmapM
 	{
 		dataBlocksSize += (cur->keySize + cur->keyUSize + cur->dataSize);
 
-		if (cur->meta && cur->meta->size > 0)
+		if (cur->meta && cur->meta->size > 0 && ELEKTRA_PLUGIN_FUNCTION (dynArrayFindOrInsert) (cur->meta, metaKsArray) == 0)
 		{
+			// meta keyset was just inserted
 			++mmapMetaData->numKeySets;
 
 			Key * curMeta;
@@ -670,8 +674,10 @@ static void calculateMmapDataSize (MmapHeader * mmapHeader, MmapMetaData * mmapM
 		{
 			dataBlocksSize += (globalKey->keySize + globalKey->keyUSize + globalKey->dataSize);
 
-			if (globalKey->meta && globalKey->meta->size > 0)
+			if (globalKey->meta && globalKey->meta->size > 0 &&
+			    ELEKTRA_PLUGIN_FUNCTION (dynArrayFindOrInsert) (globalKey->meta, metaKsArray) == 0)
 			{
+				// meta keyset was just inserted
 				++mmapMetaData->numKeySets;
 
 				Key * curMeta;
@@ -778,6 +784,7 @@ static void writeMetaKeys (MmapAddr * mmapAddr, DynArray * dynArray)
 		// move Key itself
 		mmapMetaKey->flags |= KEY_FLAG_MMAP_STRUCT;
 		mmapMetaKey->meta = 0;
+		mmapMetaKey->owner = 0;
 		mmapMetaKey->refs = 0;
 
 		dynArray->mappedKeyArray[i] = mmapMetaKey;
@@ -787,38 +794,52 @@ static void writeMetaKeys (MmapAddr * mmapAddr, DynArray * dynArray)
 /**
  * @brief Writes a meta keyset of a key to the mapped region.
  *
+ * A meta keyset shared by several keys is only written once,
+ * its reference counter is the number of keys sharing it.
+ *
  * @param key holding the meta-keyset
  * @param mmapAddr structure holding pointers to the mapped region
  * @param dynArray holding deduplicated references to meta-keys
+ * @param metaKsArray holding deduplicated references to meta-keysets
  *
  * @return pointer to the new meta keyset
  */
-static KeySet * writeMetaKeySet (Key * key, MmapAddr * mmapAddr, DynArray * dynArray)
+static KeySet * writeMetaKeySet (Key * key, MmapAddr * mmapAddr, DynArray * dynArray, DynArray * metaKsArray)
 {
 	// write the meta KeySet
 	if (!key->meta || !(key->meta->size > 0)) return 0;
 
-	KeySet * newMeta = (KeySet *) mmapAddr->metaKsPtr;
+	ssize_t metaKsIndex = ELEKTRA_PLUGIN_FUNCTION (dynArrayFind) (key->meta, metaKsArray);
+	KeySet * newMeta = metaKsArray->mappedKeyArray[metaKsIndex];
+	if (newMeta)
+	{
+		// already written for another key, the keys cannot exceed the limit of the counter, because they share it in memory too
+		++newMeta->refs;
+		return (KeySet *) ((char *) newMeta - mmapAddr->mmapAddrInt);
+	}
+
+	newMeta = (KeySet *) mmapAddr->metaKsPtr;
 	mmapAddr->metaKsPtr += SIZEOF_KEYSET;
 
 	newMeta->flags = key->meta->flags | KS_FLAG_MMAP_STRUCT | KS_FLAG_MMAP_ARRAY;
+	newMeta->refs = 1;
+	newMeta->changes = 0;
 	newMeta->array = (Key **) mmapAddr->metaKsArrayPtr;
 	mmapAddr->metaKsArrayPtr += SIZEOF_KEY_PTR * key->meta->alloc;
+	metaKsArray->mappedKeyArray[metaKsIndex] = newMeta;
 
-	keyRewindMeta (key);
-	size_t metaKeyIndex = 0;
+	// keyRewindMeta() would copy shared metadata
 	Key * mappedMetaKey = 0;
-	const Key * metaKey;
-	while ((metaKey = keyNextMeta (key)) != 0)
+	for (size_t metaKeyIndex = 0; metaKeyIndex < key->meta->size; ++metaKeyIndex)
 	{
 		// get address of mapped key and store it in the new array
-		mappedMetaKey = dynArray->mappedKeyArray[ELEKTRA_PLUGIN_FUNCTION (dynArrayFind) ((Key *) metaKey, dynArray)];
+		Key * metaKey = key->meta->array[metaKeyIndex];
+		mappedMetaKey = dynArray->mappedKeyArray[ELEKTRA_PLUGIN_FUNCTION (dynArrayFind) (metaKey, dynArray)];
 		newMeta->array[metaKeyIndex] = (Key *) ((char *) mappedMetaKey - mmapAddr->mmapAddrInt);
 		if (mappedMetaKey->refs < UINT16_MAX - 1)
 		{
 			++(mappedMetaKey->refs);
 		}
-		++metaKeyIndex;
 	}
 	newMeta->array[key->meta->size] = 0;
 	newMeta->array = (Key **) ((char *) newMeta->array - mmapAddr->mmapAddrInt);
@@ -837,8 +858,9 @@ static KeySet * writeMetaKeySet (Key * key, MmapAddr * mmapAddr, DynArray * dynA
  * @param keySet holding the keys to be written to the mapped region
  * @param mmapAddr structure holding pointers to the mapped region
  * @param dynArray holding deduplicated meta-key pointers
+ * @param metaKsArray holding deduplicated meta-keyset pointers
  */
-static void writeKeys (KeySet * keySet, MmapAddr * mmapAddr, DynArray * dynArray, PluginMode mode)
+static void writeKeys (KeySet * keySet, MmapAddr * mmapAddr, DynArray * dynArray, DynArray * metaKsArray, PluginMode mode)
 {
 	Key * cur;
 	size_t keyIndex = 0;
@@ -893,10 +915,11 @@ static void writeKeys (KeySet * keySet, MmapAddr * mmapAddr, DynArray * dynArray
 		}
 
 		// write the meta KeySet
-		mmapKey->meta = writeMetaKeySet (cur, mmapAddr, dynArray);
+		mmapKey->meta = writeMetaKeySet (cur, mmapAddr, dynArray, metaKsArray);
 
-		// move Key itself
+		// move Key itself, the mapped keys are not tracked by any keyset
 		mmapKey->flags |= KEY_FLAG_MMAP_STRUCT;
+		mmapKey->owner = 0;
 		mmapKey->refs = 1;
 
 		// write the relative Key pointer into the KeySet array
@@ -941,13 +964,14 @@ static void printMmapMetaData (MmapMetaData * mmapMetaData ELEKTRA_UNUSED)
  * @param mmapMetaData containing meta-information of the mapped region
  * @param mmapFooter containing a magic number for consistency checks
  * @param dynArray containing deduplicated pointers to meta-keys
+ * @param metaKsArray containing deduplicated pointers to meta-keysets
  * @param mode the current plugin mode
  *
  * @retval 0 on success
  * @retval -1 if msync() failed
  */
 static int copyKeySetToMmap (char * const dest, KeySet * keySet, KeySet * global, MmapHeader * mmapHeader, MmapMetaData * mmapMetaData,
-			     MmapFooter * mmapFooter, DynArray * dynArray, PluginMode mode)
+			     MmapFooter * mmapFooter, DynArray * dynArray, DynArray * metaKsArray, PluginMode mode)
 {
 	writeMagicData (dest);
 
@@ -1015,13 +1039,17 @@ static int copyKeySetToMmap (char * const dest, KeySet * keySet, KeySet * global
 	// first write the meta keys into place
 	writeMetaKeys (&mmapAddr, dynArray);
 
+	// remember the addresses of mapped meta keysets, which are written together with the first key using them
+	metaKsArray->mappedKeyArray = elektraCalloc ((metaKsArray->size > 0 ? metaKsArray->size : 1) * sizeof (KeySet *));
+
 	if (global)
 	{
 		ELEKTRA_LOG_DEBUG ("writing GLOBAL KEYSET");
-		if (global->size != 0) writeKeys (global, &mmapAddr, dynArray, MODE_GLOBALCACHE);
+		if (global->size != 0) writeKeys (global, &mmapAddr, dynArray, metaKsArray, MODE_GLOBALCACHE);
 
 		set_bit (mmapHeader->formatFlags, MMAP_FLAG_TIMESTAMPS);
 		mmapAddr.globalKsPtr->flags = global->flags | KS_FLAG_MMAP_STRUCT | KS_FLAG_MMAP_ARRAY;
+		mmapAddr.globalKsPtr->changes = 0;
 		mmapAddr.globalKsPtr->array = (Key **) mmapAddr.globalKsArrayPtr;
 		mmapAddr.globalKsPtr->array[global->size] = 0;
 		mmapAddr.globalKsPtr->array = (Key **) (mmapAddr.globalKsArrayPtr - mmapAddr.mmapAddrInt);
@@ -1032,10 +1060,11 @@ static int copyKeySetToMmap (char * const dest, KeySet * keySet, KeySet * global
 	if (keySet->size != 0)
 	{
 		// now write Keys including meta KeySets
-		writeKeys (keySet, &mmapAddr, dynArray, MODE_STORAGE);
+		writeKeys (keySet, &mmapAddr, dynArray, metaKsArray, MODE_STORAGE);
 	}
 
 	mmapAddr.ksPtr->flags = keySet->flags | KS_FLAG_MMAP_STRUCT | KS_FLAG_MMAP_ARRAY;
+	mmapAddr.ksPtr->changes = 0;
 	mmapAddr.ksPtr->array = (Key **) mmapAddr.ksArrayPtr;
 	mmapAddr.ksPtr->array[keySet->size] = 0;
 	mmapAddr.ksPtr->array = (Key **) (mmapAddr.ksArrayPtr - mmapAddr.mmapAddrInt);
@@ -1525,6 +1554,7 @@ int ELEKTRA_PLUGIN_FUNCTION (set) (Plugin * handle ELEKTRA_UNUSED, KeySet * ks,
 	int fd = -1;
 	char * mappedRegion = MAP_FAILED;
 	DynArray * dynArray = 0;
+	DynArray * metaKsArray = 0;
 	Key * initialParent = keyDup (parentKey, KEY_CP_ALL);
 
 	if (elektraStrCmp (keyString (parentKey), STDOUT_FILENAME) == 0)
@@ -1555,12 +1585,13 @@ int ELEKTRA_PLUGIN_FUNCTION (set) (Plugin * handle ELEKTRA_UNUSED, KeySet * ks,
 	}
 
 	dynArray = ELEKTRA_PLUGIN_FUNCTION (dynArrayNew) ();
+	metaKsArray = ELEKTRA_PLUGIN_FUNCTION (dynArrayNew) ();
 
 	MmapHeader mmapHeader;
 	MmapMetaData mmapMetaData;
 	initHeader (&mmapHeader);
 	initMetaData (&mmapMetaData);
-	calculateMmapDataSize (&mmapHeader, &mmapMetaData, ks, global, dynArray);
+	calculateMmapDataSize (&mmapHeader, &mmapMetaData, ks, global, dynArray, metaKsArray);
 	ELEKTRA_LOG_DEBUG ("mmapsize: %" PRIu64, mmapHeader.allocSize);
 
 	if (!test_bit (mode, MODE_NONREGULAR_FILE) && truncateFile (fd, mmapHeader.allocSize, parentKey, mode) != 1)
@@ -1578,7 +1609,7 @@ int ELEKTRA_PLUGIN_FUNCTION (set) (Plugin * handle ELEKTRA_UNUSED, KeySet * ks,
 
 	MmapFooter mmapFooter;
 	initFooter (&mmapFooter);
-	if (copyKeySetToMmap (mappedRegion, ks, global, &mmapHeader, &mmapMetaData, &mmapFooter, dynArray, mode) != 0)
+	if (copyKeySetToMmap (mappedRegion, ks, global, &mmapHeader, &mmapMetaData, &mmapFooter, dynArray, metaKsArray, mode) != 0)
 	{
 		goto error;
 	}
@@ -1614,6 +1645,7 @@ int ELEKTRA_PLUGIN_FUNCTION (set) (Plugin * handle ELEKTRA_UNUSED, KeySet * ks,
 	}
 
 	ELEKTRA_PLUGIN_FUNCTION (dynArrayDelete) (dynArray);
+	ELEKTRA_PLUGIN_FUNCTION (dynArrayDelete) (metaKsArray);
 	keySetString (parentKey, keyString (initialParent));
 	if (initialParent) keyDel (initialParent);
 	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
@@ -1643,6 +1675,7 @@ error:
 	keySetString (parentKey, keyString (initialParent));
 	if (initialParent) keyDel (initialParent);
 	ELEKTRA_PLUGIN_FUNCTION (dynArrayDelete) (dynArray);
+	ELEKTRA_PLUGIN_FUNCTION (dynArrayDelete) (metaKsArray);
 
 	errno = errnosave;
 	return ELEKTRA_PLUGIN_STATUS_ERROR;
@@ -735,6 +735,71 @@ static void test_mmap_metacopy (const char * tmpFile)
 	PLUGIN_CLOSE ();
 }
 
+static void test_mmap_shared_meta_keyset (const char * tmpFile)
+{
+	Key * parentKey = keyNew (TEST_ROOT_KEY, KEY_VALUE, tmpFile, KEY_END);
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("mmapstorage");
+
+	Key * metaTemplate = keyNew ("/", KEY_META, "type", "long", KEY_META, "check/range", "0-100", KEY_END);
+	KeySet * ks = ksNew (0, KS_END);
+	for (int i = 0; i < 100; ++i)
+	{
+		char name[64];
+		snprintf (name, sizeof (name), "%s/shared/%03d", TEST_ROOT_KEY, i);
+		Key * key = keyNew (name, KEY_VALUE, "42", KEY_END);
+		keyCopyAllMeta (key, metaTemplate);
+		ksAppendKey (ks, key);
+	}
+	KeySet * expected = ksDeepDup (ks);
+
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == 1, "kdbSet was not successful");
+
+	struct stat sharedStat;
+	succeed_if (stat (tmpFile, &sharedStat) == 0, "could not stat mmap file");
+
+	KeySet * returned = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGet (plugin, returned, parentKey) == 1, "kdbGet was not successful");
+
+	Key * first = ksLookupByName (returned, TEST_ROOT_KEY "/shared/000", 0);
+	Key * last = ksLookupByName (returned, TEST_ROOT_KEY "/shared/099", 0);
+	exit_if_fail (first && last, "keys not found");
+	succeed_if (first->meta == last->meta, "metadata KeySet was not shared after kdbGet");
+	succeed_if (first->meta->refs == 100, "wrong reference count of shared metadata KeySet");
+
+	// iterating with keyRewindMeta() unshares, so compare afterwards
+	compare_keyset (expected, returned);
+
+	// modifying the metadata of one key must not affect the others
+	keySetMeta (first, "check/range", "0-10");
+	succeed_if_same_string (keyString (keyGetMeta (last, "check/range")), "0-100");
+	succeed_if (first->meta != last->meta, "metadata KeySet was not unshared on write");
+
+	ksDel (returned);
+
+	// the same keys with separately allocated metadata must need more space
+	KeySet * unshared = ksNew (0, KS_END);
+	for (elektraCursor it = 0; it < ksGetSize (expected); ++it)
+	{
+		Key * key = keyNew (keyName (ksAtCursor (expected, it)), KEY_VALUE, "42", KEY_END);
+		keySetMeta (key, "type", "long");
+		keySetMeta (key, "check/range", "0-100");
+		ksAppendKey (unshared, key);
+	}
+	succeed_if (plugin->kdbSet (plugin, unshared, parentKey) == 1, "kdbSet was not successful");
+
+	struct stat unsharedStat;
+	succeed_if (stat (tmpFile, &unsharedStat) == 0, "could not stat mmap file");
+	succeed_if (sharedStat.st_size < unsharedStat.st_size, "shared metadata was not written only once");
+
+	ksDel (unshared);
+	ksDel (expected);
+	keyDel (parentKey);
+	keyDel (metaTemplate);
+	ksDel (ks);
+	PLUGIN_CLOSE ();
+}
+
 static void test_mmap_ks_copy_with_meta (const char * tmpFile)
 {
 	Key * parentKey = keyNew (TEST_ROOT_KEY, KEY_VALUE, tmpFile, KEY_END);
@@ -1140,6 +1205,9 @@ int main (int argc, char ** argv)
 
 	test_mmap_metacopy (tmpFile);
 
+	clearStorage (tmpFile);
+	test_mmap_shared_meta_keyset (tmpFile);
+
 	clearStorage (tmpFile);
 	test_mmap_filter_meta (tmpFile);
 
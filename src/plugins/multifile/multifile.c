@@ -70,6 +70,9 @@ typedef struct
 	char * storage;
 	unsigned short stayAlive;
 	unsigned short hasDeleted;
+	unsigned short statResolver;
+	unsigned short hasDirectoryTime;
+	struct timespec directoryTime;
 } MultiConfig;
 
 typedef struct
@@ -83,6 +86,10 @@ typedef struct
 	Plugin * storage;
 	Codes rcStorage;
 	KeySet * ks;
+	unsigned short hasStat;
+	struct timespec mtime;
+	off_t size;
+	ino_t inode;
 } SingleConfig;
 
 static inline Codes rvToRc (int rc)
@@ -262,6 +269,9 @@ static MultiConfig * initialize (Plugin * handle, Key * parentKey)
 		mc->pattern = elektraStrDup (DEFAULT_PATTERN);
 	}
 	if (stayAliveKey) mc->stayAlive = 1;
+	// the file based resolvers only report updates if the modification time changed,
+	// so we can check all files ourselves and skip the resolver for unchanged ones
+	mc->statResolver = !strcmp (mc->resolver, "resolver") || !strncmp (mc->resolver, "resolver_", sizeof ("resolver_") - 1);
 	Key * cutKey = keyNew ("/child", KEY_END);
 	KeySet * childConfig = ksCut (config, cutKey);
 	keyDel (cutKey);
@@ -335,6 +345,24 @@ static Codes updateFilesGlob (Plugin * handle, MultiConfig * mc, KeySet * found,
 	Codes rc = NOUPDATE;
 	glob_t results;
 	int ret;
+	struct stat sb;
+
+	// Files can only be added, removed or renamed if the modification time of the directory changes.
+	// Patterns with subdirectories also depend on the subdirectories, so they are always globbed.
+	struct timespec directoryTime = { 0, 0 };
+	int cacheable = strchr (mc->pattern, '/') == NULL && stat (mc->directory, &sb) == 0;
+	if (cacheable)
+	{
+		directoryTime.tv_sec = ELEKTRA_STAT_SECONDS (sb);
+		directoryTime.tv_nsec = ELEKTRA_STAT_NANO_SECONDS (sb);
+		if (mc->hasDirectoryTime && mc->directoryTime.tv_sec == directoryTime.tv_sec &&
+		    mc->directoryTime.tv_nsec == directoryTime.tv_nsec)
+		{
+			ksAppend (found, mc->childBackends);
+			return rc;
+		}
+	}
+	mc->hasDirectoryTime = 0;
 
 	char pattern[strlen (mc->directory) + strlen (mc->pattern) + 2];
 	snprintf (pattern, sizeof (pattern), "%s/%s", mc->directory, mc->pattern);
@@ -356,7 +384,6 @@ static Codes updateFilesGlob (Plugin * handle, MultiConfig * mc, KeySet * found,
 		}
 		return ERROR;
 	}
-	struct stat sb;
 	for (unsigned int i = 0; i < results.gl_pathc; ++i)
 	{
 		ret = stat (results.gl_pathv[i], &sb);
@@ -385,6 +412,8 @@ static Codes updateFilesGlob (Plugin * handle, MultiConfig * mc, KeySet * found,
 					else
 					{
 						closeBackend (s);
+						// retry the failed backend on the next glob
+						cacheable = 0;
 					}
 				}
 				else
@@ -400,9 +429,35 @@ static Codes updateFilesGlob (Plugin * handle, MultiConfig * mc, KeySet * found,
 		}
 	}
 	globfree (&results);
+	if (cacheable)
+	{
+		mc->directoryTime = directoryTime;
+		mc->hasDirectoryTime = 1;
+	}
 	return rc;
 }
 
+/**
+ * @retval 1 if the file did not change since the last call of its resolver
+ * @retval 0 otherwise
+ */
+static int fileUnchanged (SingleConfig * s)
+{
+	struct stat sb;
+	if (!s->hasStat || stat (s->fullPath, &sb) == -1) return 0;
+	return s->mtime.tv_sec == ELEKTRA_STAT_SECONDS (sb) && s->mtime.tv_nsec == ELEKTRA_STAT_NANO_SECONDS (sb) &&
+	       s->size == sb.st_size && s->inode == sb.st_ino;
+}
+
+static void rememberStat (SingleConfig * s, const struct stat * sb)
+{
+	s->mtime.tv_sec = ELEKTRA_STAT_SECONDS ((*sb));
+	s->mtime.tv_nsec = ELEKTRA_STAT_NANO_SECONDS ((*sb));
+	s->size = sb->st_size;
+	s->inode = sb->st_ino;
+	s->hasStat = 1;
+}
+
 static Codes updateFiles (Plugin * handle, MultiConfig * mc, KeySet * returned, Key * parentKey)
 {
 	Codes rc = NOUPDATE;
@@ -422,17 +477,41 @@ static Codes updateFiles (Plugin * handle, MultiConfig * mc, KeySet * returned,
 	Key * c;
 	ssize_t cacheHits = 0;
 	ssize_t numBackends = ksGetSize (found);
+	if (mc->statResolver)
+	{
+		// check all files in one pass, only changed files need their resolver
+		while ((c = ksNext (found)) != NULL)
+		{
+			SingleConfig * s = *(SingleConfig **) keyValue (c);
+			if (!fileUnchanged (s)) s->hasStat = 0;
+		}
+		ksRewind (found);
+	}
 	while ((c = ksNext (found)) != NULL)
 	{
 		if (ksLookup (mc->childBackends, c, KDB_O_POP))
 		{
 			SingleConfig * s = *(SingleConfig **) keyValue (c);
+			if (s->hasStat)
+			{
+				s->rcResolver = NOUPDATE;
+				continue;
+			}
+			// stat before the resolver, so that changes in between are seen by the next check
+			struct stat sb;
+			int hasStat = mc->statResolver && stat (s->fullPath, &sb) == 0;
+			char * checkedPath = elektraStrDup (s->fullPath);
 			keySetName (parentKey, s->parentString);
 			keySetString (parentKey, s->fullPath);
 			int r = resolverGet (s, returned, parentKey);
 			elektraFree (s->fullPath);
 			s->fullPath = elektraStrDup (keyString (parentKey));
 			s->rcResolver = rvToRc (r);
+			if (hasStat && s->rcResolver != ERROR && !strcmp (checkedPath, s->fullPath))
+			{
+				rememberStat (s, &sb);
+			}
+			elektraFree (checkedPath);
 			if (s->rcResolver == ERROR)
 			{
 				if (mc->stayAlive)
@@ -470,6 +549,8 @@ static Codes updateFiles (Plugin * handle, MultiConfig * mc, KeySet * returned,
 	{
 		closeBackends (found);
 		ksDel (found);
+		mc->childBackends = ksNew (0, KS_END);
+		mc->hasDirectoryTime = 0;
 	}
 	else
 	{
@@ -485,6 +566,24 @@ static Codes updateFiles (Plugin * handle, MultiConfig * mc, KeySet * returned,
 	return rc;
 }
 
+static Codes parseFile (SingleConfig * s, Key * parentKey)
+{
+	keySetName (parentKey, s->parentString);
+	keySetString (parentKey, s->fullPath);
+	Plugin * storage = s->storage;
+	KeySet * readKS = ksNew (0, KS_END);
+	int r = storage->kdbGet (storage, readKS, parentKey);
+	Codes rc = ERROR;
+	if (r > 0)
+	{
+		if (s->ks) ksDel (s->ks);
+		s->ks = ksDup (readKS);
+		rc = SUCCESS;
+	}
+	ksDel (readKS);
+	return rc;
+}
+
 static Codes doGetStorage (MultiConfig * mc, Key * parentKey)
 {
 	ksRewind (mc->childBackends);
@@ -495,24 +594,18 @@ static Codes doGetStorage (MultiConfig * mc, Key * parentKey)
 	{
 		SingleConfig * s = *(SingleConfig **) keyValue (k);
 		// When we reach this stage, we will need to load
-		// any successfully resolved files (as it is done in the kdb core)
+		// any successfully resolved files (as it is done in the kdb core),
+		// unchanged files keep their keys from the last parse
 		if (s->rcResolver < 0) continue;
-		keySetName (parentKey, s->parentString);
-		keySetString (parentKey, s->fullPath);
-		Plugin * storage = s->storage;
-		KeySet * readKS = ksNew (0, KS_END);
-		int r = storage->kdbGet (storage, readKS, parentKey);
-		if (r > 0)
+		if (s->rcResolver == NOUPDATE && s->ks) continue;
+		if (parseFile (s, parentKey) == ERROR)
 		{
-			if (s->ks) ksDel (s->ks);
-			s->ks = ksDup (readKS);
-			rc = SUCCESS;
+			rc = ERROR;
 		}
-		else
+		else if (rc != ERROR)
 		{
-			rc = ERROR;
+			rc = SUCCESS;
 		}
-		ksDel (readKS);
 	}
 	keySetName (parentKey, keyName (initialParent));
 	keySetString (parentKey, keyString (initialParent));
@@ -580,6 +673,8 @@ int elektraMultifileGet (Plugin * handle, KeySet * returned, Key * parentKey ELE
 	else if (mc->getPhase == MULTI_GETSTORAGE)
 	{
 		rc = doGetStorage (mc, parentKey);
+		// unchanged files are not parsed again, so removed files can be the only update
+		if (rc == NOUPDATE && mc->hasDeleted) rc = SUCCESS;
 		if (rc == SUCCESS || mc->hasDeleted)
 		{
 			fillReturned (mc, returned);
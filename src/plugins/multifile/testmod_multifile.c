@@ -0,0 +1,122 @@
+/**
+ * @file
+ *
+ * @brief Tests for multifile plugin
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <kdbconfig.h>
+
+#include <tests_plugin.h>
+
+#define PARENT_KEY "system:/tests/multifile"
+
+static void writeFile (const char * directory, const char * filename, const char * content, time_t mtime)
+{
+	char path[1024];
+	snprintf (path, sizeof (path), "%s/%s", directory, filename);
+	FILE * f = fopen (path, "w");
+	exit_if_fail (f != NULL, "could not create file");
+	fputs (content, f);
+	fclose (f);
+	struct timespec times[2] = { { mtime, 0 }, { mtime, 0 } };
+	succeed_if (utimensat (AT_FDCWD, path, times, 0) == 0, "could not set modification time of file");
+}
+
+static void setDirectoryTime (const char * directory, time_t mtime)
+{
+	struct timespec times[2] = { { mtime, 0 }, { mtime, 0 } };
+	succeed_if (utimensat (AT_FDCWD, directory, times, 0) == 0, "could not set modification time of directory");
+}
+
+// like the kdb core: the storage phase only follows a resolver phase with updates
+static int getAll (Plugin * plugin, KeySet * ks, Key * parentKey)
+{
+	int ret = plugin->kdbGet (plugin, ks, parentKey);
+	if (ret != ELEKTRA_PLUGIN_STATUS_SUCCESS) return ret;
+	return plugin->kdbGet (plugin, ks, parentKey);
+}
+
+static void test_update (void)
+{
+	printf ("test update\n");
+
+	char directory[] = "/tmp/elektra-test-multifile-XXXXXX";
+	exit_if_fail (mkdtemp (directory) != NULL, "could not create directory");
+	writeFile (directory, "a.ini", "key=a1\n", 1000);
+	writeFile (directory, "b.ini", "key=b1\n", 1000);
+	setDirectoryTime (directory, 1000);
+
+	Key * parentKey = keyNew (PARENT_KEY, KEY_END);
+	KeySet * conf = ksNew (4, keyNew ("system:/path", KEY_VALUE, directory, KEY_END),
+			       keyNew ("system:/pattern", KEY_VALUE, "*.ini", KEY_END), keyNew ("system:/storage", KEY_VALUE, "mini", KEY_END),
+			       keyNew ("system:/resolver", KEY_VALUE, "resolver", KEY_END), KS_END);
+	PLUGIN_OPEN ("multifile");
+
+	KeySet * ks = ksNew (0, KS_END);
+	succeed_if (getAll (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "first kdbGet was not successful");
+	succeed_if_same_string (keyString (ksLookupByName (ks, PARENT_KEY "/a.ini/key", 0)), "a1");
+	succeed_if_same_string (keyString (ksLookupByName (ks, PARENT_KEY "/b.ini/key", 0)), "b1");
+
+	succeed_if (getAll (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_NO_UPDATE, "unchanged files should not need an update");
+
+	// only the changed file is parsed again, the other one keeps its keys
+	writeFile (directory, "a.ini", "key=a2\n", 2000);
+	setDirectoryTime (directory, 1000);
+	succeed_if (getAll (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "changed file should be read");
+	succeed_if_same_string (keyString (ksLookupByName (ks, PARENT_KEY "/a.ini/key", 0)), "a2");
+	succeed_if_same_string (keyString (ksLookupByName (ks, PARENT_KEY "/b.ini/key", 0)), "b1");
+
+	// the directory is only globbed again if its modification time changed
+	writeFile (directory, "c.ini", "key=c1\n", 1000);
+	setDirectoryTime (directory, 1000);
+	succeed_if (getAll (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_NO_UPDATE, "directory should not be globbed again");
+	succeed_if (ksLookupByName (ks, PARENT_KEY "/c.ini/key", 0) == NULL, "file found without globbing");
+
+	setDirectoryTime (directory, 2000);
+	succeed_if (getAll (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "new file should be read");
+	succeed_if_same_string (keyString (ksLookupByName (ks, PARENT_KEY "/c.ini/key", 0)), "c1");
+	succeed_if_same_string (keyString (ksLookupByName (ks, PARENT_KEY "/b.ini/key", 0)), "b1");
+
+	char path[1024];
+	snprintf (path, sizeof (path), "%s/b.ini", directory);
+	unlink (path);
+	setDirectoryTime (directory, 3000);
+	succeed_if (getAll (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "removed file should be noticed");
+	succeed_if (ksLookupByName (ks, PARENT_KEY "/b.ini/key", 0) == NULL, "keys of removed file still there");
+	succeed_if_same_string (keyString (ksLookupByName (ks, PARENT_KEY "/a.ini/key", 0)), "a2");
+	succeed_if_same_string (keyString (ksLookupByName (ks, PARENT_KEY "/c.ini/key", 0)), "c1");
+
+	ksDel (ks);
+	keyDel (parentKey);
+	PLUGIN_CLOSE ();
+
+	snprintf (path, sizeof (path), "%s/a.ini", directory);
+	unlink (path);
+	snprintf (path, sizeof (path), "%s/c.ini", directory);
+	unlink (path);
+	rmdir (directory);
+}
+
+int main (int argc, char ** argv)
+{
+	printf ("MULTIFILE     TESTS\n");
+	printf ("==================\n\n");
+
+	init (argc, argv);
+
+	test_update ();
+
+	print_result ("testmod_multifile");
+
+	return nbError;
+}
@@ -14,6 +14,7 @@
 
 #include <kdbease.h>
 #include <kdberrors.h>
+#include <kdbprivate.h>
 
 #include <errno.h>
 #include <string.h>
@@ -71,10 +72,11 @@ static void keyMetaToNi (elektraNi_node add, Key * cur)
 {
 	elektraNi_SetValue (add, keyString (cur), keyGetValueSize (cur) - 1);
 
-	const Key * m;
-	keyRewindMeta (cur);
-	while ((m = keyNextMeta (cur)) != 0)
+	// keyRewindMeta() would copy shared metadata
+	KeySet * meta = elektraKeyGetMetaKeySet (cur);
+	for (elektraCursor it = 0; it < ksGetSize (meta); ++it)
 	{
+		const Key * m = ksAtCursor (meta, it);
 		// printf("set meta %s %s from %s\n", keyName(m), keyString(m), keyName(cur));
 		elektraNi_node madd = elektraNi_GetChild (add, keyName (m), keyGetNameSize (m) - 1, 1, 0);
 		elektraNi_SetValue (madd, keyString (m), keyGetValueSize (m) - 1);
@@ -11,9 +11,17 @@
 
 #include <kdbendian.h>
 #include <kdbhelper.h>
+#include <kdbutility.h>
 
 #include <kdberrors.h>
+#include <kdbprivate.h>
+
+#include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #define MAGIC_NUMBER_BASE (0x454b444200000000UL) // EKDB (in ASCII) + Version placeholder
 
@@ -26,6 +34,7 @@ struct metaLink
 	const void * meta;
 	size_t keyNameSize;
 	const char * keyName;
+	Key * key;
 };
 
 struct list
@@ -42,12 +51,53 @@ struct stringbuffer
 	char * string;
 };
 
+/**
+ * Where each key is stored in a file written or read by this plugin.
+ *
+ * kdbSet() uses it to copy the keys that did not change from the old file,
+ * instead of serializing every key again.
+ */
+struct positions
+{
+	char * parentName;
+	char * fileName;
+
+	// identity of the file, to detect changes by others
+	dev_t device;
+	ino_t inode;
+	off_t fileSize;
+	time_t mtime;
+	bool checkTime; ///< false after kdbSet(), the resolver updates the time stamp on commit
+
+	bool complete; ///< false if reading or writing the file failed
+	bool sorted;   ///< false if the keys in the file are not in the order of a KeySet
+
+	Key ** keys;	  ///< the key of every entry, with incremented reference counter
+	off_t * offsets;  ///< offsets[i] is the start of keys[i], offsets[size] the end of the last key
+	KeySet * sources; ///< keys referenced by copy meta entries
+	size_t size;
+	size_t alloc;
+};
+
+struct quickdumpData
+{
+	struct positions ** files;
+	size_t size;
+};
+
 static ssize_t findMetaLink (struct list * list, const Key * meta);
 static void insertMetaLink (struct list * list, size_t index, const Key * meta, Key * key, size_t parentOffset);
 
 static void setupBuffer (struct stringbuffer * buffer, size_t initialAlloc);
 static void ensureBufferSize (struct stringbuffer * buffer, size_t minSize);
 
+static struct positions * newPositions (Key * parentKey, const char * fileName);
+static bool addPosition (struct positions * positions, Key * key, off_t offset);
+static void finishPositions (struct positions * positions, FILE * file, off_t end, bool checkTime);
+static bool storePositions (Plugin * handle, Key * parentKey, struct positions * positions);
+static struct positions * findPositions (Plugin * handle, Key * parentKey);
+static void freePositions (struct positions * positions);
+
 // keep #ifdef in sync with kdb export
 #ifdef _WIN32
 #define STDOUT_FILENAME ("CON")
@@ -57,7 +107,7 @@ static void ensureBufferSize (struct stringbuffer * buffer, size_t minSize);
 
 #include "varint.c"
 
-static inline bool writeData (FILE * file, const char * data, kdb_unsigned_long_long_t size, Key * errorKey)
+static inline bool writeData (FILE * file, const char * data, kdb_unsigned_long_long_t size, off_t * offset, Key * errorKey)
 {
 	if (!varintWrite (file, size))
 	{
@@ -73,10 +123,11 @@ static inline bool writeData (FILE * file, const char * data, kdb_unsigned_long_
 			return false;
 		}
 	}
+	*offset += varintSize (size) + size;
 	return true;
 }
 
-static inline bool readStringIntoBuffer (FILE * file, struct stringbuffer * buffer, Key * errorKey)
+static inline bool readStringIntoBuffer (FILE * file, struct stringbuffer * buffer, off_t * offset, Key * errorKey)
 {
 	kdb_unsigned_long_long_t size = 0;
 	if (!varintRead (file, &size))
@@ -94,10 +145,11 @@ static inline bool readStringIntoBuffer (FILE * file, struct stringbuffer * buff
 		return false;
 	}
 	buffer->string[newSize - 1] = '\0';
+	*offset += varintSize (size) + size;
 	return true;
 }
 
-int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
+int elektraQuickdumpGet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
 	if (!elektraStrCmp (keyName (parentKey), "system:/elektra/modules/quickdump"))
 	{
@@ -106,6 +158,7 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 			keyNew ("system:/elektra/modules/quickdump/exports", KEY_END),
 			keyNew ("system:/elektra/modules/quickdump/exports/get", KEY_FUNC, elektraQuickdumpGet, KEY_END),
 			keyNew ("system:/elektra/modules/quickdump/exports/set", KEY_FUNC, elektraQuickdumpSet, KEY_END),
+			keyNew ("system:/elektra/modules/quickdump/exports/close", KEY_FUNC, elektraQuickdumpClose, KEY_END),
 #include ELEKTRA_README
 			keyNew ("system:/elektra/modules/quickdump/infos/version", KEY_VALUE, PLUGINVERSION, KEY_END), KS_END);
 		ksAppend (returned, contract);
@@ -156,6 +209,19 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 		return ELEKTRA_PLUGIN_STATUS_ERROR;
 	}
 
+	// remember where the keys are, so that kdbSet() can copy unchanged keys
+	struct positions * positions = NULL;
+	struct stat fileStat;
+	if (ksLookupByName (elektraPluginGetConfig (handle), "/noparent", 0) == NULL && fstat (fileno (file), &fileStat) == 0 &&
+	    S_ISREG (fileStat.st_mode))
+	{
+		positions = newPositions (parentKey, keyString (parentKey));
+		if (positions != NULL && !storePositions (handle, parentKey, positions))
+		{
+			positions = NULL;
+		}
+	}
+
 	// setup buffers
 	struct stringbuffer valueBuffer;
 	setupBuffer (&valueBuffer, 4);
@@ -174,13 +240,17 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 	nameBuffer.string[parentSize] = '\0';	 // set new null terminator
 	nameBuffer.offset = parentSize;		 // set offset to null terminator
 
+	// ftello() would need a system call for every key
+	off_t offset = sizeof (kdb_unsigned_long_long_t);
+
 	int fc;
 	while ((fc = fgetc (file)) != EOF)
 	{
 		char c = fc;
 		ungetc (c, file);
+		off_t keyStart = offset;
 
-		if (!readStringIntoBuffer (file, &nameBuffer, parentKey))
+		if (!readStringIntoBuffer (file, &nameBuffer, &offset, parentKey))
 		{
 			elektraFree (nameBuffer.string);
 			elektraFree (metaNameBuffer.string);
@@ -202,6 +272,7 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 
 		char type = ftype;
 		Key * k;
+		++offset;
 
 		switch (type)
 		{
@@ -217,6 +288,7 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 				fclose (file);
 				return ELEKTRA_PLUGIN_STATUS_ERROR;
 			}
+			offset += varintSize (valueSize) + valueSize;
 
 			if (valueSize == 0)
 			{
@@ -240,7 +312,7 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 		}
 		case 's': {
 			// string key value
-			if (!readStringIntoBuffer (file, &valueBuffer, parentKey))
+			if (!readStringIntoBuffer (file, &valueBuffer, &offset, parentKey))
 			{
 				elektraFree (nameBuffer.string);
 				elektraFree (metaNameBuffer.string);
@@ -270,12 +342,13 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 				return ELEKTRA_PLUGIN_STATUS_ERROR;
 			}
 			c = fc;
+			++offset;
 
 			switch (c)
 			{
 			case 'm': {
 				// meta key
-				if (!readStringIntoBuffer (file, &metaNameBuffer, parentKey))
+				if (!readStringIntoBuffer (file, &metaNameBuffer, &offset, parentKey))
 				{
 					keyDel (k);
 					elektraFree (nameBuffer.string);
@@ -285,7 +358,7 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 					return ELEKTRA_PLUGIN_STATUS_ERROR;
 				}
 
-				if (!readStringIntoBuffer (file, &valueBuffer, parentKey))
+				if (!readStringIntoBuffer (file, &valueBuffer, &offset, parentKey))
 				{
 					keyDel (k);
 					elektraFree (nameBuffer.string);
@@ -301,7 +374,7 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 			}
 			case 'c': {
 				// copy meta
-				if (!readStringIntoBuffer (file, &nameBuffer, parentKey))
+				if (!readStringIntoBuffer (file, &nameBuffer, &offset, parentKey))
 				{
 					keyDel (k);
 					elektraFree (nameBuffer.string);
@@ -311,7 +384,7 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 					return ELEKTRA_PLUGIN_STATUS_ERROR;
 				}
 
-				if (!readStringIntoBuffer (file, &metaNameBuffer, parentKey))
+				if (!readStringIntoBuffer (file, &metaNameBuffer, &offset, parentKey))
 				{
 					keyDel (k);
 					elektraFree (nameBuffer.string);
@@ -321,7 +394,7 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 					return ELEKTRA_PLUGIN_STATUS_ERROR;
 				}
 
-				const Key * sourceKey = ksLookupByName (returned, nameBuffer.string, 0);
+				Key * sourceKey = ksLookupByName (returned, nameBuffer.string, 0);
 				if (sourceKey == NULL)
 				{
 					ELEKTRA_SET_RESOURCE_ERRORF (parentKey, "Could not copy meta data from key '%s': Key not found",
@@ -334,6 +407,11 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 					return ELEKTRA_PLUGIN_STATUS_ERROR;
 				}
 
+				if (positions != NULL)
+				{
+					ksAppendKey (positions->sources, sourceKey);
+				}
+
 				if (keyCopyMeta (k, sourceKey, metaNameBuffer.string) != 1)
 				{
 					ELEKTRA_SET_INTERNAL_ERRORF (parentKey, "Could not copy meta data from key '%s': Error during copy",
@@ -358,188 +436,304 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 			}
 		}
 
+		++offset;
+
+		if (positions != NULL && !addPosition (positions, k, keyStart))
+		{
+			storePositions (handle, parentKey, NULL);
+			positions = NULL;
+		}
+
 		ksAppendKey (returned, k);
+
+		if (positions != NULL && ksAtCursor (returned, ksGetSize (returned) - 1) != k)
+		{
+			// kdbSet() expects the keys in the file in the order of a KeySet
+			positions->sorted = false;
+		}
 	}
 
 	elektraFree (nameBuffer.string);
 	elektraFree (metaNameBuffer.string);
 	elektraFree (valueBuffer.string);
 
+	if (positions != NULL)
+	{
+		finishPositions (positions, file, offset, true);
+	}
+
 	fclose (file);
 
 	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
 }
 
-int elektraQuickdumpSet (Plugin * handle, KeySet * returned, Key * parentKey)
+static bool writeKey (FILE * file, Key * cur, size_t parentOffset, struct list * metaKeys, KeySet * sources, off_t * offset,
+		      Key * parentKey)
 {
-	elektraCursor cursor = ksGetCursor (returned);
-	ksRewind (returned);
-
-	FILE * file;
-
-	// cannot open stdout for writing, because its already open
-	if (elektraStrCmp (keyString (parentKey), STDOUT_FILENAME) == 0)
-	{
-		file = stdout;
-	}
-	else
+	size_t fullNameSize = keyGetNameSize (cur);
+	if (fullNameSize < parentOffset)
 	{
-		file = fopen (keyString (parentKey), "wb");
+		return false;
 	}
 
-	if (file == NULL)
+	kdb_unsigned_long_long_t nameSize = fullNameSize == parentOffset ? 0 : fullNameSize - 1 - parentOffset;
+	if (!writeData (file, keyName (cur) + parentOffset, nameSize, offset, parentKey))
 	{
-		ELEKTRA_SET_ERROR_SET (parentKey);
-		return ELEKTRA_PLUGIN_STATUS_ERROR;
+		return false;
 	}
 
-	// magic number is written big endian so EKDB magic string is readable
-	kdb_unsigned_long_long_t magic = htobe64 (MAGIC_NUMBER_V3);
-	if (fwrite (&magic, sizeof (kdb_unsigned_long_long_t), 1, file) < 1)
+	if (keyIsBinary (cur))
 	{
-		fclose (file);
-		return ELEKTRA_PLUGIN_STATUS_ERROR;
-	}
+		if (fputc ('b', file) == EOF)
+		{
+			return false;
+		}
+		++*offset;
 
-	struct list metaKeys;
-	metaKeys.alloc = 16;
-	metaKeys.size = 0;
-	metaKeys.array = elektraMalloc (metaKeys.alloc * sizeof (struct metaLink *));
+		kdb_unsigned_long_long_t valueSize = keyGetValueSize (cur);
 
-	// we assume all keys in returned are below parentKey
-	size_t parentOffset = keyGetNameSize (parentKey);
+		char * value = NULL;
+		if (valueSize > 0)
+		{
+			value = elektraMalloc (valueSize);
+			if (keyGetBinary (cur, value, valueSize) == -1)
+			{
+				elektraFree (value);
+				return false;
+			}
+		}
 
-	// ... unless /noparent is in config, then we just take the full
-	// (cascading) keynames as relative to the parentKey
-	KeySet * config = elektraPluginGetConfig (handle);
-	if (ksLookupByName (config, "/noparent", 0) != NULL)
-	{
-		parentOffset = 1;
+		if (!writeData (file, value, valueSize, offset, parentKey))
+		{
+			elektraFree (value);
+			return false;
+		}
+		elektraFree (value);
 	}
-
-	Key * cur;
-	while ((cur = ksNext (returned)) != NULL)
+	else
 	{
-		size_t fullNameSize = keyGetNameSize (cur);
-		if (fullNameSize < parentOffset)
+		if (fputc ('s', file) == EOF)
 		{
-			fclose (file);
-			return ELEKTRA_PLUGIN_STATUS_ERROR;
+			return false;
 		}
+		++*offset;
 
-		kdb_unsigned_long_long_t nameSize = fullNameSize == parentOffset ? 0 : fullNameSize - 1 - parentOffset;
-		if (!writeData (file, keyName (cur) + parentOffset, nameSize, parentKey))
+		kdb_unsigned_long_long_t valueSize = keyGetValueSize (cur) - 1;
+		if (!writeData (file, keyString (cur), valueSize, offset, parentKey))
 		{
-			fclose (file);
-			return ELEKTRA_PLUGIN_STATUS_ERROR;
+			return false;
 		}
+	}
 
-		if (keyIsBinary (cur))
+	// iterating via keyRewindMeta() or keyMeta() would copy shared metadata
+	KeySet * metaKs = elektraKeyGetMetaKeySet (cur);
+	for (elektraCursor metaCursor = 0; metaCursor < ksGetSize (metaKs); ++metaCursor)
+	{
+		const Key * meta = ksAtCursor (metaKs, metaCursor);
+		ssize_t result = findMetaLink (metaKeys, meta);
+		if (result < 0)
 		{
-			if (fputc ('b', file) == EOF)
+			if (fputc ('m', file) == EOF)
 			{
-				fclose (file);
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
+				return false;
 			}
+			++*offset;
 
-			kdb_unsigned_long_long_t valueSize = keyGetValueSize (cur);
-
-			char * value = NULL;
-			if (valueSize > 0)
+			// ignore meta namespace when writing to file
+			kdb_unsigned_long_long_t metaNameSize = keyGetNameSize (meta) - 1 - (sizeof ("meta:/") - 1);
+			if (!writeData (file, keyName (meta) + sizeof ("meta:/") - 1, metaNameSize, offset, parentKey))
 			{
-				value = elektraMalloc (valueSize);
-				if (keyGetBinary (cur, value, valueSize) == -1)
-				{
-					fclose (file);
-					elektraFree (value);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
-				}
+				return false;
 			}
 
-			if (!writeData (file, value, valueSize, parentKey))
+			kdb_unsigned_long_long_t metaValueSize = keyGetValueSize (meta) - 1;
+			if (!writeData (file, keyString (meta), metaValueSize, offset, parentKey))
 			{
-				fclose (file);
-				elektraFree (value);
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
+				return false;
 			}
-			elektraFree (value);
+
+			insertMetaLink (metaKeys, -result - 1, meta, cur, parentOffset);
 		}
 		else
 		{
-			if (fputc ('s', file) == EOF)
+			if (fputc ('c', file) == EOF)
 			{
-				fclose (file);
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
+				return false;
 			}
+			++*offset;
 
-			kdb_unsigned_long_long_t valueSize = keyGetValueSize (cur) - 1;
-			if (!writeData (file, keyString (cur), valueSize, parentKey))
+			kdb_unsigned_long_long_t keyNameSize = metaKeys->array[result]->keyNameSize;
+			if (!writeData (file, metaKeys->array[result]->keyName, keyNameSize, offset, parentKey))
 			{
-				fclose (file);
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
+				return false;
+			}
+
+			// ignore meta namespace when writing to file
+			kdb_unsigned_long_long_t metaNameSize = keyGetNameSize (meta) - 1 - (sizeof ("meta:/") - 1);
+			if (!writeData (file, keyName (meta) + sizeof ("meta:/") - 1, metaNameSize, offset, parentKey))
+			{
+				return false;
+			}
+
+			if (sources != NULL)
+			{
+				ksAppendKey (sources, metaKeys->array[result]->key);
 			}
 		}
+	}
 
-		keyRewindMeta (cur);
-		const Key * meta;
-		while ((meta = keyNextMeta (cur)) != NULL)
+	if (fputc (0, file) == EOF)
+	{
+		return false;
+	}
+	++*offset;
+	return true;
+}
+
+/**
+ * @brief Opens the file read by the last kdbGet() or written by the last kdbSet()
+ *
+ * @retval -1 if the keys cannot be copied from the old file, because it was
+ *         changed, it would be overwritten or because of copy meta entries
+ *         referring to a changed key
+ * @return the file descriptor of the old file otherwise
+ */
+static int openOldFile (struct positions * old, KeySet * returned, const char * fileName)
+{
+	if (old == NULL || !old->complete || !old->sorted)
+	{
+		return -1;
+	}
+
+	for (elektraCursor it = 0; it < ksGetSize (old->sources); ++it)
+	{
+		Key * source = ksAtCursor (old->sources, it);
+		if (keyNeedSync (source) || ksLookup (returned, source, 0) != source)
 		{
-			ssize_t result = findMetaLink (&metaKeys, meta);
-			if (result < 0)
-			{
-				if (fputc ('m', file) == EOF)
-				{
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
-				}
+			return -1;
+		}
+	}
 
-				// ignore meta namespace when writing to file
-				kdb_unsigned_long_long_t metaNameSize = keyGetNameSize (meta) - 1 - (sizeof ("meta:/") - 1);
-				if (!writeData (file, keyName (meta) + sizeof ("meta:/") - 1, metaNameSize, parentKey))
-				{
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
-				}
+	int fd = open (old->fileName, O_RDONLY);
+	if (fd == -1)
+	{
+		return -1;
+	}
 
-				kdb_unsigned_long_long_t metaValueSize = keyGetValueSize (meta) - 1;
-				if (!writeData (file, keyString (meta), metaValueSize, parentKey))
-				{
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
-				}
+	struct stat oldStat;
+	struct stat newStat;
+	if (fstat (fd, &oldStat) == -1 || oldStat.st_dev != old->device || oldStat.st_ino != old->inode ||
+	    oldStat.st_size != old->fileSize || (old->checkTime && oldStat.st_mtime != old->mtime) ||
+	    (stat (fileName, &newStat) == 0 && newStat.st_dev == oldStat.st_dev && newStat.st_ino == oldStat.st_ino))
+	{
+		close (fd);
+		return -1;
+	}
 
-				insertMetaLink (&metaKeys, -result - 1, meta, cur, parentOffset);
-			}
-			else
-			{
-				if (fputc ('c', file) == EOF)
-				{
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
-				}
+	return fd;
+}
 
-				kdb_unsigned_long_long_t keyNameSize = metaKeys.array[result]->keyNameSize;
-				if (!writeData (file, metaKeys.array[result]->keyName, keyNameSize, parentKey))
-				{
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
-				}
+/**
+ * @brief Copies the range of unchanged keys collected by writeKeys()
+ */
+static bool copyKeys (FILE * file, int oldFile, off_t * start, off_t end, off_t * offset, Key * parentKey)
+{
+	if (*start == end)
+	{
+		return true;
+	}
 
-				// ignore meta namespace when writing to file
-				kdb_unsigned_long_long_t metaNameSize = keyGetNameSize (meta) - 1 - (sizeof ("meta:/") - 1);
-				if (!writeData (file, keyName (meta) + sizeof ("meta:/") - 1, metaNameSize, parentKey))
-				{
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
-				}
+	if (fflush (file) != 0 || elektraCopyFileRange (oldFile, *start, fileno (file), *offset, end - *start) == -1 ||
+	    fseeko (file, *offset + end - *start, SEEK_SET) != 0)
+	{
+		ELEKTRA_SET_RESOURCE_ERRORF (parentKey, "Could not copy unchanged keys into '%s'. Reason: %s", keyString (parentKey),
+					     strerror (errno));
+		return false;
+	}
+
+	*offset += end - *start;
+	*start = end;
+	return true;
+}
+
+/**
+ * @brief Writes all keys of @p returned to @p file
+ *
+ * If @p old is given, the keys that did not change since they were read
+ * from or written to the old file are copied from there. The file is only
+ * the same as the one written without @p old, if no metadata is shared.
+ * Otherwise the new keys might contain `m` entries, where a full write uses
+ * `c` entries.
+ *
+ * @param old the positions of the keys in @p oldFile, or NULL
+ * @param positions if not NULL, the positions of the written keys are added
+ */
+static bool writeKeys (FILE * file, KeySet * returned, size_t parentOffset, struct positions * old, int oldFile,
+		       struct positions * positions, Key * parentKey)
+{
+	struct list metaKeys;
+	metaKeys.alloc = 16;
+	metaKeys.size = 0;
+	metaKeys.array = elektraMalloc (metaKeys.alloc * sizeof (struct metaLink *));
+
+	// ftello() would need a system call for every key
+	off_t offset = sizeof (kdb_unsigned_long_long_t);
+
+	// the range of unchanged keys not yet copied from the old file
+	off_t copyStart = 0;
+	off_t copyEnd = 0;
+
+	bool success = true;
+	size_t oldSize = old == NULL ? 0 : old->size;
+	size_t oldIndex = 0;
+	elektraCursor it = 0;
+	while (success && (it < ksGetSize (returned) || oldIndex < oldSize))
+	{
+		Key * cur = ksAtCursor (returned, it);
+		Key * oldKey = oldIndex < oldSize ? old->keys[oldIndex] : NULL;
+
+		if (cur != NULL && cur == oldKey && !keyNeedSync (cur))
+		{
+			if (copyStart == copyEnd || copyEnd != old->offsets[oldIndex])
+			{
+				success = copyKeys (file, oldFile, &copyStart, copyEnd, &offset, parentKey);
+				copyStart = copyEnd = old->offsets[oldIndex];
+			}
+			if (positions != NULL && !addPosition (positions, cur, offset + copyEnd - copyStart))
+			{
+				// the caller drops incomplete positions, so the next kdbSet() rewrites the whole file
+				positions = NULL;
 			}
+			copyEnd = old->offsets[oldIndex + 1];
+			++oldIndex;
+			++it;
+			continue;
 		}
 
-		if (fputc (0, file) == EOF)
+		int cmp = oldKey == NULL ? 1 : cur == NULL ? -1 : keyCmp (oldKey, cur);
+		if (cmp <= 0)
 		{
-			fclose (file);
-			return ELEKTRA_PLUGIN_STATUS_ERROR;
+			// the old key was removed, changed or replaced
+			++oldIndex;
+		}
+		if (cmp < 0)
+		{
+			continue;
+		}
+
+		success = copyKeys (file, oldFile, &copyStart, copyEnd, &offset, parentKey);
+		if (success && positions != NULL && !addPosition (positions, cur, offset))
+		{
+			positions = NULL;
 		}
+		success = success &&
+			  writeKey (file, cur, parentOffset, &metaKeys, positions == NULL ? NULL : positions->sources, &offset, parentKey);
+		++it;
+	}
+	success = success && copyKeys (file, oldFile, &copyStart, copyEnd, &offset, parentKey);
+	if (success && positions != NULL && fflush (file) == 0)
+	{
+		finishPositions (positions, file, offset, false);
 	}
 
 	for (size_t i = 0; i < metaKeys.size; ++i)
@@ -548,10 +742,109 @@ int elektraQuickdumpSet (Plugin * handle, KeySet * returned, Key * parentKey)
 	}
 	elektraFree (metaKeys.array);
 
+	return success;
+}
+
+int elektraQuickdumpSet (Plugin * handle, KeySet * returned, Key * parentKey)
+{
+	FILE * file;
+	struct positions * old = NULL;
+	int oldFile = -1;
+
+	// we assume all keys in returned are below parentKey
+	size_t parentOffset = keyGetNameSize (parentKey);
+
+	// ... unless /noparent is in config, then we just take the full
+	// (cascading) keynames as relative to the parentKey
+	KeySet * config = elektraPluginGetConfig (handle);
+	bool noParent = ksLookupByName (config, "/noparent", 0) != NULL;
+	if (noParent)
+	{
+		parentOffset = 1;
+	}
+
+	// cannot open stdout for writing, because its already open
+	if (elektraStrCmp (keyString (parentKey), STDOUT_FILENAME) == 0)
+	{
+		file = stdout;
+	}
+	else
+	{
+		old = findPositions (handle, parentKey);
+		oldFile = openOldFile (old, returned, keyString (parentKey));
+		file = fopen (keyString (parentKey), "wb");
+	}
+
+	if (file == NULL)
+	{
+		if (oldFile != -1) close (oldFile);
+		ELEKTRA_SET_ERROR_SET (parentKey);
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+
+	// magic number is written big endian so EKDB magic string is readable
+	kdb_unsigned_long_long_t magic = htobe64 (MAGIC_NUMBER_V3);
+	if (fwrite (&magic, sizeof (kdb_unsigned_long_long_t), 1, file) < 1)
+	{
+		if (oldFile != -1) close (oldFile);
+		fclose (file);
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+
+	struct positions * positions = NULL;
+	if (file != stdout && !noParent)
+	{
+		// the resolver renames the file we write to the file we read
+		positions = newPositions (parentKey, old == NULL ? keyString (parentKey) : old->fileName);
+		if (positions != NULL && oldFile != -1)
+		{
+			ksAppend (positions->sources, old->sources);
+		}
+	}
+
+	bool success = writeKeys (file, returned, parentOffset, oldFile == -1 ? NULL : old, oldFile, positions, parentKey);
+
+	if (oldFile != -1)
+	{
+		close (oldFile);
+	}
+
+	if (positions != NULL)
+	{
+		if (success && positions->complete)
+		{
+			storePositions (handle, parentKey, positions);
+		}
+		else
+		{
+			freePositions (positions);
+			storePositions (handle, parentKey, NULL);
+		}
+	}
+	else if (old != NULL)
+	{
+		// the old positions describe the file we just replaced
+		storePositions (handle, parentKey, NULL);
+	}
+
 	fclose (file);
 
-	ksSetCursor (returned, cursor);
+	return success ? ELEKTRA_PLUGIN_STATUS_SUCCESS : ELEKTRA_PLUGIN_STATUS_ERROR;
+}
 
+int elektraQuickdumpClose (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
+{
+	struct quickdumpData * data = elektraPluginGetData (handle);
+	if (data != NULL)
+	{
+		for (size_t i = 0; i < data->size; ++i)
+		{
+			freePositions (data->files[i]);
+		}
+		elektraFree (data->files);
+		elektraFree (data);
+		elektraPluginSetData (handle, NULL);
+	}
 	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
 }
 
@@ -610,6 +903,7 @@ void insertMetaLink (struct list * list, size_t index, const Key * meta, Key * k
 	size_t fullNameSize = keyGetNameSize (key);
 	link->keyNameSize = fullNameSize <= parentOffset ? 0 : fullNameSize - 1 - parentOffset;
 	link->keyName = keyName (key) + parentOffset;
+	link->key = key;
 
 	if (index < list->size)
 	{
@@ -642,12 +936,160 @@ void ensureBufferSize (struct stringbuffer * buffer, size_t minSize)
 	}
 }
 
+struct positions * newPositions (Key * parentKey, const char * fileName)
+{
+	struct positions * positions = elektraCalloc (sizeof (struct positions));
+	if (positions == NULL)
+	{
+		return NULL;
+	}
+	positions->parentName = elektraStrDup (keyName (parentKey));
+	positions->fileName = elektraStrDup (fileName);
+	positions->sorted = true;
+	positions->alloc = 16;
+	positions->keys = elektraMalloc (positions->alloc * sizeof (Key *));
+	positions->offsets = elektraMalloc ((positions->alloc + 1) * sizeof (off_t));
+	positions->sources = ksNew (0, KS_END);
+	if (positions->parentName == NULL || positions->fileName == NULL || positions->keys == NULL || positions->offsets == NULL ||
+	    positions->sources == NULL)
+	{
+		freePositions (positions);
+		return NULL;
+	}
+	return positions;
+}
+
+bool addPosition (struct positions * positions, Key * key, off_t offset)
+{
+	if (keyIncRef (key) == UINT16_MAX)
+	{
+		return false;
+	}
+
+	if (positions->size == positions->alloc)
+	{
+		size_t alloc = positions->alloc * 2;
+		if (elektraRealloc ((void **) &positions->keys, alloc * sizeof (Key *)) == -1 ||
+		    elektraRealloc ((void **) &positions->offsets, (alloc + 1) * sizeof (off_t)) == -1)
+		{
+			keyDecRef (key);
+			return false;
+		}
+		positions->alloc = alloc;
+	}
+
+	positions->keys[positions->size] = key;
+	positions->offsets[positions->size] = offset;
+	++positions->size;
+	return true;
+}
+
+/**
+ * @brief Marks the positions as complete, if the file has the expected size
+ *
+ * @param end the end of the last key
+ * @param checkTime if the modification time is known for sure
+ */
+void finishPositions (struct positions * positions, FILE * file, off_t end, bool checkTime)
+{
+	struct stat fileStat;
+	if (ftello (file) != end || fstat (fileno (file), &fileStat) == -1)
+	{
+		return;
+	}
+
+	positions->offsets[positions->size] = end;
+	positions->device = fileStat.st_dev;
+	positions->inode = fileStat.st_ino;
+	positions->fileSize = fileStat.st_size;
+	positions->mtime = fileStat.st_mtime;
+	positions->checkTime = checkTime;
+	positions->complete = true;
+}
+
+/**
+ * @brief Replaces the positions stored for @p parentKey
+ *
+ * @param positions the new positions, or NULL to only remove the old ones
+ *
+ * @retval true if @p positions were stored
+ * @retval false on memory allocation errors, @p positions are freed then
+ */
+bool storePositions (Plugin * handle, Key * parentKey, struct positions * positions)
+{
+	struct quickdumpData * data = elektraPluginGetData (handle);
+	if (data == NULL)
+	{
+		if (positions == NULL)
+		{
+			return true;
+		}
+		data = elektraCalloc (sizeof (struct quickdumpData));
+		if (data == NULL)
+		{
+			freePositions (positions);
+			return false;
+		}
+		elektraPluginSetData (handle, data);
+	}
+
+	for (size_t i = 0; i < data->size; ++i)
+	{
+		if (strcmp (data->files[i]->parentName, keyName (parentKey)) == 0)
+		{
+			freePositions (data->files[i]);
+			data->files[i] = positions != NULL ? positions : data->files[--data->size];
+			return true;
+		}
+	}
+
+	if (positions != NULL)
+	{
+		if (elektraRealloc ((void **) &data->files, (data->size + 1) * sizeof (struct positions *)) == -1)
+		{
+			freePositions (positions);
+			return false;
+		}
+		data->files[data->size++] = positions;
+	}
+	return true;
+}
+
+struct positions * findPositions (Plugin * handle, Key * parentKey)
+{
+	struct quickdumpData * data = elektraPluginGetData (handle);
+	for (size_t i = 0; data != NULL && i < data->size; ++i)
+	{
+		if (strcmp (data->files[i]->parentName, keyName (parentKey)) == 0)
+		{
+			return data->files[i];
+		}
+	}
+	return NULL;
+}
+
+void freePositions (struct positions * positions)
+{
+	for (size_t i = 0; i < positions->size; ++i)
+	{
+		keyDecRef (positions->keys[i]);
+		keyDel (positions->keys[i]);
+	}
+	ksDel (positions->sources);
+	elektraFree (positions->keys);
+	elektraFree (positions->offsets);
+	elektraFree (positions->fileName);
+	elektraFree (positions->parentName);
+	elektraFree (positions);
+}
+
 Plugin * ELEKTRA_PLUGIN_EXPORT
 {
 	// clang-format off
 	return elektraPluginExport ("quickdump",
 				    ELEKTRA_PLUGIN_GET,	&elektraQuickdumpGet,
 				    ELEKTRA_PLUGIN_SET,	&elektraQuickdumpSet,
+				    ELEKTRA_PLUGIN_CLOSE,	&elektraQuickdumpClose,
 				    ELEKTRA_PLUGIN_END);
 	// clang-format on
 }
@@ -216,6 +216,127 @@ static void test_parentKeyValue (void)
 	ksDel (expected);
 }
 
+static void writeFull (KeySet * ks, const char * fileName)
+{
+	Key * setKey = keyNew ("dir:/tests/bench", KEY_VALUE, fileName, KEY_END);
+
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("quickdump");
+
+	succeed_if (plugin->kdbSet (plugin, ks, setKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+
+	keyDel (setKey);
+	PLUGIN_CLOSE ();
+}
+
+static void checkFile (KeySet * expected, const char * fileName)
+{
+	Key * getKey = keyNew ("dir:/tests/bench", KEY_VALUE, fileName, KEY_END);
+
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("quickdump");
+
+	KeySet * actual = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGet (plugin, actual, getKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+	compare_keyset (expected, actual);
+
+	ksDel (actual);
+	keyDel (getKey);
+	PLUGIN_CLOSE ();
+}
+
+static void test_incremental (void)
+{
+	printf ("test incremental write\n");
+
+	char oldFile[1024];
+	char newFile[1024];
+	char fullFile[1024];
+	snprintf (oldFile, sizeof (oldFile), "%s.old", elektraFilename ());
+	snprintf (newFile, sizeof (newFile), "%s.new", elektraFilename ());
+	snprintf (fullFile, sizeof (fullFile), "%s.full", elektraFilename ());
+
+	KeySet * ks = ksNew (0, KS_END);
+	for (char c = 'a'; c <= 'z'; ++c)
+	{
+		char name[] = { 'd', 'i', 'r', ':', '/', 't', 'e', 's', 't', 's', '/', 'b', 'e', 'n', 'c', 'h', '/', c, '\0' };
+		ksAppendKey (ks, keyNew (name, KEY_VALUE, name, KEY_META, "meta", name, KEY_END));
+	}
+	ksAppendKey (ks, keyNew ("dir:/tests/bench/binary", KEY_BINARY, KEY_SIZE, 4, KEY_VALUE, "\0\1\2\3", KEY_END));
+	Key * shared = keyNew ("dir:/tests/bench/shared", KEY_VALUE, "shared", KEY_END);
+	keyCopyMeta (shared, ksLookupByName (ks, "dir:/tests/bench/a", 0), "meta");
+	ksAppendKey (ks, shared);
+	writeFull (ks, oldFile);
+	ksDel (ks);
+
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("quickdump");
+
+	Key * parentKey = keyNew ("dir:/tests/bench", KEY_VALUE, oldFile, KEY_END);
+	ks = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+	clear_sync (ks);
+
+	keySetString (ksLookupByName (ks, "dir:/tests/bench/b", 0), "changed");
+	keySetMeta (ksLookupByName (ks, "dir:/tests/bench/z", 0), "meta", "changed");
+	ksAppendKey (ks, keyNew ("dir:/tests/bench/bb", KEY_VALUE, "added", KEY_END));
+	keyDel (ksLookupByName (ks, "dir:/tests/bench/c", KDB_O_POP));
+
+	keySetString (parentKey, newFile);
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+	writeFull (ks, fullFile);
+	succeed_if (compare_binary_files (newFile, fullFile) == 0, "incremental write differs from full write");
+
+	// like the resolver, replace the old file
+	rename (newFile, oldFile);
+	clear_sync (ks);
+
+	// the copied key 'a' cannot be referenced by 'shared', so its metadata is written again
+	keySetString (ksLookupByName (ks, "dir:/tests/bench/shared", 0), "changed");
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+	writeFull (ks, fullFile);
+	succeed_if (compare_binary_files (newFile, fullFile) != 0, "unchanged keys were not copied");
+	checkFile (ks, newFile);
+
+	rename (newFile, oldFile);
+	clear_sync (ks);
+
+	// 'shared' refers to 'a', so the whole file must be written
+	keySetString (ksLookupByName (ks, "dir:/tests/bench/a", 0), "changed");
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+	writeFull (ks, fullFile);
+	succeed_if (compare_binary_files (newFile, fullFile) == 0, "changed source of copied metadata was not written");
+
+	rename (newFile, oldFile);
+	clear_sync (ks);
+
+	// changes by others must not be overwritten with the old content
+	remove (oldFile);
+	KeySet * other = ksNew (1, keyNew ("dir:/tests/bench/other", KEY_VALUE, "other", KEY_END), KS_END);
+	writeFull (other, oldFile);
+	ksDel (other);
+	keySetString (ksLookupByName (ks, "dir:/tests/bench/d", 0), "changed");
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+	writeFull (ks, fullFile);
+	succeed_if (compare_binary_files (newFile, fullFile) == 0, "external change was not detected");
+
+	// the file to copy from cannot be written in place
+	rename (newFile, oldFile);
+	clear_sync (ks);
+	keySetString (parentKey, oldFile);
+	keySetString (ksLookupByName (ks, "dir:/tests/bench/e", 0), "changed");
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+	checkFile (ks, oldFile);
+
+	keyDel (parentKey);
+	ksDel (ks);
+	PLUGIN_CLOSE ();
+
+	remove (oldFile);
+	remove (newFile);
+	remove (fullFile);
+}
+
 #include "varint.c"
 
 static void test_varint (void)
@@ -278,6 +399,7 @@ int main (int argc, char ** argv)
 	test_basics ();
 	test_noParent ();
 	test_parentKeyValue ();
+	test_incremental ();
 
 	print_result ("testmod_quickdump");
 
@@ -64,16 +64,21 @@ static bool varintRead (FILE * file, kdb_unsigned_long_long_t * result)
 	return true;
 }
 
+static unsigned int varintSize (kdb_unsigned_long_long_t num)
+{
+	unsigned int len = 64 - __builtin_clzll (num | 1u);
+	len = 1 + (len - 1) / 7;
+	return len > 8 ? 9 : len;
+}
+
 static bool varintWrite (FILE * file, kdb_unsigned_long_long_t num)
 {
 	kdb_octet_t varint[9];
 
-	unsigned int len = 64 - __builtin_clzll (num | 1u);
-	len = 1 + (len - 1) / 7;
+	unsigned int len = varintSize (num);
 
-	if (len > 8)
+	if (len == 9)
 	{
-		len = 9;
 		varint[0] = 0;
 	}
 	else
@@ -206,7 +206,24 @@ static Key * renameGet (Key * key, Key * parentKey, Key * cutConfig, Key * repla
 	return elektraKeyCreateNewName (key, parentKey, cutPath, replaceWith, toUpperPath, toLowerPath, initialConversion);
 }
 
-static Key * restoreKeyName (Key * key, const Key * parentKey, const Key * configKey)
+typedef struct
+{
+	Key * parentKey;
+	Key * cutConfig;
+	Key * replaceWith;
+	Key * toUpper;
+	Key * toLower;
+	Key * getCase;
+	int writeConversion;
+} RenameConfig;
+
+/**
+ * Restores the original name of @p key in-place.
+ *
+ * @retval 1 if the name of @p key was changed
+ * @retval 0 otherwise
+ */
+static int restoreKeyName (Key * key, const Key * parentKey, const Key * configKey)
 {
 	const Key * origNameKey = keyGetMeta (key, ELEKTRA_ORIGINAL_NAME_META);
 	if (origNameKey)
@@ -214,15 +231,14 @@ static Key * restoreKeyName (Key * key, const Key * parentKey, const Key * confi
 		if (strcmp (keyString (origNameKey), keyName (key)))
 		{
 			int hasSync = keyNeedSync (key); // test_bit(key->flags, KEY_FLAG_SYNC);
-			Key * result = keyDup (key, KEY_CP_ALL);
-			keySetName (result, keyString (origNameKey));
-			keySetMeta (result, ELEKTRA_ORIGINAL_NAME_META, 0);
+			keySetName (key, keyString (origNameKey));
+			keySetMeta (key, ELEKTRA_ORIGINAL_NAME_META, 0);
 
 			if (!hasSync)
 			{
-				keyClearSync (result);
+				keyClearSync (key);
 			}
-			return result;
+			return 1;
 		}
 	}
 	else
@@ -230,8 +246,7 @@ static Key * restoreKeyName (Key * key, const Key * parentKey, const Key * confi
 		if (configKey)
 		{
 			int hasSync = keyNeedSync (key); // test_bit(key->flags, KEY_FLAG_SYNC);
-			Key * result = keyDup (key, KEY_CP_ALL);
-			keySetName (result, keyName (parentKey));
+			Key * result = keyNew (keyName (parentKey), KEY_END);
 			keyAddName (result, keyString (configKey));
 
 			if (keyGetNameSize (key) > keyGetNameSize (parentKey))
@@ -240,18 +255,57 @@ static Key * restoreKeyName (Key * key, const Key * parentKey, const Key * confi
 				const char * relativePath = keyName (key) + keyGetNameSize (parentKey);
 				keyAddName (result, relativePath);
 			}
+			keySetName (key, keyName (result));
+			keyDel (result);
 
 			if (!hasSync)
 			{
-				keyClearSync (result);
+				keyClearSync (key);
 			}
-			return result;
+			return 1;
 		}
 	}
 
 	return 0;
 }
 
+static int renameGetKey (Key * key, void * data)
+{
+	RenameConfig * config = data;
+	Key * renamedKey =
+		renameGet (key, config->parentKey, config->cutConfig, config->replaceWith, config->toUpper, config->toLower, config->getCase);
+
+	keySetMeta (key, ELEKTRA_ORIGINAL_NAME_META, keyName (key));
+	if (!renamedKey)
+	{
+		return 0;
+	}
+
+	keySetName (key, keyName (renamedKey));
+	keyDel (renamedKey);
+	return 1;
+}
+
+static int renameSetKey (Key * key, void * data)
+{
+	RenameConfig * config = data;
+	int renamed = restoreKeyName (key, config->parentKey, config->cutConfig);
+
+	if (config->writeConversion == TOUPPER || config->writeConversion == TOLOWER)
+	{
+		char * curKeyName = elektraStrDup (keyName (key));
+		char * afterParentString = curKeyName + keyGetNameSize (config->parentKey) - 1;
+
+		doConversion (afterParentString, 0, config->writeConversion);
+
+		keySetName (key, curKeyName);
+		elektraFree (curKeyName);
+		renamed = 1;
+	}
+
+	return renamed;
+}
+
 int elektraRenameGet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
 	/* configuration only */
@@ -267,55 +321,22 @@ int elektraRenameGet (Plugin * handle, KeySet * returned, Key * parentKey)
 
 
 	KeySet * config = elektraPluginGetConfig (handle);
-	KeySet * iterateKs = ksDup (returned);
-
-	ksRewind (iterateKs);
-
-	Key * cutConfig = ksLookupByName (config, "/cut", KDB_O_NONE);
-	Key * toUpper = ksLookupByName (config, "/toupper", KDB_O_NONE);
-	Key * toLower = ksLookupByName (config, "/tolower", KDB_O_NONE);
-	Key * replaceWith = ksLookupByName (config, "/replacewith", KDB_O_NONE);
-	Key * getCase = ksLookupByName (config, "/get/case", KDB_O_NONE);
 
-
-	Key * key;
-	while ((key = ksNext (iterateKs)) != 0)
-	{
-
-		Key * renamedKey = renameGet (key, parentKey, cutConfig, replaceWith, toUpper, toLower, getCase);
-
-		if (renamedKey)
-		{
-			keySetMeta (renamedKey, ELEKTRA_ORIGINAL_NAME_META, keyName (key));
-			ksLookup (returned, key, KDB_O_POP);
-			keyDel (key);
-
-			/*
-			 * if the parentKey is replaced by a rename operation
-			 * make sure that we do not loose its reference (ksAppendKey
-			 * would otherwise delete it)
-			 */
-			if (keyCmp (renamedKey, parentKey) == 0)
-			{
-				/* make sure the parent key is not deleted */
-				keyIncRef (parentKey);
-				ksAppendKey (returned, renamedKey);
-				keyDecRef (parentKey);
-			}
-			else
-			{
-				ksAppendKey (returned, renamedKey);
-			}
-		}
-		else
-		{
-			keySetMeta (key, ELEKTRA_ORIGINAL_NAME_META, keyName (key));
-		}
-	}
-
-	/* make sure the parent key is not deleted */
+	RenameConfig renameConfig = {
+		.parentKey = parentKey,
+		.cutConfig = ksLookupByName (config, "/cut", KDB_O_NONE),
+		.toUpper = ksLookupByName (config, "/toupper", KDB_O_NONE),
+		.toLower = ksLookupByName (config, "/tolower", KDB_O_NONE),
+		.replaceWith = ksLookupByName (config, "/replacewith", KDB_O_NONE),
+		.getCase = ksLookupByName (config, "/get/case", KDB_O_NONE),
+	};
+
+	/*
+	 * the additional reference makes sure that the parentKey is
+	 * neither renamed nor deleted, if it is part of returned
+	 */
 	keyIncRef (parentKey);
-	ksDel (iterateKs);
+	ksRenameEach (returned, 0, ksGetSize (returned), renameGetKey, &renameConfig);
 	keyDecRef (parentKey);
 
 	return 1; /* success */
@@ -323,9 +344,6 @@ int elektraRenameGet (Plugin * handle, KeySet * returned, Key * parentKey)
 
 int elektraRenameSet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
-
-	KeySet * iterateKs = ksDup (returned);
-
 	KeySet * config = elektraPluginGetConfig (handle);
 	Key * cutConfig = ksLookupByName (config, "/cut", KDB_O_NONE);
 
@@ -352,41 +370,38 @@ int elektraRenameSet (Plugin * handle, KeySet * returned, Key * parentKey)
 			writeConversion = UNCHNGD;
 		}
 	}
-	ksRewind (iterateKs);
-	Key * key;
-	char * parentKeyName = elektraMalloc (keyGetNameSize (parentKey));
-	keyGetName (parentKey, parentKeyName, keyGetNameSize (parentKey));
-	while ((key = ksNext (iterateKs)) != 0)
-	{
-		Key * renamedKey = NULL;
-		if (writeConversion != KEYNAME)
-		{
-			renamedKey = restoreKeyName (key, parentKey, cutConfig);
 
-			if (!renamedKey) renamedKey = keyDup (key, KEY_CP_ALL);
-			if (writeConversion == TOUPPER || writeConversion == TOLOWER)
-			{
-				char * curKeyName = elektraMalloc (keyGetNameSize (renamedKey));
-				keyGetName (renamedKey, curKeyName, keyGetNameSize (renamedKey));
+	keyIncRef (parentKey);
+	if (writeConversion != KEYNAME)
+	{
+		RenameConfig renameConfig = {
+			.parentKey = parentKey,
+			.cutConfig = cutConfig,
+			.writeConversion = writeConversion,
+		};
 
-				char * afterParentString = curKeyName + (strlen (parentKeyName));
+		Key * parentNamedKey = ksLookup (returned, parentKey, KDB_O_POP);
 
-				doConversion (afterParentString, 0, writeConversion);
+		ksRenameEach (returned, 0, ksGetSize (returned), renameSetKey, &renameConfig);
 
-				keySetName (renamedKey, curKeyName);
-				elektraFree (curKeyName);
-			}
-			/*
-			 * if something is restored from the parentKey, do
-			 * not delete the parentKey (might cause troubles)
-			 */
-			if (keyCmp (key, parentKey) != 0)
-			{
-				keyDel (ksLookup (returned, key, KDB_O_POP));
-			}
+		/*
+		 * if something is restored from the parentKey, do
+		 * not delete the parentKey (might cause troubles)
+		 */
+		if (parentNamedKey)
+		{
+			Key * renamedKey = keyDup (parentNamedKey, KEY_CP_ALL);
+			renameSetKey (renamedKey, &renameConfig);
+			ksAppendKey (returned, parentNamedKey);
 			ksAppendKey (returned, renamedKey);
 		}
-		else
+	}
+	else
+	{
+		KeySet * iterateKs = ksDup (returned);
+		ksRewind (iterateKs);
+		Key * key;
+		while ((key = ksNext (iterateKs)) != 0)
 		{
 			if (keyCmp (key, parentKey) != 0)
 			{
@@ -394,14 +409,11 @@ int elektraRenameSet (Plugin * handle, KeySet * returned, Key * parentKey)
 			}
 			ksAppendKey (returned, key);
 		}
+		ksDel (iterateKs);
 	}
-
-	keyIncRef (parentKey);
-	ksDel (iterateKs);
 	keyDecRef (parentKey);
 
 	ksRewind (returned);
-	elektraFree (parentKeyName);
 	return 1; /* success */
 }
 
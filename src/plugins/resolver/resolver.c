@@ -72,6 +72,9 @@ static void resolverInit (resolverHandle * p, const char * path)
 
 	p->uid = 0;
 	p->gid = 0;
+
+	p->wd = -1;
+	p->changed = 0;
 }
 
 static resolverHandle * elektraGetResolverHandle (Plugin * handle, Key * parentKey)
@@ -446,6 +449,7 @@ int ELEKTRA_PLUGIN_FUNCTION (open) (Plugin * handle, Key * errorKey)
 	resolverInit (&p->dir, path);
 	resolverInit (&p->user, path);
 	resolverInit (&p->system, path);
+	p->watch = NULL;
 
 #if defined(ELEKTRA_RESOLVER_RECURSIVE_MUTEX_INITIALIZATION)
 	// PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP is available in glibc only
@@ -506,6 +510,7 @@ int ELEKTRA_PLUGIN_FUNCTION (close) (Plugin * handle, Key * errorKey ELEKTRA_UNU
 
 	if (ps)
 	{
+		ELEKTRA_PLUGIN_FUNCTION (watchClose) (ps);
 		resolverClose (ps);
 		elektraPluginSetData (handle, 0);
 	}
@@ -532,6 +537,12 @@ int ELEKTRA_PLUGIN_FUNCTION (get) (Plugin * handle, KeySet * returned, Key * par
 	resolverHandle * pk = elektraGetResolverHandle (handle, parentKey);
 	keySetString (parentKey, pk->filename);
 
+	if (ELEKTRA_PLUGIN_FUNCTION (watchUnchanged) (handle, pk, parentKey))
+	{
+		// no inotify event, so storage has no job
+		return 0;
+	}
+
 	int errnoSave = errno;
 	struct stat buf;
 
@@ -23,6 +23,7 @@
 #define ERROR_SIZE 1024
 
 typedef struct _resolverHandle resolverHandle;
+typedef struct _resolverWatch resolverWatch;
 
 struct _resolverHandle
 {
@@ -44,6 +45,9 @@ struct _resolverHandle
 
 	gid_t gid;
 	uid_t uid;
+
+	int wd;			  ///< inotify watch of dirname, -1 if not watched
+	unsigned int changed : 1; ///< an inotify event for the file arrived since the last stat()
 };
 
 typedef struct _resolverHandles resolverHandles;
@@ -54,10 +58,14 @@ struct _resolverHandles
 	resolverHandle dir;
 	resolverHandle user;
 	resolverHandle system;
+
+	resolverWatch * watch; ///< inotify watches of the KDB handle, NULL if not enabled
 };
 
 void ELEKTRA_PLUGIN_FUNCTION (freeHandle) (ElektraResolved *);
 int ELEKTRA_PLUGIN_FUNCTION (checkFile) (const char * filename);
+int ELEKTRA_PLUGIN_FUNCTION (watchUnchanged) (Plugin * handle, resolverHandle * pk, Key * parentKey);
+void ELEKTRA_PLUGIN_FUNCTION (watchClose) (resolverHandles * pks);
 ElektraResolved * ELEKTRA_PLUGIN_FUNCTION (filename) (elektraNamespace, const char *, ElektraResolveTempfile, Key *);
 
 int ELEKTRA_PLUGIN_FUNCTION (open) (Plugin * handle, Key * errorKey);
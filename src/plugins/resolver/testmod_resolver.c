@@ -298,6 +298,56 @@ void test_checkfile (void)
 	ksDel (modules);
 }
 
+#ifdef HAVE_SYS_INOTIFY_H
+static void writeFile (const char * filename, const char * content)
+{
+	FILE * f = fopen (filename, "w");
+	exit_if_fail (f, "could not write file");
+	fputs (content, f);
+	fclose (f);
+}
+
+static void test_watch (void)
+{
+	printf ("Watch file\n");
+
+	char filename[1024];
+	snprintf (filename, sizeof (filename), "%s/watch.ecf", tempHome);
+	writeFile (filename, "first");
+
+	KeySet * modules = ksNew (0, KS_END);
+	elektraModulesInit (modules, 0);
+	Plugin * plugin = elektraPluginOpen ("resolver", modules, ksNew (5, keyNew ("system:/path", KEY_VALUE, filename, KEY_END), KS_END), 0);
+	exit_if_fail (plugin, "could not load resolver plugin");
+
+	KeySet * global = ksNew (5, keyNew ("system:/elektra/resolver/inotify", KEY_VALUE, "1", KEY_END), KS_END);
+	plugin->global = global;
+
+	Key * parentKey = keyNew ("system:/tests/watch", KEY_END);
+	succeed_if (plugin->kdbGet (plugin, 0, parentKey) == 1, "first get should need an update");
+	succeed_if (ksLookupByName (global, "system:/elektra/resolver/inotify/handle", 0) != 0, "watch handle should be shared");
+	succeed_if (plugin->kdbGet (plugin, 0, parentKey) == 0, "unchanged file should not need an update");
+	succeed_if (plugin->kdbGet (plugin, 0, parentKey) == 0, "unchanged file should not need an update");
+
+	writeFile (filename, "second");
+	succeed_if (plugin->kdbGet (plugin, 0, parentKey) == 1, "changed file should need an update");
+	succeed_if (plugin->kdbGet (plugin, 0, parentKey) == 0, "unchanged file should not need an update");
+
+	unlink (filename);
+	succeed_if (plugin->kdbGet (plugin, 0, parentKey) == 0, "missing file should not need an update");
+	writeFile (filename, "third");
+	succeed_if (plugin->kdbGet (plugin, 0, parentKey) == 1, "recreated file should need an update");
+
+	keyDel (parentKey);
+	elektraPluginClose (plugin, 0);
+	succeed_if (ksLookupByName (global, "system:/elektra/resolver/inotify/handle", 0) == 0, "watch handle should be released");
+	ksDel (global);
+	elektraModulesClose (modules, 0);
+	ksDel (modules);
+	unlink (filename);
+}
+#endif
+
 static void check_xdg (void)
 {
 	KeySet * modules = ksNew (0, KS_END);
@@ -338,6 +388,9 @@ int main (int argc, char ** argv)
 	test_name ();
 	test_lockname ();
 	test_tempname ();
+#ifdef HAVE_SYS_INOTIFY_H
+	test_watch ();
+#endif
 
 
 	print_result ("testmod_resolver");
@@ -0,0 +1,313 @@
+/**
+ * @file
+ *
+ * @brief Change detection of the resolved files with inotify
+ *
+ * If enabled for a KDB handle (see elektraIoWatchContract()), all resolver
+ * instances of the handle share one inotify descriptor.
+ * Every resolved file is watched by watching its directory, because files
+ * are replaced by rename() on commit.
+ * As long as no event arrived for a file, kdbGet() does not need to stat() it.
+ *
+ * With an I/O binding, the inotify descriptor is added to the event loop and
+ * external changes are reported to the notification callback.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include "resolver.h"
+
+#include <kdbconfig.h>
+
+#ifdef HAVE_SYS_INOTIFY_H
+
+#include <kdbhelper.h>
+#include <kdbio.h>
+#include <kdblogger.h>
+#include <kdbmacros.h>
+#include <kdbnotificationinternal.h>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/inotify.h>
+
+#define WATCH_ENABLE_KEY "system:/elektra/resolver/inotify"
+#define WATCH_HANDLE_KEY "system:/elektra/resolver/inotify/handle"
+
+#define WATCH_MASK                                                                                                                         \
+	(IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR)
+
+typedef struct
+{
+	resolverHandle * pk;
+	const char * basename; ///< points into pk->filename
+	char * keyName;	       ///< mountpoint to notify about external changes
+} WatchEntry;
+
+struct _resolverWatch
+{
+	int fd;
+	size_t refs;
+
+	WatchEntry * entries;
+	size_t size;
+	size_t alloc;
+
+	ElektraIoFdOperation * fdOp; ///< NULL without I/O binding
+	KeySet * global;
+};
+
+static resolverWatch * watchAcquire (KeySet * global)
+{
+	if (!global || !ksLookupByName (global, WATCH_ENABLE_KEY, 0)) return NULL;
+
+	Key * handleKey = ksLookupByName (global, WATCH_HANDLE_KEY, 0);
+	if (handleKey)
+	{
+		resolverWatch * watch = *(resolverWatch **) keyValue (handleKey);
+		++watch->refs;
+		return watch;
+	}
+
+	int fd = inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+	if (fd == -1)
+	{
+		ELEKTRA_LOG_WARNING ("inotify_init1 failed: %s", strerror (errno));
+		return NULL;
+	}
+
+	resolverWatch * watch = elektraCalloc (sizeof (resolverWatch));
+	watch->fd = fd;
+	watch->refs = 1;
+	watch->global = global;
+	ksAppendKey (global, keyNew (WATCH_HANDLE_KEY, KEY_BINARY, KEY_SIZE, sizeof (watch), KEY_VALUE, &watch, KEY_END));
+	return watch;
+}
+
+static int watchUsesDescriptor (resolverWatch * watch, int wd)
+{
+	for (size_t i = 0; i < watch->size; ++i)
+	{
+		if (watch->entries[i].pk->wd == wd) return 1;
+	}
+	return 0;
+}
+
+static void watchRemoveEntry (resolverWatch * watch, size_t i)
+{
+	elektraFree (watch->entries[i].keyName);
+	watch->entries[i] = watch->entries[--watch->size];
+}
+
+static void watchRemove (resolverWatch * watch, resolverHandle * pk)
+{
+	for (size_t i = 0; i < watch->size; ++i)
+	{
+		if (watch->entries[i].pk == pk)
+		{
+			watchRemoveEntry (watch, i);
+			break;
+		}
+	}
+	if (pk->wd != -1 && !watchUsesDescriptor (watch, pk->wd))
+	{
+		inotify_rm_watch (watch->fd, pk->wd);
+	}
+	pk->wd = -1;
+}
+
+static void watchAdd (resolverWatch * watch, resolverHandle * pk, Key * parentKey)
+{
+	if (!pk->filename || !pk->dirname) return;
+
+	int wd = inotify_add_watch (watch->fd, pk->dirname, WATCH_MASK);
+	if (wd == -1)
+	{
+		// e.g. the directory does not exist yet, try again on the next kdbGet()
+		ELEKTRA_LOG_DEBUG ("could not watch %s: %s", pk->dirname, strerror (errno));
+		return;
+	}
+
+	if (watch->size == watch->alloc)
+	{
+		size_t alloc = watch->alloc ? watch->alloc * 2 : 4;
+		if (elektraRealloc ((void **) &watch->entries, alloc * sizeof (WatchEntry)) == -1)
+		{
+			// without a watch, changes are detected by the usual stat() in kdbGet()
+			if (!watchUsesDescriptor (watch, wd)) inotify_rm_watch (watch->fd, wd);
+			return;
+		}
+		watch->alloc = alloc;
+	}
+	const char * basename = strrchr (pk->filename, '/');
+	WatchEntry * entry = &watch->entries[watch->size++];
+	entry->pk = pk;
+	entry->basename = basename ? basename + 1 : pk->filename;
+	entry->keyName = elektraStrDup (keyName (parentKey));
+	pk->wd = wd;
+}
+
+/**
+ * @retval 1 if the file differs from the last kdbGet() or kdbSet() of this handle
+ * @retval 0 otherwise, e.g. for our own commits
+ */
+static int watchExternal (resolverHandle * pk)
+{
+	struct stat buf;
+	if (stat (pk->filename, &buf) == -1) return !pk->isMissing;
+	return pk->isMissing || pk->mtime.tv_sec != ELEKTRA_STAT_SECONDS (buf) || pk->mtime.tv_nsec != ELEKTRA_STAT_NANO_SECONDS (buf);
+}
+
+/**
+ * @brief Reads all pending events and flags the changed files
+ *
+ * @param changed if not NULL, the mountpoints of externally changed files are added
+ */
+static void watchRead (resolverWatch * watch, KeySet * changed)
+{
+	char buffer[4096] __attribute__ ((aligned (__alignof__ (struct inotify_event))));
+	ssize_t length;
+	while ((length = read (watch->fd, buffer, sizeof (buffer))) > 0)
+	{
+		char * ptr = buffer;
+		while (ptr < buffer + length)
+		{
+			const struct inotify_event * event = (const struct inotify_event *) ptr;
+			ptr += sizeof (struct inotify_event) + event->len;
+			int all = event->mask & IN_Q_OVERFLOW;
+			int gone = event->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF);
+			for (size_t i = 0; i < watch->size; ++i)
+			{
+				WatchEntry * entry = &watch->entries[i];
+				if (!all && entry->pk->wd != event->wd) continue;
+				if (!all && !gone && (!event->len || strcmp (entry->basename, event->name))) continue;
+				entry->pk->changed = 1;
+				if (changed && watchExternal (entry->pk)) ksAppendKey (changed, keyNew (entry->keyName, KEY_END));
+			}
+			if (event->mask & IN_MOVE_SELF)
+			{
+				// the watch would follow the directory, IN_IGNORED follows
+				inotify_rm_watch (watch->fd, event->wd);
+			}
+			else if (event->mask & IN_IGNORED)
+			{
+				// the watch is gone, the next kdbGet() adds it again
+				for (size_t i = 0; i < watch->size;)
+				{
+					if (watch->entries[i].pk->wd == event->wd)
+					{
+						watch->entries[i].pk->wd = -1;
+						watchRemoveEntry (watch, i);
+					}
+					else
+					{
+						++i;
+					}
+				}
+			}
+		}
+	}
+}
+
+static void watchNotify (ElektraIoFdOperation * fdOp, int flags ELEKTRA_UNUSED)
+{
+	resolverWatch * watch = elektraIoFdGetData (fdOp);
+	KeySet * changed = ksNew (0, KS_END);
+	watchRead (watch, changed);
+
+	Key * callbackKey = ksLookupByName (watch->global, "system:/elektra/notification/callback", 0);
+	Key * contextKey = ksLookupByName (watch->global, "system:/elektra/notification/context", 0);
+	if (callbackKey && keyValue (callbackKey) && contextKey && keyValue (contextKey))
+	{
+		ElektraNotificationCallback callback = *(ElektraNotificationCallback *) keyValue (callbackKey);
+		ElektraNotificationCallbackContext * context = *(ElektraNotificationCallbackContext **) keyValue (contextKey);
+		for (elektraCursor it = 0; it < ksGetSize (changed); ++it)
+		{
+			// the callback takes ownership of the key
+			callback (keyDup (ksAtCursor (changed, it), KEY_CP_NAME), context);
+		}
+	}
+	ksDel (changed);
+}
+
+static void watchAttach (resolverWatch * watch)
+{
+	if (watch->fdOp) return;
+
+	Key * ioBindingKey = ksLookupByName (watch->global, "system:/elektra/io/binding", 0);
+	const void * bindingPtr = keyValue (ioBindingKey);
+	ElektraIoInterface * binding = bindingPtr == NULL ? NULL : *(ElektraIoInterface **) bindingPtr;
+	if (!binding) return;
+
+	watch->fdOp = elektraIoNewFdOperation (watch->fd, ELEKTRA_IO_READABLE, 1, watchNotify, watch);
+	if (!elektraIoBindingAddFd (binding, watch->fdOp))
+	{
+		ELEKTRA_LOG_WARNING ("could not add inotify descriptor to I/O binding");
+		elektraFree (watch->fdOp);
+		watch->fdOp = NULL;
+	}
+}
+
+/**
+ * @brief Checks if the file of @p pk is known to be unchanged
+ *
+ * Must be called by kdbGet() before the file gets stat()ed.
+ *
+ * @retval 1 if no event arrived for the file since the last call
+ * @retval 0 if the file needs to be stat()ed
+ */
+int ELEKTRA_PLUGIN_FUNCTION (watchUnchanged) (Plugin * handle, resolverHandle * pk, Key * parentKey)
+{
+	resolverHandles * pks = elektraPluginGetData (handle);
+	if (!pks->watch)
+	{
+		pks->watch = watchAcquire (elektraPluginGetGlobalKeySet (handle));
+		if (!pks->watch) return 0;
+	}
+	resolverWatch * watch = pks->watch;
+	watchAttach (watch);
+	watchRead (watch, NULL);
+
+	if (pk->wd != -1 && !pk->changed) return 1;
+
+	// watch before the stat(), so that no change gets lost
+	pk->changed = 0;
+	if (pk->wd == -1) watchAdd (watch, pk, parentKey);
+	return 0;
+}
+
+void ELEKTRA_PLUGIN_FUNCTION (watchClose) (resolverHandles * pks)
+{
+	resolverWatch * watch = pks->watch;
+	if (!watch) return;
+	watchRemove (watch, &pks->spec);
+	watchRemove (watch, &pks->dir);
+	watchRemove (watch, &pks->user);
+	watchRemove (watch, &pks->system);
+	pks->watch = NULL;
+	if (--watch->refs > 0) return;
+
+	if (watch->fdOp)
+	{
+		elektraIoBindingRemoveFd (watch->fdOp);
+		elektraFree (watch->fdOp);
+	}
+	close (watch->fd);
+	keyDel (ksLookupByName (watch->global, WATCH_HANDLE_KEY, KDB_O_POP));
+	elektraFree (watch->entries);
+	elektraFree (watch);
+}
+
+#else
+
+int ELEKTRA_PLUGIN_FUNCTION (watchUnchanged) (Plugin * handle ELEKTRA_UNUSED, resolverHandle * pk ELEKTRA_UNUSED,
+					      Key * parentKey ELEKTRA_UNUSED)
+{
+	return 0;
+}
+
+void ELEKTRA_PLUGIN_FUNCTION (watchClose) (resolverHandles * pks ELEKTRA_UNUSED)
+{
+}
+
+#endif
@@ -16,6 +16,7 @@
 #include <kdbhelper.h>
 #include <kdblogger.h>
 #include <kdbmeta.h>
+#include <kdbprivate.h>
 #include <kdbtypes.h>
 
 #ifndef __MINGW32__
@@ -759,7 +760,9 @@ static void validateWildcardSubs (KeySet * ks, Key * key)
  */
 static void copyMeta (Key * dest, Key * src)
 {
-	KeySet * metaKS = ksDup (keyMeta (src));
+	// keyMeta() would copy the metadata of src, if it is shared
+	KeySet * metaKS = ksDup (elektraKeyGetMetaKeySet (src));
+	if (metaKS == NULL) return;
 
 	Key * cutpoint = keyNew ("meta:/internal", KEY_END);
 	ksDel (ksCut (metaKS, cutpoint)); // don't care for internal stuff
@@ -829,6 +832,7 @@ static int processSpecKey (Key * specKey, Key * parentKey, KeySet * ks, const Co
 	}
 
 	int found = 0;
+	Key * metaTemplate = NULL;
 	for (elektraCursor cursor = 0; cursor < ksGetSize (ks); ++cursor)
 	{
 		Key * cur = ksAtCursor (ks, cursor);
@@ -844,8 +848,22 @@ static int processSpecKey (Key * specKey, Key * parentKey, KeySet * ks, const Co
 			validateWildcardSubs (ks, cur);
 		}
 
-		copyMeta (cur, specKey);
+		if (ksGetSize (elektraKeyGetMetaKeySet (cur)) <= 0)
+		{
+			// nothing can collide, so all keys without metadata of their own share the same metadata
+			if (metaTemplate == NULL)
+			{
+				metaTemplate = keyNew ("/", KEY_END);
+				copyMeta (metaTemplate, specKey);
+			}
+			keyCopyAllMeta (cur, metaTemplate);
+		}
+		else
+		{
+			copyMeta (cur, specKey);
+		}
 	}
+	keyDel (metaTemplate);
 
 
 	int ret = 0;
@@ -14,7 +14,9 @@
 
 #include <kdbease.h>
 #include <kdbinvoke.h>
+#include <kdbmacros.h>
 #include <kdbmodule.h>
+#include <kdbprivate.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -44,8 +46,10 @@ static struct change allowedChanges[] = { { "meta:/description", true, true, tru
 					  { "meta:/example", true, true, true },     { NULL, false, false, false } };
 
 static bool readConfig (KeySet * conf, char ** directFilePtr, char ** appPtr, char *** argvPtr, Key * errorKey);
+static bool readCacheConfig (KeySet * conf, char ** cacheDirPtr, Key * errorKey);
 static bool loadSpec (KeySet * returned, const char * directFile, const char * app, char * argv[], Key * parentKey,
 		      ElektraInvokeHandle * quickDump);
+static bool loadSpecCached (Specload * specload, KeySet * returned, Key * parentKey);
 static int isChangeAllowed (Key * oldKey, Key * newKey);
 int keyCompareMeta (const Key * k1, const Key * k2);
 static KeySet * calculateMetaDiff (Key * oldKey, Key * newKey);
@@ -80,7 +84,7 @@ static int copyError (Key * dest, Key * src)
 
 int elektraSpecloadOpen (Plugin * handle, Key * errorKey)
 {
-	Specload * specload = elektraMalloc (sizeof (Specload));
+	Specload * specload = elektraCalloc (sizeof (Specload));
 
 	KeySet * conf = elektraPluginGetConfig (handle);
 	if (ksLookupByName (conf, "system:/module", 0) != NULL || ksLookupByName (conf, "system:/sendspec", 0) != NULL)
@@ -95,6 +99,15 @@ int elektraSpecloadOpen (Plugin * handle, Key * errorKey)
 		return ELEKTRA_PLUGIN_STATUS_ERROR;
 	}
 
+	if (!readCacheConfig (conf, &specload->cacheDir, errorKey))
+	{
+		elektraFree (specload->directFile);
+		elektraFree (specload->app);
+		freeArgv (specload->argv);
+		elektraFree (specload);
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+
 	specload->quickDumpConfig = ksNew (0, KS_END);
 	specload->quickDump = elektraInvokeOpen ("quickdump", specload->quickDumpConfig, errorKey);
 
@@ -131,6 +144,16 @@ int elektraSpecloadClose (Plugin * handle, Key * errorKey)
 
 		freeArgv (specload->argv);
 
+		if (specload->cacheDir != NULL)
+		{
+			elektraFree (specload->cacheDir);
+		}
+
+		if (specload->cachedSpec != NULL)
+		{
+			ksDel (specload->cachedSpec);
+		}
+
 		elektraFree (specload);
 		elektraPluginSetData (handle, NULL);
 	}
@@ -207,7 +230,7 @@ int elektraSpecloadGet (Plugin * handle, KeySet * returned, Key * parentKey)
 
 	KeySet * spec = ksNew (0, KS_END);
 
-	if (!loadSpec (spec, specload->directFile, specload->app, specload->argv, parentKey, specload->quickDump))
+	if (!loadSpecCached (specload, spec, parentKey))
 	{
 		ksDel (spec);
 		ELEKTRA_SET_INSTALLATION_ERROR (
@@ -250,7 +273,7 @@ int elektraSpecloadSet (Plugin * handle, KeySet * returned, Key * parentKey)
 	Specload * specload = elektraPluginGetData (handle);
 
 	KeySet * spec = ksNew (0, KS_END);
-	if (!loadSpec (spec, specload->directFile, specload->app, specload->argv, parentKey, specload->quickDump))
+	if (!loadSpecCached (specload, spec, parentKey))
 	{
 		ksDel (spec);
 		ELEKTRA_SET_INSTALLATION_ERROR (
@@ -342,6 +365,16 @@ int elektraSpecloadCheckConf (Key * errorKey, KeySet * conf)
 		return ELEKTRA_PLUGIN_STATUS_ERROR;
 	}
 
+	char * cacheDir;
+	if (!readCacheConfig (conf, &cacheDir, errorKey))
+	{
+		elektraFree (directFile);
+		elektraFree (app);
+		freeArgv (argv);
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+	elektraFree (cacheDir);
+
 	bool directFileMode = directFile != NULL;
 
 	KeySet * quickDumpConfig = ksNew (0, KS_END);
@@ -460,6 +493,182 @@ bool readConfig (KeySet * conf, char ** directFilePtr, char ** appPtr, char ***
 	return true;
 }
 
+bool readCacheConfig (KeySet * conf, char ** cacheDirPtr, Key * errorKey)
+{
+	*cacheDirPtr = NULL;
+
+	Key * cacheKey = ksLookupByName (conf, "/cache", 0);
+	if (cacheKey == NULL || strlen (keyString (cacheKey)) == 0)
+	{
+		return true;
+	}
+
+	const char * cacheDir = keyString (cacheKey);
+
+	if (cacheDir[0] != '/')
+	{
+		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (errorKey, "The value of the cache config key '%s' is not an absolute path",
+							 cacheDir);
+		return false;
+	}
+
+	*cacheDirPtr = elektraStrDup (cacheDir);
+	return true;
+}
+
+static void readAppIdentity (const struct stat * appStat, SpecloadAppIdentity * identity)
+{
+	identity->dev = appStat->st_dev;
+	identity->ino = appStat->st_ino;
+	identity->size = appStat->st_size;
+	identity->mtimeSec = ELEKTRA_STAT_SECONDS ((*appStat));
+	identity->mtimeNsec = ELEKTRA_STAT_NANO_SECONDS ((*appStat));
+}
+
+static bool isSameAppIdentity (const SpecloadAppIdentity * a, const SpecloadAppIdentity * b)
+{
+	return a->dev == b->dev && a->ino == b->ino && a->size == b->size && a->mtimeSec == b->mtimeSec && a->mtimeNsec == b->mtimeNsec;
+}
+
+/**
+ * Calculates the name of the persistent cache file for the given app.
+ *
+ * The name contains the identity of the executable and a hash of the arguments,
+ * so a changed app (or different arguments) automatically results in a cache miss.
+ *
+ * @return the file name, has to be freed with elektraFree()
+ */
+static char * cacheFileName (const char * cacheDir, const SpecloadAppIdentity * identity, char * argv[])
+{
+	// FNV-1a over all arguments (including the terminating null bytes)
+	unsigned long long hash = 14695981039346656037ULL;
+	for (size_t i = 0; argv[i] != NULL; ++i)
+	{
+		const char * c = argv[i];
+		do
+		{
+			hash ^= (unsigned char) *c;
+			hash *= 1099511628211ULL;
+		} while (*c++ != '\0');
+	}
+
+	return elektraFormat ("%s/specload-%llx-%llx-%llx-%llx.%lx-%llx.eqd", cacheDir, (unsigned long long) identity->dev,
+			      (unsigned long long) identity->ino, (unsigned long long) identity->size,
+			      (unsigned long long) identity->mtimeSec, (unsigned long) identity->mtimeNsec, hash);
+}
+
+static bool readCacheFile (Specload * specload, const char * cacheFile, KeySet * returned, Key * parentKey)
+{
+	if (access (cacheFile, R_OK) != 0)
+	{
+		return false;
+	}
+
+	Key * quickDumpParent = keyNew (keyName (parentKey), KEY_VALUE, cacheFile, KEY_END);
+	int result = elektraInvoke2Args (specload->quickDump, "get", returned, quickDumpParent);
+	keyDel (quickDumpParent);
+
+	if (result != ELEKTRA_PLUGIN_STATUS_SUCCESS)
+	{
+		// broken cache file, fall back to calling the app
+		ksClear (returned);
+		return false;
+	}
+
+	return true;
+}
+
+static void writeCacheFile (Specload * specload, const char * cacheFile, KeySet * spec, Key * parentKey)
+{
+	if (mkdir (specload->cacheDir, KDB_FILE_MODE | KDB_DIR_MODE) != 0 && errno != EEXIST)
+	{
+		ELEKTRA_ADD_RESOURCE_WARNINGF (parentKey, "Could not create cache directory '%s'. Reason: %s", specload->cacheDir,
+					       strerror (errno));
+		return;
+	}
+
+	char * tmpFile = elektraFormat ("%s.%d.tmp", cacheFile, getpid ());
+
+	Key * quickDumpParent = keyNew (keyName (parentKey), KEY_VALUE, tmpFile, KEY_END);
+	int result = elektraInvoke2Args (specload->quickDump, "set", spec, quickDumpParent);
+	keyDel (quickDumpParent);
+
+	// rename is atomic, concurrent readers either see no file or the complete file
+	if (result != ELEKTRA_PLUGIN_STATUS_SUCCESS || rename (tmpFile, cacheFile) != 0)
+	{
+		ELEKTRA_ADD_RESOURCE_WARNINGF (parentKey, "Could not write specification cache file '%s'", cacheFile);
+		unlink (tmpFile);
+	}
+
+	elektraFree (tmpFile);
+}
+
+/**
+ * Loads the base specification, but avoids calling the app, if the specification
+ * for the current version of the app is already known.
+ *
+ * The specification is cached in memory for the lifetime of the plugin and, if the
+ * `cache` config key is set, also persistently in the given directory. A cached
+ * specification is only used, if device, inode, size and mtime of the app are unchanged.
+ */
+bool loadSpecCached (Specload * specload, KeySet * returned, Key * parentKey)
+{
+	if (specload->directFile != NULL)
+	{
+		// no app is called in direct file mode, nothing to cache
+		return loadSpec (returned, specload->directFile, NULL, NULL, parentKey, specload->quickDump);
+	}
+
+	struct stat appStat;
+	if (stat (specload->app, &appStat) != 0)
+	{
+		return loadSpec (returned, NULL, specload->app, specload->argv, parentKey, specload->quickDump);
+	}
+
+	SpecloadAppIdentity identity;
+	readAppIdentity (&appStat, &identity);
+
+	if (specload->cachedSpec != NULL && isSameAppIdentity (&identity, &specload->cachedIdentity))
+	{
+		// deep copy, the caller may modify the returned keys
+		KeySet * spec = ksDeepDup (specload->cachedSpec);
+		ksAppend (returned, spec);
+		ksDel (spec);
+		return true;
+	}
+
+	char * cacheFile = specload->cacheDir != NULL ? cacheFileName (specload->cacheDir, &identity, specload->argv) : NULL;
+
+	KeySet * spec = ksNew (0, KS_END);
+	if (cacheFile == NULL || !readCacheFile (specload, cacheFile, spec, parentKey))
+	{
+		if (!loadSpec (spec, NULL, specload->app, specload->argv, parentKey, specload->quickDump))
+		{
+			elektraFree (cacheFile);
+			ksDel (spec);
+			return false;
+		}
+
+		if (cacheFile != NULL)
+		{
+			writeCacheFile (specload, cacheFile, spec, parentKey);
+		}
+	}
+	elektraFree (cacheFile);
+
+	if (specload->cachedSpec != NULL)
+	{
+		ksDel (specload->cachedSpec);
+	}
+	specload->cachedSpec = ksDeepDup (spec);
+	specload->cachedIdentity = identity;
+
+	ksAppend (returned, spec);
+	ksDel (spec);
+
+	return true;
+}
+
 bool loadSpec (KeySet * returned, const char * directFile, const char * app, char * argv[], Key * parentKey,
 	       ElektraInvokeHandle * quickDump)
 {
@@ -678,31 +887,23 @@ int isChangeAllowed (Key * oldKey, Key * newKey)
  */
 int keyCompareMeta (const Key * k1, const Key * k2)
 {
-	const Key * meta1;
+	// keyRewindMeta() would copy shared metadata
+	KeySet * meta1 = elektraKeyGetMetaKeySet (k1);
+	KeySet * meta2 = elektraKeyGetMetaKeySet (k2);
+	if (meta1 == meta2) return 0;
 
-	Key * key1 = (Key *) k1;
-	Key * key2 = (Key *) k2;
+	ssize_t size = ksGetSize (meta1) < 0 ? 0 : ksGetSize (meta1);
+	if ((ksGetSize (meta2) < 0 ? 0 : ksGetSize (meta2)) != size) return -1;
 
-	keyRewindMeta (key1);
-	keyRewindMeta (key2);
-	while ((meta1 = keyNextMeta (key1)) != 0)
+	for (elektraCursor it = 0; it < size; ++it)
 	{
-		const Key * meta2 = keyNextMeta (key2);
-		if (!meta2)
-		{
-			return -1;
-		}
+		const Key * m1 = ksAtCursor (meta1, it);
+		const Key * m2 = ksAtCursor (meta2, it);
 
-		if (strcmp (keyName (meta1), keyName (meta2))) return -1;
-		if (strcmp (keyString (meta1), keyString (meta2))) return -1;
-	}
-
-	if (keyNextMeta (key2))
-	{
-		return -1;
+		if (strcmp (keyName (m1), keyName (m2))) return -1;
+		if (strcmp (keyString (m1), keyString (m2))) return -1;
 	}
 
-	// TODO: rewind metadata to previous position
 	return 0;
 }
 
@@ -13,13 +13,31 @@
 #include <kdbinvoke.h>
 #include <kdbplugin.h>
 
+#include <sys/stat.h>
+
+/**
+ * Identity of the app executable, used to decide whether a cached
+ * specification is still valid.
+ */
+typedef struct
+{
+	dev_t dev;
+	ino_t ino;
+	off_t size;
+	time_t mtimeSec;
+	long mtimeNsec;
+} SpecloadAppIdentity;
+
 typedef struct
 {
 	char * directFile;
 	char * app;
 	char ** argv;
+	char * cacheDir;
 	KeySet * quickDumpConfig;
 	ElektraInvokeHandle * quickDump;
+	KeySet * cachedSpec;
+	SpecloadAppIdentity cachedIdentity;
 } Specload;
 
 int elektraSpecloadOpen (Plugin * handle, Key * errorKey);
@@ -19,6 +19,7 @@
 
 #include "testdata.h"
 
+#include <dirent.h>
 #include <unistd.h>
 
 static FILE * backupFile (const char * filename)
@@ -291,7 +292,101 @@ static void test_remove (bool directFile)
 	keyDel (parentKey);
 	PLUGIN_CLOSE ();
 }
+static char * findCacheFile (const char * cacheDir)
+{
+	DIR * dir = opendir (cacheDir);
+	if (dir == NULL)
+	{
+		return NULL;
+	}
+
+	char * cacheFile = NULL;
+	struct dirent * entry;
+	while ((entry = readdir (dir)) != NULL)
+	{
+		if (strncmp (entry->d_name, "specload-", sizeof ("specload-") - 1) == 0)
+		{
+			succeed_if (cacheFile == NULL, "more than one cache file");
+			elektraFree (cacheFile);
+			cacheFile = elektraFormat ("%s/%s", cacheDir, entry->d_name);
+		}
+	}
+	closedir (dir);
+
+	return cacheFile;
+}
+
+static void test_cacheReuse (Key * parentKey, const char * cacheDir, KeySet * expected)
+{
+	KeySet * conf = ksNew (2, keyNew ("/app", KEY_VALUE, bindir_file (TESTAPP_NAME), KEY_END),
+			       keyNew ("/cache", KEY_VALUE, cacheDir, KEY_END), KS_END);
+
+	PLUGIN_OPEN ("specload");
 
+	KeySet * ks = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+	compare_keyset (expected, ks);
+
+	ksDel (ks);
+	PLUGIN_CLOSE ();
+}
+
+static void test_cache (void)
+{
+	printf ("test cache\n");
+
+	char cacheDir[] = "/tmp/elektra-test-specload-XXXXXX";
+	exit_if_fail (mkdtemp (cacheDir) != NULL, "could not create cache directory");
+
+	Key * parentKey = keyNew (PARENT_KEY, KEY_VALUE, srcdir_file ("specload/basics.quickdump"), KEY_END);
+	KeySet * conf = ksNew (2, keyNew ("/app", KEY_VALUE, bindir_file (TESTAPP_NAME), KEY_END),
+			       keyNew ("/cache", KEY_VALUE, cacheDir, KEY_END), KS_END);
+
+	succeed_if (elektraSpecloadCheckConf (parentKey, conf) == ELEKTRA_PLUGIN_STATUS_NO_UPDATE, "call to checkConf was not successful");
+
+	PLUGIN_OPEN ("specload");
+
+	KeySet * ks = ksNew (0, KS_END);
+	KeySet * defaultSpec = DEFAULT_SPEC;
+
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+	compare_keyset (defaultSpec, ks);
+
+	// modifying the returned keys must not modify the in-memory cache
+	keySetMeta (ksLookupByName (ks, PARENT_KEY "/mykey", 0), "default", "8");
+	ksClear (ks);
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+	compare_keyset (defaultSpec, ks);
+
+	ksDel (defaultSpec);
+	ksDel (ks);
+	PLUGIN_CLOSE ();
+
+	char * cacheFile = findCacheFile (cacheDir);
+	exit_if_fail (cacheFile != NULL, "cache file was not created");
+
+	// replace cached spec, a new plugin instance must use it instead of calling the app
+	KeySet * quickDumpConf = ksNew (0, KS_END);
+	Key * invokeErrorKey = keyNew ("/", KEY_END);
+	ElektraInvokeHandle * quickDump = elektraInvokeOpen ("quickdump", quickDumpConf, invokeErrorKey);
+	KeySet * cachedSpec = ksNew (1, keyNew (PARENT_KEY "/cachedkey", KEY_META, "default", "cached", KEY_END), KS_END);
+	Key * quickDumpParent = keyNew (PARENT_KEY, KEY_VALUE, cacheFile, KEY_END);
+	succeed_if (elektraInvoke2Args (quickDump, "set", cachedSpec, quickDumpParent) == ELEKTRA_PLUGIN_STATUS_SUCCESS,
+		    "could not overwrite cache file");
+	keyDel (quickDumpParent);
+	elektraInvokeClose (quickDump, invokeErrorKey);
+	keyDel (invokeErrorKey);
+	ksDel (quickDumpConf);
+
+	test_cacheReuse (parentKey, cacheDir, cachedSpec);
+
+	ksDel (cachedSpec);
+	keyDel (parentKey);
+
+	remove (cacheFile);
+	elektraFree (cacheFile);
+	rmdir (cacheDir);
+}
 
 int main (int argc, char ** argv)
 {
@@ -315,6 +410,8 @@ int main (int argc, char ** argv)
 	test_newfile (true);
 	test_newfile (false);
 
+	test_cache ();
+
 	print_result ("testmod_specload");
 
 	return nbError;
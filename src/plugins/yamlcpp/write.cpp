@@ -12,16 +12,16 @@
 #include <kdb.hpp>
 #include <kdbease.h>
 #include <kdblogger.h>
+#include <kdbutility.h>
 
-#include <fstream>
+#include <cerrno>
 #include <stack>
+#include <system_error>
 
 namespace
 {
 
-using std::endl;
 using std::istringstream;
-using std::ofstream;
 using std::ostringstream;
 using std::stack;
 using std::string;
@@ -294,13 +294,19 @@ void yamlcpp::yamlWrite (KeySet const & mappings, Key const & parent)
 	Node data;
 	addKeys (data, keys, parent);
 
+	// Emit the whole document into memory, so that the file is written with a single system call
+	YAML::Emitter emitter;
+	emitter << data;
+	string output;
+	output.reserve (emitter.size () + 1);
+	output.append (emitter.c_str (), emitter.size ());
+	output += '\n';
+
 #ifdef HAVE_LOGGER
 	ELEKTRA_LOG_DEBUG ("Write Data:");
 	ELEKTRA_LOG_DEBUG ("——————————");
 
-	ostringstream outputString;
-	outputString << data;
-	istringstream stream (outputString.str ());
+	istringstream stream (output);
 	for (string line; std::getline (stream, line);)
 	{
 		ELEKTRA_LOG_DEBUG ("%s", line.c_str ());
@@ -309,6 +315,8 @@ void yamlcpp::yamlWrite (KeySet const & mappings, Key const & parent)
 	ELEKTRA_LOG_DEBUG ("——————————");
 #endif
 
-	ofstream output (parent.getString ());
-	output << data << endl;
+	if (ckdb::elektraWriteFile (parent.getString ().c_str (), output.data (), output.size ()) == -1)
+	{
+		throw std::system_error (errno, std::generic_category ());
+	}
 }
@@ -18,10 +18,13 @@
 #include <kdberrors.h>
 #include <kdblogger.h>
 
+#include <system_error>
+
 #include "yaml-cpp/yaml.h"
 
 using std::exception;
 using std::overflow_error;
+using std::system_error;
 
 using YAML::BadFile;
 using YAML::EmitterException;
@@ -139,6 +142,11 @@ int elektraYamlcppSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key *
 		ELEKTRA_SET_RESOURCE_ERRORF (parent.getKey (), "Unable to write to file '%s'. Reason: %s.", parent.getString ().c_str (),
 					     exception.what ());
 	}
+	catch (system_error const & exception)
+	{
+		ELEKTRA_SET_RESOURCE_ERRORF (parent.getKey (), "Unable to write to file '%s'. Reason: %s.", parent.getString ().c_str (),
+					     exception.what ());
+	}
 	catch (EmitterException const & exception)
 	{
 		ELEKTRA_SET_PLUGIN_MISBEHAVIOR_ERRORF (parent.getKey (),
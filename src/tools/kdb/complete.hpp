@@ -64,6 +64,7 @@ private:
 	bool shallShowNextLevel (std::string const & argument);
 
 	void addMountpoints (kdb::KeySet & ks, kdb::Key const & root, Cmdline const & cl);
+	static bool hasKeysBelow (kdb::KeySet const & ks, kdb::Key const & key);
 	void addNamespaces (std::map<kdb::Key, std::pair<int, int>> & hierarchy, Cmdline const & cl);
 	void increaseCount (std::map<kdb::Key, std::pair<int, int>> & hierarchy, kdb::Key const & key,
 			    std::function<int (int)> const & depthIncreaser);
@@ -2883,6 +2883,30 @@ static void test_ksAppend3 (void)
 	ksDel (ks);
 }
 
+static void test_ksFindBelow (void)
+{
+	printf ("Test ksFindBelow\n");
+
+	KeySet * ks = ksNew (5, keyNew ("system:/bar", KEY_END), keyNew ("system:/foo", KEY_END), keyNew ("system:/foo/bar", KEY_END),
+			     keyNew ("system:/foo/bar/baz", KEY_END), keyNew ("system:/zoo", KEY_END), KS_END);
+	Key * root = keyNew ("system:/foo", KEY_END);
+	elektraCursor end;
+
+	succeed_if (ksFindBelow (NULL, root, &end) == -1, "shouldn't accept NULL");
+	succeed_if (ksFindBelow (ks, NULL, &end) == -1, "shouldn't accept NULL");
+
+	succeed_if (ksFindBelow (ks, root, &end) == 1 && end == 4, "wrong range for system:/foo");
+
+	keySetName (root, "system:/foo/bar/baz");
+	succeed_if (ksFindBelow (ks, root, &end) == 3 && end == 4, "wrong range for system:/foo/bar/baz");
+
+	keySetName (root, "user:/foo");
+	succeed_if (ksFindBelow (ks, root, &end) == ksGetSize (ks) && end == ksGetSize (ks), "shouldn't find user:/foo");
+
+	keyDel (root);
+	ksDel (ks);
+}
+
 
 int main (int argc, char ** argv)
 {
@@ -2937,6 +2961,7 @@ int main (int argc, char ** argv)
 	test_ksAppend2 ();
 	test_ksAppend3 ();
 	test_ksOrderNs ();
+	test_ksFindBelow ();
 
 	printf ("\ntestabi_ks RESULTS: %d test(s) done. %d error(s).\n", nbTest, nbError);
 
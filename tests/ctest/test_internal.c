@@ -43,6 +43,50 @@ static void test_elektraMalloc (void)
 	elektraFree (dup);
 }
 
+static void test_elektraAllocStats (void)
+{
+	ElektraAllocStats stats;
+	int previous = elektraAllocAccounting (1);
+	if (previous < 0)
+	{
+		succeed_if (elektraAllocStatsGet (ELEKTRA_ALLOC_TOTAL, &stats) == -1, "stats without accounting");
+		succeed_if (stats.allocations == 0, "stats not cleared without accounting");
+		return;
+	}
+
+	elektraAllocStatsReset ();
+	char * buffer = elektraMallocTag (50, ELEKTRA_ALLOC_META);
+	succeed_if (elektraReallocTag ((void **) &buffer, 100, ELEKTRA_ALLOC_META) == 0, "could not reallocate");
+	Key * key = keyNew ("user:/tests/alloc", KEY_VALUE, "value", KEY_END);
+
+	succeed_if (elektraAllocStatsGet (ELEKTRA_ALLOC_META, &stats) == 0, "could not get stats");
+	succeed_if (stats.allocations == 2, "wrong number of allocations");
+	succeed_if (stats.bytes == 150, "wrong number of bytes");
+	succeed_if (stats.frees == 0, "wrong number of frees");
+	succeed_if (elektraAllocStatsGet (ELEKTRA_ALLOC_KEY, &stats) == 0, "could not get stats");
+	succeed_if (stats.allocations >= 3, "key, name and value must be counted");
+
+	elektraFreeTag (buffer, ELEKTRA_ALLOC_META);
+	succeed_if (elektraAllocStatsGet (ELEKTRA_ALLOC_META, &stats) == 0, "could not get stats");
+	succeed_if (stats.frees == 1, "wrong number of frees");
+	keyDel (key);
+
+	succeed_if (elektraAllocStatsGet (ELEKTRA_ALLOC_TOTAL, &stats) == 0, "could not get stats");
+	succeed_if (stats.allocations >= 5, "total must include all tags");
+	succeed_if (stats.peak >= stats.current, "peak below current");
+
+	elektraAllocAccounting (0);
+	elektraFree (elektraMalloc (10));
+	ElektraAllocStats after;
+	succeed_if (elektraAllocStatsGet (ELEKTRA_ALLOC_TOTAL, &after) == 0, "could not get stats");
+	succeed_if (after.allocations == stats.allocations, "allocation counted while disabled");
+
+	succeed_if (elektraAllocStatsGet (ELEKTRA_ALLOC_TOTAL + 1, &stats) == -1, "invalid tag accepted");
+	succeed_if_same_string (elektraAllocTagName (ELEKTRA_ALLOC_KEYSET), "keyset");
+	succeed_if (elektraAllocTagName (ELEKTRA_ALLOC_TOTAL + 1) == 0, "name of invalid tag");
+	elektraAllocAccounting (previous);
+}
+
 static void test_elektraStrLen (void)
 {
 	char charSeq[5];
@@ -288,6 +332,7 @@ int main (int argc, char ** argv)
 	init (argc, argv);
 
 	test_elektraMalloc ();
+	test_elektraAllocStats ();
 	test_elektraStrLen ();
 	test_elektraKeyNameValidate ();
 	test_elektraKeyNameEscapePart ();
@@ -390,6 +390,103 @@ static void test_ksRename (void)
 	keyDel (newRoot);
 }
 
+static int renameEachCallback (Key * key, void * data)
+{
+	elektraNamespace * ns = data;
+	if (strcmp (keyString (key), "remove") == 0)
+	{
+		return -1;
+	}
+
+	if (keyGetMeta (key, "rename") != NULL)
+	{
+		keySetNamespace (key, *ns);
+		return 1;
+	}
+
+	return 0;
+}
+
+static void test_ksRenameEach (void)
+{
+	printf ("Test ksRenameEach\n");
+
+	elektraNamespace ns = KEY_NS_DIR;
+	Key * referenced = keyNew ("system:/baz/bar", KEY_VALUE, "6", KEY_META, "rename", "", KEY_END);
+	keyIncRef (referenced);
+
+	KeySet * ks = ksNew (24,
+			     // clang-format off
+			     keyNew ("dir:/bar/bar", KEY_VALUE, "0", KEY_END),
+			     keyNew ("system:/bar", KEY_VALUE, "1", KEY_END),
+			     keyNew ("system:/bar/bar", KEY_VALUE, "2", KEY_META, "rename", "", KEY_END),
+			     keyNew ("system:/bar/bar/bar", KEY_VALUE, "3", KEY_END),
+			     keyNew ("system:/bar/bar/foo", KEY_VALUE, "remove", KEY_END),
+			     keyNew ("system:/baz", KEY_VALUE, "5", KEY_END),
+			     referenced,
+			     keyNew ("system:/baz/bar/bar", KEY_VALUE, "7", KEY_END),
+			     keyNew ("system:/baz/bar/foo", KEY_VALUE, "remove", KEY_END),
+			     keyNew ("system:/foo", KEY_VALUE, "remove", KEY_END),
+			     keyNew ("system:/foo/bar", KEY_VALUE, "10", KEY_META, "rename", "", KEY_END),
+			     // clang-format on
+			     KS_END);
+
+	succeed_if (ksRenameEach (NULL, 0, 0, renameEachCallback, &ns) == -1, "shouldn't accept NULL");
+	succeed_if (ksRenameEach (ks, 0, 0, NULL, &ns) == -1, "shouldn't accept NULL");
+	succeed_if (ksRenameEach (ks, 2, 1, renameEachCallback, &ns) == -1, "shouldn't accept invalid range");
+	succeed_if (ksRenameEach (ks, 0, ksGetSize (ks) + 1, renameEachCallback, &ns) == -1, "shouldn't accept invalid range");
+	succeed_if (ksRenameEach (ks, 3, 3, renameEachCallback, &ns) == 0, "empty range should change nothing");
+	succeed_if (ksGetSize (ks) == 11, "empty range should change nothing");
+
+	// only the keys below system:/baz
+	succeed_if (ksRenameEach (ks, 6, 9, renameEachCallback, &ns) == 2, "wrong number of changed keys");
+
+	KeySet * expected = ksNew (24,
+				   // clang-format off
+				   keyNew ("dir:/bar/bar", KEY_VALUE, "0", KEY_END),
+				   keyNew ("dir:/baz/bar", KEY_VALUE, "6", KEY_META, "rename", "", KEY_END),
+				   keyNew ("system:/bar", KEY_VALUE, "1", KEY_END),
+				   keyNew ("system:/bar/bar", KEY_VALUE, "2", KEY_META, "rename", "", KEY_END),
+				   keyNew ("system:/bar/bar/bar", KEY_VALUE, "3", KEY_END),
+				   keyNew ("system:/bar/bar/foo", KEY_VALUE, "remove", KEY_END),
+				   keyNew ("system:/baz", KEY_VALUE, "5", KEY_END),
+				   keyNew ("system:/baz/bar/bar", KEY_VALUE, "7", KEY_END),
+				   keyNew ("system:/foo", KEY_VALUE, "remove", KEY_END),
+				   keyNew ("system:/foo/bar", KEY_VALUE, "10", KEY_META, "rename", "", KEY_END),
+				   // clang-format on
+				   KS_END);
+	compare_keyset (ks, expected);
+	ksDel (expected);
+
+	succeed_if_same_string (keyName (referenced), "system:/baz/bar");
+	succeed_if (ksLookupByName (ks, "dir:/baz/bar", 0) != referenced, "referenced key should have been copied");
+	succeed_if (keyGetRef (referenced) == 1, "reference of copied key not released");
+	keyDecRef (referenced);
+	keyDel (referenced);
+
+	// renamed keys replace existing keys
+	succeed_if (ksRenameEach (ks, 0, ksGetSize (ks), renameEachCallback, &ns) == 5, "wrong number of changed keys");
+
+	expected = ksNew (24,
+			  // clang-format off
+			  keyNew ("dir:/bar/bar", KEY_VALUE, "2", KEY_META, "rename", "", KEY_END),
+			  keyNew ("dir:/baz/bar", KEY_VALUE, "6", KEY_META, "rename", "", KEY_END),
+			  keyNew ("dir:/foo/bar", KEY_VALUE, "10", KEY_META, "rename", "", KEY_END),
+			  keyNew ("system:/bar", KEY_VALUE, "1", KEY_END),
+			  keyNew ("system:/bar/bar/bar", KEY_VALUE, "3", KEY_END),
+			  keyNew ("system:/baz", KEY_VALUE, "5", KEY_END),
+			  keyNew ("system:/baz/bar/bar", KEY_VALUE, "7", KEY_END),
+			  // clang-format on
+			  KS_END);
+	compare_keyset (ks, expected);
+	ksDel (expected);
+
+	succeed_if (ksLookupByName (ks, "system:/bar/bar/bar", 0) != NULL, "lookup after rename failed");
+	succeed_if (ksLookupByName (ks, "dir:/foo/bar", 0) != NULL, "lookup after rename failed");
+
+	ksDel (ks);
+}
+
 void test_ksFindHierarchy (void)
 {
 	printf ("Test ksFindHierarchy\n");
@@ -445,6 +542,10 @@ void test_ksFindHierarchy (void)
 	keySetName (root, "system:/baz/bar/bar");
 	succeed_if (ksFindHierarchy (ks, root, NULL) == 6, "should accept NULL for end");
 
+	succeed_if (ksFindHierarchy (ks, ksAtCursor (ks, 5), &end) == 5 && end == 8, "should accept root that is part of ks");
+	succeed_if (ksFindHierarchy (ks, ksAtCursor (ks, 7), &end) == 7 && end == 8, "should accept root that is part of ks");
+	succeed_if_same_string (keyName (ksAtCursor (ks, 5)), "system:/baz/bar");
+
 	keyDel (root);
 	ksDel (ks);
 }
@@ -554,6 +655,149 @@ static void test_ksSearch (void)
 	ksDel (a);
 }
 
+static void check_children (KeySet * ks, const char * rootName, const elektraCursor * expected, size_t count)
+{
+	Key * root = keyNew (rootName, KEY_END);
+	size_t found = 0;
+
+	for (elektraCursor it = ksFindNextChild (ks, root, -1); it < ksGetSize (ks); it = ksFindNextChild (ks, root, it))
+	{
+		exit_if_fail (found < count, "too many children");
+		succeed_if (it == expected[found], "wrong position of child");
+		++found;
+	}
+	succeed_if (found == count, "too few children");
+
+	keyDel (root);
+}
+
+static void test_ksFindNextChild (void)
+{
+	printf ("Testing ksFindNextChild\n");
+
+	KeySet * a = set_a ();
+	Key * root = keyNew ("user:/", KEY_END);
+
+	succeed_if (ksFindNextChild (NULL, root, -1) == -1, "shouldn't accept NULL");
+	succeed_if (ksFindNextChild (a, NULL, -1) == -1, "shouldn't accept NULL");
+	succeed_if (ksFindNextChild (a, root, ksGetSize (a)) == ksGetSize (a), "should stop at the end");
+
+	check_children (a, "user:/", (elektraCursor[]){ 0, 1, 15 }, 3);
+	check_children (a, "user:/a", (elektraCursor[]){ 2, 5, 8, 9, 10 }, 5);
+	check_children (a, "user:/a/x", (elektraCursor[]){ 10, 11, 12 }, 3);
+	check_children (a, "user:/a/x/c", (elektraCursor[]){ 13, 14 }, 2);
+	check_children (a, "user:/a/x/c/a", NULL, 0);
+	check_children (a, "user:/b", NULL, 0);
+	check_children (a, "system:/", NULL, 0);
+	check_children (a, "/", NULL, 0);
+
+	// the implicit child user:/a/x starts with a key below it
+	succeed_if_same_string (keyName (ksAtCursor (a, 10)), "user:/a/x/a");
+
+	KeySet * b = ksNew (4, keyNew ("user:/a/b", KEY_END), keyNew ("user:/ab", KEY_END), keyNew ("user:/ab/c", KEY_END),
+			    keyNew ("user:/b", KEY_END), KS_END);
+	check_children (b, "user:/", (elektraCursor[]){ 0, 1, 3 }, 3);
+	check_children (b, "user:/a", (elektraCursor[]){ 0 }, 1);
+
+	keyDel (root);
+	ksDel (b);
+	ksDel (a);
+}
+
+static void clearSync (KeySet * ks)
+{
+	for (elektraCursor it = 0; it < ksGetSize (ks); ++it)
+	{
+		keyClearSync (ksAtCursor (ks, it));
+	}
+}
+
+static void test_trackChanges (void)
+{
+	printf ("Test tracking changes\n");
+
+	Key * dirty = keyNew ("user:/tests/dirty", KEY_END);
+	KeySet * ks = ksNew (5, keyNew ("user:/tests/a", KEY_END), keyNew ("user:/tests/b", KEY_END), keyNew ("user:/tests/c", KEY_END),
+			     keyNew ("user:/tests/d", KEY_END), dirty, KS_END);
+	clearSync (ks);
+	keySetString (dirty, "changed before");
+
+	succeed_if (elektraKsTrackChanges (NULL) == -1, "shouldn't accept NULL");
+	succeed_if (elektraKsTrackChanges (ks) == 1, "should track changes");
+	succeed_if (elektraKsTrackChanges (ks) == 1, "should still track changes");
+	succeed_if (ksGetSize (ks->changes) == 1, "changes before tracking should be logged");
+	succeed_if (ksLookup (ks->changes, dirty, 0) != 0, "wrong key logged");
+	succeed_if (dirty->owner == ks, "key should be owned");
+
+	// changes of values, metadata and inserted keys are logged once
+	keySetString (ksLookupByName (ks, "user:/tests/a", 0), "changed");
+	keySetString (ksLookupByName (ks, "user:/tests/a", 0), "changed again");
+	keySetMeta (ksLookupByName (ks, "user:/tests/b", 0), "meta", "changed");
+	ksAppendKey (ks, keyNew ("user:/tests/new", KEY_END));
+	Key * clean = keyNew ("user:/tests/clean", KEY_END);
+	keyClearSync (clean);
+	ksAppendKey (ks, clean);
+	succeed_if (ksGetSize (ks->changes) == 4, "wrong number of changes");
+	succeed_if (ksLookupByName (ks->changes, "user:/tests/a", 0) != 0, "value change not logged");
+	succeed_if (ksLookupByName (ks->changes, "user:/tests/b", 0) != 0, "meta change not logged");
+	succeed_if (ksLookupByName (ks->changes, "user:/tests/new", 0) != 0, "new key not logged");
+	succeed_if (ksLookupByName (ks->changes, "user:/tests/clean", 0) == 0, "clean key should not be logged");
+	succeed_if (clean->owner == ks, "inserted key should be owned");
+
+	// clearing the changes is like keyClearSync() on every key
+	elektraKsClearChanges (ks);
+	succeed_if (ksGetSize (ks->changes) == 0, "changes should be cleared");
+	for (elektraCursor it = 0; it < ksGetSize (ks); ++it)
+	{
+		succeed_if_fmt (keyNeedSync (ksAtCursor (ks, it)) == 0, "key %s still needs sync", keyName (ksAtCursor (ks, it)));
+	}
+
+	// renamed keys are logged with their new name
+	Key * root = keyNew ("user:/tests/new", KEY_END);
+	Key * newRoot = keyNew ("user:/tests/renamed", KEY_END);
+	succeed_if (ksRename (ks, root, newRoot) == 1, "should rename one key");
+	succeed_if (ksLookup (ks->changes, newRoot, 0) != 0, "renamed key not logged");
+	keyDel (root);
+	keyDel (newRoot);
+
+	// removed keys are not owned anymore
+	Key * popped = ksLookupByName (ks, "user:/tests/clean", KDB_O_POP);
+	succeed_if (popped->owner == 0, "popped key should not be owned");
+	keyDel (popped);
+
+	Key * held = ksLookupByName (ks, "user:/tests/d", 0);
+	keyIncRef (held);
+	Key * cutpoint = keyNew ("user:/tests/d", KEY_END);
+	KeySet * cut = ksCut (ks, cutpoint);
+	succeed_if (held->owner == 0, "cut key should not be owned");
+	keyDel (cutpoint);
+	ksDel (cut);
+
+	// a key tracked by another keyset stops tracking
+	KeySet * other = ksDup (ks);
+	succeed_if (elektraKsTrackChanges (other) == 0, "keys are already tracked by ks");
+	succeed_if (other->changes == 0, "other should not track changes");
+	ksAppendKey (other, keyNew ("user:/tests/other", KEY_END));
+	succeed_if (elektraKsTrackChanges (other) == 0, "keys are already tracked by ks");
+
+	KeySet * third = ksNew (0, KS_END);
+	succeed_if (elektraKsTrackChanges (third) == 1, "empty keyset can be tracked");
+	ksAppend (third, other);
+	succeed_if (third->changes == 0, "tracking should stop for keys of ks");
+	ksDel (third);
+	ksDel (other);
+
+	// keys outliving the keyset are not owned anymore
+	keyIncRef (dirty);
+	ksDel (ks);
+	succeed_if (dirty->owner == 0, "key should not be owned after ksDel");
+	keySetString (dirty, "changed after ksDel");
+	keyDecRef (dirty);
+	keyDel (dirty);
+	keyDecRef (held);
+	keyDel (held);
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("KS         TESTS\n");
@@ -567,8 +811,11 @@ int main (int argc, char ** argv)
 	test_creatingLookup ();
 	test_ksNoAlloc ();
 	test_ksRename ();
+	test_ksRenameEach ();
 	test_ksFindHierarchy ();
 	test_ksSearch ();
+	test_ksFindNextChild ();
+	test_trackChanges ();
 
 	printf ("\ntest_ks RESULTS: %d test(s) done. %d error(s).\n", nbTest, nbError);
 
@@ -309,6 +309,133 @@ static void test_top (void)
 	ksDel (testCycleOrder3);
 	elektraFree (array);
 }
+
+static void test_sharedMeta (void)
+{
+	printf ("test shared meta\n");
+
+	Key * key = keyNew ("user:/key", KEY_META, "type", "long", KEY_META, "default", "5", KEY_END);
+	Key * dup = keyDup (key, KEY_CP_ALL);
+	succeed_if (key->meta == dup->meta, "keyDup should share the metadata");
+	succeed_if (key->meta->refs == 2, "shared metadata should be referenced by both keys");
+
+	keySetMeta (dup, "check/range", "0-10");
+	succeed_if (key->meta != dup->meta, "keySetMeta should copy shared metadata");
+	succeed_if (key->meta->refs == 1 && dup->meta->refs == 1, "metadata should not be shared anymore");
+	succeed_if (keyGetMeta (key, "check/range") == NULL, "keySetMeta changed metadata of other key");
+	succeed_if (keyGetMeta (key, "type") == keyGetMeta (dup, "type"), "metakeys should still be shared");
+
+	Key * copy = keyNew ("user:/copy", KEY_END);
+	succeed_if (keyCopyAllMeta (copy, key) == 1, "could not copy metadata");
+	succeed_if (copy->meta == key->meta, "keyCopyAllMeta should share the metadata of keys without metadata");
+
+	// keys sharing metadata can be iterated at the same time
+	keyRewindMeta (key);
+	keyRewindMeta (copy);
+	const Key * meta;
+	size_t count = 0;
+	while ((meta = keyNextMeta (key)) != NULL)
+	{
+		succeed_if (keyNextMeta (copy) == meta, "iterating metadata of other key should not interfere");
+		++count;
+	}
+	succeed_if (count == 2, "wrong number of metakeys");
+
+	succeed_if (keyCopyAllMeta (copy, key) == 1, "could not copy metadata");
+	KeySet * metaKs = keyMeta (copy);
+	succeed_if (metaKs != key->meta, "keyMeta should copy shared metadata");
+	ksAppendKey (metaKs, keyNew ("meta:/order", KEY_VALUE, "1", KEY_END));
+	succeed_if (keyGetMeta (key, "order") == NULL, "modifying keyMeta changed metadata of other key");
+
+	succeed_if (keyCopyAllMeta (copy, dup) == 1, "could not copy metadata");
+	succeed_if (copy->meta != dup->meta, "keyCopyAllMeta should not share the metadata of keys with metadata");
+	succeed_if_same_string (keyString (keyGetMeta (copy, "order")), "1");
+	succeed_if_same_string (keyString (keyGetMeta (copy, "check/range")), "0-10");
+
+	keyDel (key);
+	succeed_if_same_string (keyString (keyGetMeta (dup, "type")), "long");
+
+	Key * cleared = keyDup (dup, KEY_CP_ALL);
+	keyCopy (cleared, NULL, KEY_CP_META);
+	succeed_if (keyGetMeta (cleared, "type") == NULL, "metadata not cleared");
+	succeed_if_same_string (keyString (keyGetMeta (dup, "type")), "long");
+	succeed_if (dup->meta->refs == 1, "cleared key still references metadata");
+
+	keyDel (cleared);
+	keyDel (copy);
+	keyDel (dup);
+}
+
+static void test_exportedMeta (void)
+{
+	printf ("test exported meta\n");
+
+	Key * key = keyNew ("user:/key", KEY_META, "type", "long", KEY_END);
+	KeySet * metaKs = keyMeta (key);
+
+	Key * dup = keyDup (key, KEY_CP_ALL);
+	succeed_if (dup->meta != key->meta, "keyDup must not share metadata returned by keyMeta");
+	Key * copy = keyNew ("user:/copy", KEY_END);
+	succeed_if (keyCopyAllMeta (copy, key) == 1, "could not copy metadata");
+	succeed_if (copy->meta != key->meta, "keyCopyAllMeta must not share metadata returned by keyMeta");
+
+	ksAppendKey (metaKs, keyNew ("meta:/order", KEY_VALUE, "1", KEY_END));
+	succeed_if_same_string (keyString (keyGetMeta (key, "order")), "1");
+	succeed_if (keyGetMeta (dup, "order") == NULL, "modifying keyMeta changed metadata of keyDup");
+	succeed_if (keyGetMeta (copy, "order") == NULL, "modifying keyMeta changed metadata of keyCopyAllMeta");
+	succeed_if_same_string (keyString (keyGetMeta (copy, "type")), "long");
+
+	// copies of a private copy can be shared again
+	Key * dup2 = keyDup (dup, KEY_CP_ALL);
+	succeed_if (dup2->meta == dup->meta, "metadata of keyDup should be shared");
+
+	// lookups must not move the cursor every sharing key sees
+	elektraCursor cursor = ksGetCursor (dup->meta);
+	succeed_if_same_string (keyString (keyGetMeta (dup2, "type")), "long");
+	succeed_if (keySetMeta (dup2, "missing", NULL) == 0, "removing missing metadata failed");
+	succeed_if (dup2->meta == dup->meta, "removing missing metadata should not copy the metadata");
+	succeed_if (ksGetCursor (dup->meta) == cursor, "keyGetMeta moved the cursor of shared metadata");
+
+	keyDel (dup2);
+	keyDel (copy);
+	keyDel (dup);
+	keyDel (key);
+}
+
+static void test_sharedMetaLimit (void)
+{
+	printf ("test shared meta limit\n");
+
+	Key * key = keyNew ("user:/key", KEY_META, "type", "long", KEY_END);
+	// every copy beyond the limit needs its own metadata keys
+	const size_t count = 2 * UINT16_MAX + 10;
+	Key ** dups = elektraMalloc (count * sizeof (Key *));
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		dups[i] = keyDup (key, KEY_CP_ALL);
+	}
+	succeed_if (dups[0]->meta == key->meta, "metadata should be shared");
+	succeed_if (dups[count - 1]->meta != key->meta, "metadata must not be shared beyond the reference counter");
+	succeed_if_same_string (keyString (keyGetMeta (dups[count - 1], "type")), "long");
+
+	keyDel (key);
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (strcmp (keyString (keyGetMeta (dups[i], "type")), "long") != 0)
+		{
+			yield_error ("wrong metadata");
+			break;
+		}
+	}
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		keyDel (dups[i]);
+	}
+	elektraFree (dups);
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("KEY META     TESTS\n");
@@ -321,6 +448,9 @@ int main (int argc, char ** argv)
 
 	test_metaArrayToKS ();
 	test_top ();
+	test_sharedMeta ();
+	test_exportedMeta ();
+	test_sharedMetaLimit ();
 	printf ("\ntest_meta RESULTS: %d test(s) done. %d error(s).\n", nbTest, nbError);
 
 	return nbError;
@@ -1283,6 +1283,165 @@ static void test_state (void)
 }
 
 
+// keys before, between and after the nested mountpoints of set_realworld()
+static KeySet * set_ranges (void)
+{
+	KeySet * ks = ksNew (0, KS_END);
+	const char * prefixes[] = { "user:/sw",
+				    "user:/sw/apps",
+				    "user:/sw/apps/app1",
+				    "user:/sw/apps/app1/default",
+				    "user:/sw/apps/app1/default/x",
+				    "user:/sw/apps/app1/defaultx",
+				    "user:/sw/apps/app2",
+				    "user:/sw/apps/app2/y",
+				    "user:/sw/apps/app3",
+				    "user:/sw/kde/default",
+				    "user:/sw/zzz",
+				    "system:/elektra/mountpoints",
+				    "system:/elektraa",
+				    "system:/groups",
+				    "system:/hosts/a",
+				    "system:/users/x",
+				    "system:/userz",
+				    "dir:/d",
+				    "spec:/s",
+				    "proc:/p",
+				    "proc:/q",
+				    "default:/d",
+				    "/cascading" };
+	for (size_t i = 0; i < sizeof (prefixes) / sizeof (prefixes[0]); ++i)
+	{
+		for (int j = 0; j < 3; ++j)
+		{
+			char name[128];
+			snprintf (name, sizeof (name), "%s/k%d", prefixes[i], j);
+			ksAppendKey (ks, keyNew (name, KEY_END));
+		}
+		ksAppendKey (ks, keyNew (prefixes[i], KEY_END));
+	}
+	return ks;
+}
+
+static void test_divideRanges (void)
+{
+	printf ("Test divide into ranges\n");
+
+	KDB * handle = kdb_open ();
+
+	succeed_if (mountOpen (handle, set_realworld (), handle->modules, 0) == 0, "could not open mountpoints");
+	succeed_if (mountDefault (handle, handle->modules, 1, 0) == 0, "could not open default backend");
+
+	KeySet * ks = set_ranges ();
+
+	Split * split = splitNew ();
+	succeed_if (splitBuildup (split, handle, 0) == 1, "should need sync");
+	succeed_if (splitDivide (split, handle, ks) == 1, "should need sync");
+
+	// every key must end up where a lookup of its backend puts it
+	ssize_t divided = 0;
+	for (size_t i = 0; i < split->size; ++i)
+	{
+		divided += ksGetSize (split->keysets[i]);
+	}
+
+	ssize_t expected = 0;
+	for (elektraCursor it = 0; it < ksGetSize (ks); ++it)
+	{
+		Key * cur = ksAtCursor (ks, it);
+		ssize_t found = splitSearchBackend (split, mountGetBackend (handle, keyName (cur)), cur);
+		if (found == -1) continue;
+		++expected;
+		succeed_if_fmt (ksLookup (split->keysets[found], cur, 0) == cur, "key %s not in split %zd", keyName (cur), found);
+	}
+	succeed_if (divided == expected, "keys were divided more than once");
+	succeed_if (expected < ksGetSize (ks), "keys of proc:/, default:/ and cascading keys should be skipped");
+
+	splitDel (split);
+	ksDel (ks);
+	kdb_close (handle);
+}
+
+static void test_divideChanged (void)
+{
+	printf ("Test divide only changed backends\n");
+
+	KDB * handle = kdb_open ();
+
+	succeed_if (mountOpen (handle, set_realworld (), handle->modules, 0) == 0, "could not open mountpoints");
+	succeed_if (mountDefault (handle, handle->modules, 1, 0) == 0, "could not open default backend");
+
+	KeySet * ks = set_ranges ();
+
+	// like kdbGet(): the backends know their sizes and the keys are synced
+	Split * split = splitNew ();
+	succeed_if (splitBuildup (split, handle, 0) == 1, "should need sync");
+	succeed_if (splitDivide (split, handle, ks) == 1, "should need sync");
+	simulateGet (split);
+	succeed_if (splitUpdateSize (split) == 1, "could not update sizes");
+	splitDel (split);
+	for (elektraCursor it = 0; it < ksGetSize (ks); ++it)
+	{
+		keyClearSync (ksAtCursor (ks, it));
+	}
+	succeed_if (elektraKsTrackChanges (ks) == 1, "should track changes");
+	succeed_if (ksGetSize (ks->changes) == 0, "nothing changed yet");
+
+	split = splitNew ();
+	succeed_if (splitBuildup (split, handle, 0) == 1, "should need sync");
+	succeed_if (splitDivideChanged (split, handle, ks) == 0, "nothing changed");
+	succeed_if (split->size == 0, "unchanged backends should be removed");
+	splitDel (split);
+
+	// change one key, only its backend is divided
+	Key * changed = ksLookupByName (ks, "user:/sw/apps/app2/y/k1", 0);
+	keySetString (changed, "changed");
+	succeed_if (ksGetSize (ks->changes) == 1, "change should be logged");
+
+	split = splitNew ();
+	succeed_if (splitBuildup (split, handle, 0) == 1, "should need sync");
+	succeed_if (splitDivideChanged (split, handle, ks) == 1, "should need sync");
+	succeed_if (split->size == 1, "only the changed backend should be left");
+	succeed_if (split->syncbits[0] & SPLIT_FLAG_SYNC, "changed backend should need sync");
+	succeed_if (ksLookup (split->keysets[0], changed, 0) == changed, "changed key not divided");
+	succeed_if (split->handles[0] == mountGetBackend (handle, keyName (changed)), "wrong backend");
+	succeed_if (splitSync (split) == 0, "size of the backend did not change");
+
+	// the backend must get all of its keys, like with splitDivide()
+	Split * full = splitNew ();
+	succeed_if (splitBuildup (full, handle, 0) == 1, "should need sync");
+	succeed_if (splitDivide (full, handle, ks) == 1, "should need sync");
+	ssize_t found = splitSearchBackend (full, split->handles[0], changed);
+	succeed_if (found != -1, "backend not found");
+	if (found != -1) compare_keyset (split->keysets[0], full->keysets[found]);
+	splitDel (full);
+	splitDel (split);
+
+	// a removed key changes the size of its backend
+	Key * removed = ksLookupByName (ks, "system:/hosts/a/k0", KDB_O_POP);
+	succeed_if (removed != 0, "key not found");
+	succeed_if (removed->owner == 0, "removed key should not be tracked anymore");
+	keyDel (removed);
+
+	split = splitNew ();
+	succeed_if (splitBuildup (split, handle, 0) == 1, "should need sync");
+	succeed_if (splitDivideChanged (split, handle, ks) == 1, "should need sync");
+	succeed_if (split->size == 2, "the backend with the removed key should be left");
+	succeed_if (splitSync (split) == 1, "should need sync");
+	for (size_t i = 0; i < split->size; ++i)
+	{
+		succeed_if (split->syncbits[i] & SPLIT_FLAG_SYNC, "both backends should need sync");
+	}
+	splitDel (split);
+
+	elektraKsClearChanges (ks);
+	succeed_if (ksGetSize (ks->changes) == 0, "changes should be cleared");
+	succeed_if (keyNeedSync (changed) == 0, "sync flag should be cleared");
+
+	ksDel (ks);
+	kdb_close (handle);
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("SPLIT SET   TESTS\n");
@@ -1302,6 +1461,8 @@ int main (int argc, char ** argv)
 	test_emptysplit ();
 	test_nothingsync ();
 	test_state ();
+	test_divideRanges ();
+	test_divideChanged ();
 
 	printf ("\ntest_splitset RESULTS: %d test(s) done. %d error(s).\n", nbTest, nbError);
 
@@ -10,6 +10,9 @@
 
 #include "tests.h"
 
+#include <stdio.h>
+#include <unistd.h>
+
 #define MAX_LENGTH 100
 
 static void test_elektraLskip (void)
@@ -86,6 +89,72 @@ static void test_elektraStrip (void)
 	succeed_if_same_string (elektraStrip (text), "Leading And Trailing Whitespace\n\tSecond Line");
 }
 
+static void test_elektraCopyFileRange (void)
+{
+	printf ("Test elektraCopyFileRange\n");
+
+	char data[100000];
+	for (size_t i = 0; i < sizeof (data); ++i)
+	{
+		data[i] = (char) (i * 7);
+	}
+
+	FILE * in = tmpfile ();
+	FILE * out = tmpfile ();
+	exit_if_fail (in != NULL && out != NULL, "could not create temporary files");
+	succeed_if (fwrite (data, 1, sizeof (data), in) == sizeof (data), "could not write data");
+	fflush (in);
+	succeed_if (fwrite ("head", 1, 4, out) == 4, "could not write data");
+	fflush (out);
+
+	succeed_if (elektraCopyFileRange (fileno (in), 10, fileno (out), 4, sizeof (data) - 10) == 0, "copy failed");
+	succeed_if (elektraCopyFileRange (fileno (in), 0, fileno (out), sizeof (data) - 6, 0) == 0, "empty copy failed");
+	succeed_if (lseek (fileno (in), 0, SEEK_CUR) == (off_t) sizeof (data), "offset of input changed");
+
+	char result[sizeof (data) + 4];
+	succeed_if (pread (fileno (out), result, sizeof (result), 0) == (ssize_t) sizeof (data) - 6, "wrong size of copy");
+	succeed_if (memcmp (result, "head", 4) == 0, "overwrote existing data");
+	succeed_if (memcmp (result + 4, data + 10, sizeof (data) - 10) == 0, "wrong data copied");
+
+	succeed_if (elektraCopyFileRange (fileno (in), sizeof (data) - 10, fileno (out), 0, 20) == -1, "copy beyond end should fail");
+
+	fclose (in);
+	fclose (out);
+}
+static void test_elektraOutputBuffer (void)
+{
+	printf ("Test elektraOutputBuffer\n");
+
+	KeySet * ks = ksNew (2, keyNew ("user:/tests/utility", KEY_VALUE, "value", KEY_END), keyNew ("user:/tests/utility/a", KEY_END), KS_END);
+	succeed_if (elektraOutputBufferEstimate (ks) >= sizeof ("user:/tests/utility") + sizeof ("value") + sizeof ("user:/tests/utility/a"),
+		    "estimate too small");
+	ksDel (ks);
+
+	ElektraOutputBuffer buffer;
+	elektraOutputBufferInit (&buffer, 0);
+	for (int i = 0; i < 100; ++i)
+	{
+		elektraOutputBufferAppendString (&buffer, "abc");
+		elektraOutputBufferAppend (&buffer, "de\0f", 4);
+		elektraOutputBufferAppendChar (&buffer, '\n');
+	}
+	succeed_if (!buffer.failed, "append failed");
+	succeed_if (buffer.size == 800, "wrong size");
+	succeed_if (memcmp (buffer.data + 792, "abcde\0f\n", 8) == 0, "wrong content");
+
+	const char * fileName = elektraFilename ();
+	succeed_if (elektraOutputBufferWrite (&buffer, fileName) == 0, "write failed");
+	FILE * file = fopen (fileName, "rb");
+	exit_if_fail (file != NULL, "file not written");
+	char content[1000];
+	succeed_if (fread (content, 1, sizeof (content), file) == 800, "wrong file size");
+	succeed_if (memcmp (content, buffer.data, 800) == 0, "wrong file content");
+	fclose (file);
+	unlink (fileName);
+
+	elektraOutputBufferFree (&buffer);
+	succeed_if (buffer.data == NULL && buffer.size == 0, "buffer not freed");
+}
 
 int main (int argc, char ** argv)
 {
@@ -97,6 +166,8 @@ int main (int argc, char ** argv)
 	test_elektraLskip ();
 	test_elektraRstrip ();
 	test_elektraStrip ();
+	test_elektraCopyFileRange ();
+	test_elektraOutputBuffer ();
 
 	printf ("\nResults: %d Test%s done — %d Error%s.\n", nbTest, nbTest == 1 ? "" : "s", nbError, nbError == 1 ? "" : "s");
 